@@ -0,0 +1,305 @@
+/**
+ * @file decimal_parser.cpp
+ * @brief Locale independent conversion of decimal numbers read from and written to files.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <limits.h>
+
+#include <decimal_parser.h>
+
+
+// Powers of ten which are exact in a double
+static const double exactPowersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define MAX_EXACT_POWER_OF_10   22
+
+// Any integer up to 15 decimal digits is exact in a double (2^53 > 10^15)
+#define MAX_EXACT_DIGITS        15
+
+
+static inline bool isDigit( char cc )
+{
+    return cc >= '0' && cc <= '9';
+}
+
+
+/* Reads the optional sign at *aText, and moves aText after it
+ */
+static inline bool readSign( const char*& aText, const char* aEnd )
+{
+    bool negative = false;
+
+    if( aText < aEnd && ( *aText == '-' || *aText == '+' ) )
+    {
+        negative = *aText == '-';
+        ++aText;
+    }
+
+    return negative;
+}
+
+
+bool ParseDecimalInt( const char* aStart, const char* aEnd, int* aResult )
+{
+    const char* cp = aStart;
+    bool        negative = readSign( cp, aEnd );
+
+    if( cp >= aEnd )
+        return false;
+
+    long long value = 0;
+
+    for( ; cp < aEnd; ++cp )
+    {
+        if( !isDigit( *cp ) )
+            return false;
+
+        value = value * 10 + ( *cp - '0' );
+
+        if( value > (long long) INT_MAX + 1 )
+            return false;
+    }
+
+    if( negative )
+        value = -value;
+
+    if( value > INT_MAX || value < INT_MIN )
+        return false;
+
+    *aResult = (int) value;
+    return true;
+}
+
+
+bool ParseDecimalDouble( const char* aStart, const char* aEnd, double* aResult )
+{
+    const char* cp = aStart;
+    bool        negative = readSign( cp, aEnd );
+
+    long long   mantissa = 0;
+    int         digits   = 0;       // significant digits in mantissa
+    int         exponent = 0;       // decimal exponent of the mantissa
+    bool        sawDigit = false;
+
+    for( ; cp < aEnd && isDigit( *cp ); ++cp )
+    {
+        sawDigit = true;
+
+        if( digits == 0 && *cp == '0' )
+            continue;
+
+        if( ++digits > MAX_EXACT_DIGITS )
+            return false;
+
+        mantissa = mantissa * 10 + ( *cp - '0' );
+    }
+
+    if( cp < aEnd && *cp == '.' )
+    {
+        for( ++cp; cp < aEnd && isDigit( *cp ); ++cp )
+        {
+            sawDigit = true;
+            --exponent;
+
+            if( digits == 0 && *cp == '0' )
+                continue;
+
+            if( ++digits > MAX_EXACT_DIGITS )
+            {
+                // Trailing zeros do not change the value
+                if( *cp != '0' )
+                    return false;
+
+                --digits;
+                ++exponent;
+                continue;
+            }
+
+            mantissa = mantissa * 10 + ( *cp - '0' );
+        }
+    }
+
+    if( !sawDigit )
+        return false;
+
+    if( cp < aEnd && ( *cp == 'e' || *cp == 'E' ) )
+    {
+        ++cp;
+
+        bool negativeExponent = readSign( cp, aEnd );
+        int  value = 0;
+
+        if( cp >= aEnd )
+            return false;
+
+        for( ; cp < aEnd && isDigit( *cp ); ++cp )
+        {
+            value = value * 10 + ( *cp - '0' );
+
+            if( value > 1000 )
+                return false;
+        }
+
+        exponent += negativeExponent ? -value : value;
+    }
+
+    if( cp != aEnd )
+        return false;
+
+    double result = (double) mantissa;
+
+    if( mantissa != 0 )
+    {
+        if( exponent < -MAX_EXACT_POWER_OF_10 || exponent > MAX_EXACT_POWER_OF_10 )
+            return false;
+
+        // Both operands are exact: the result is correctly rounded, as with strtod()
+        if( exponent < 0 )
+            result /= exactPowersOf10[-exponent];
+        else
+            result *= exactPowersOf10[exponent];
+    }
+
+    *aResult = negative ? -result : result;
+    return true;
+}
+
+
+bool ParseMillimetresToNanometres( const char* aStart, const char* aEnd, int* aResult )
+{
+    const char* cp = aStart;
+    bool        negative = readSign( cp, aEnd );
+    bool        sawDigit = false;
+
+    long long   millimetres = 0;
+
+    for( ; cp < aEnd && isDigit( *cp ); ++cp )
+    {
+        sawDigit = true;
+        millimetres = millimetres * 10 + ( *cp - '0' );
+
+        // Far beyond INT_MAX nanometres, and no overflow below
+        if( millimetres > 10000000 )
+            return false;
+    }
+
+    long long   nanometres = 0;
+    int         fractionDigits = 0;
+    bool        roundUp = false;
+
+    if( cp < aEnd && *cp == '.' )
+    {
+        for( ++cp; cp < aEnd && isDigit( *cp ); ++cp )
+        {
+            sawDigit = true;
+
+            if( fractionDigits < 6 )
+                nanometres = nanometres * 10 + ( *cp - '0' );
+            else if( fractionDigits == 6 )
+                roundUp = *cp >= '5';   // the following digits cannot change the rounding
+
+            ++fractionDigits;
+        }
+    }
+
+    if( !sawDigit || cp != aEnd )
+        return false;
+
+    for( ; fractionDigits < 6; ++fractionDigits )
+        nanometres *= 10;
+
+    long long value = millimetres * 1000000 + nanometres + ( roundUp ? 1 : 0 );
+
+    if( negative )
+        value = -value;
+
+    if( value > INT_MAX || value < INT_MIN )
+        return false;
+
+    *aResult = (int) value;
+    return true;
+}
+
+
+int FormatNanometresAsMillimetres( int aValue, char* aBuffer )
+{
+    char*    cp = aBuffer;
+    unsigned value = (unsigned) aValue;
+
+    if( aValue < 0 )
+    {
+        *cp++ = '-';
+        value = 0u - value;     // also right for INT_MIN
+    }
+
+    unsigned millimetres = value / 1000000;
+    unsigned nanometres  = value % 1000000;
+
+    // Integer part, written backwards then reversed
+    char* first = cp;
+
+    do
+    {
+        *cp++ = '0' + millimetres % 10;
+        millimetres /= 10;
+    } while( millimetres );
+
+    for( char* last = cp - 1; first < last; ++first, --last )
+    {
+        char cc = *first;
+        *first = *last;
+        *last = cc;
+    }
+
+    if( nanometres )
+    {
+        int digits = 6;
+
+        while( nanometres % 10 == 0 )
+        {
+            nanometres /= 10;
+            --digits;
+        }
+
+        *cp++ = '.';
+
+        for( int ii = digits - 1; ii >= 0; --ii )
+        {
+            cp[ii] = '0' + nanometres % 10;
+            nanometres /= 10;
+        }
+
+        cp += digits;
+    }
+
+    *cp = '\0';
+
+    return cp - aBuffer;
+}
@@ -53,6 +53,7 @@ void DHEAD::DeleteAll()
     first = 0;
     last  = 0;
     count = 0;
+    ++changeCount;
 }
 
 
@@ -82,6 +83,7 @@ void DHEAD::append( EDA_ITEM* aNewElement )
     aNewElement->SetList( this );
 
     ++count;
+    ++changeCount;
 }
 
 
@@ -112,6 +114,9 @@ void DHEAD::append( DHEAD& aList )
         aList.count = 0;
         aList.first = NULL;
         aList.last  = NULL;
+
+        ++changeCount;
+        ++aList.changeCount;
     }
 }
 
@@ -153,6 +158,7 @@ void DHEAD::insert( EDA_ITEM* aNewElement, EDA_ITEM* aAfterMe )
         aNewElement->SetList( this );
 
         ++count;
+        ++changeCount;
     }
 }
 
@@ -187,6 +193,7 @@ void DHEAD::remove( EDA_ITEM* aElement )
     aElement->SetList( 0 );
 
     --count;
+    ++changeCount;
 }
 
 #if defined(DEBUG)
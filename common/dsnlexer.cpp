@@ -644,7 +644,15 @@ L_read:
                 }
 
                 else
-                    curText += *head++;
+                {
+                    // copy the plain characters up to the next escape or quote at once
+                    const char* run = head;
+
+                    while( ++head < limit && *head != '\\' && *head != '"' )
+                        ;
+
+                    curText.append( run, head );
+                }
 
             }   // while
 
@@ -724,11 +732,11 @@ L_read:
     }           // specctraMode
 
     // non-quoted token, read it into curText.
-    curText.clear();
-
     head = cur;
     while( head<limit && !isSep( *head ) )
-        curText += *head++;
+        ++head;
+
+    curText.assign( cur, head );
 
     if( isNumber( curText.c_str(), curText.c_str() + curText.size() ) )
     {
@@ -45,7 +45,9 @@
 #include <fp_lib_table.h>
 #include <fpid.h>
 #include <class_module.h>
+#include <algorithm>
 #include <boost/thread.hpp>
+#include <wx/progdlg.h>
 
 
 /*
@@ -99,39 +101,42 @@ void FOOTPRINT_INFO::load()
 
     wxASSERT( fptable );
 
-    std::auto_ptr<MODULE> m( fptable->FootprintLoad( m_nickname, m_fpname ) );
-
-    m_pad_count = m->GetPadCount( MODULE::DO_NOT_INCLUDE_NPTH );
-    m_keywords  = m->GetKeywords();
-    m_doc       = m->GetDescription();
+    // The library plugin may have the header without loading the footprint.
+    fptable->FootprintLoadHeader( m_nickname, m_fpname, &m_header );
 
     // tell ensure_loaded() I'm loaded.
     m_loaded = true;
 }
 
 
-#define JOBZ                6       // no. libraries per worker thread.  It takes about
-                                    // a second to load a GITHUB library, so assigning
-                                    // this no. libraries to each thread should give a little
-                                    // over this no. seconds total time if the original delay
-                                    // were caused by latencies alone.
+#define MIN_WORKERS         6       // min. no. worker threads.  It takes about a second
+                                    // to load a GITHUB library, mostly waiting for the
+                                    // server, so more threads than cores still help there.
                                     // (If https://github.com does not mind.)
 
-#define NTOLERABLE_ERRORS   4       // max errors before aborting, although threads
-                                    // in progress will still pile on for a bit.  e.g. if 9 threads
-                                    // expect 9 greater than this.
+#define PROGRESS_INTERVAL   100     // ms between updates of the progress dialog
+
 
-void FOOTPRINT_LIST::loader_job( const wxString* aNicknameList, int aJobZ )
+bool FOOTPRINT_LIST::nextLibrary( wxString* aNickname )
 {
-    //DBG(printf( "%s: first:'%s' count:%d\n", __func__, (char*) TO_UTF8( *aNicknameList ), aJobZ );)
+    MUTLOCK lock( m_queue_lock );
+
+    if( m_cancel || m_next_nickname >= m_nicknames.size() )
+        return false;
+
+    *aNickname = m_nicknames[m_next_nickname++];
+    return true;
+}
 
-    for( int i=0; i<aJobZ; ++i )
-    {
-        if( m_error_count >= NTOLERABLE_ERRORS )
-            break;
 
-        const wxString& nickname = aNicknameList[i];
+void FOOTPRINT_LIST::loader_job()
+{
+    wxString nickname;
 
+    // Take the libraries one at a time, so a huge library keeps its thread busy while
+    // the other threads go on with the rest of the queue.
+    while( nextLibrary( &nickname ) )
+    {
         try
         {
             wxArrayString fpnames = m_lib_table->FootprintEnumerate( nickname );
@@ -178,14 +183,17 @@ void FOOTPRINT_LIST::loader_job( const wxString* aNicknameList, int aJobZ )
                 m_errors.push_back( new IO_ERROR( ioe ) );
             }
         }
+
+        MUTLOCK lock( m_queue_lock );
+
+        ++m_done_count;
     }
 }
 
 
-bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname )
+bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
+                                         wxProgressDialog* aProgress )
 {
-    bool retv = true;
-
     m_lib_table = aTable;
 
     // Clear data before reading files
@@ -193,83 +201,82 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
     m_errors.clear();
     m_list.clear();
 
+    m_cancel = false;
+    m_next_nickname = 0;
+    m_done_count = 0;
+
     if( aNickname )
-        // single footprint
-        loader_job( aNickname, 1 );
+        // single library
+        m_nicknames.assign( 1, *aNickname );
     else
-    {
-        std::vector< wxString > nicknames;
-
         // do all of them
-        nicknames = aTable->GetLogicalLibs();
+        m_nicknames = aTable->GetLogicalLibs();
 
 #if USE_WORKER_THREADS
 
-        // Even though the PLUGIN API implementation is the place for the
-        // locale toggling, in order to keep LOCAL_IO::C_count at 1 or greater
-        // for the duration of all helper threads, we increment by one here via instantiation.
-        // Only done here because of the multi-threaded nature of this code.
-        // Without this C_count skips in and out of "equal to zero" and causes
-        // needless locale toggling among the threads, based on which of them
-        // are in a PLUGIN::FootprintLoad() function.  And that is occasionally
-        // none of them.
-        LOCALE_IO   top_most_nesting;
+    // Even though the PLUGIN API implementation is the place for the
+    // locale toggling, in order to keep LOCAL_IO::C_count at 1 or greater
+    // for the duration of all helper threads, we increment by one here via instantiation.
+    // Only done here because of the multi-threaded nature of this code.
+    // Without this C_count skips in and out of "equal to zero" and causes
+    // needless locale toggling among the threads, based on which of them
+    // are in a PLUGIN::FootprintLoad() function.  And that is occasionally
+    // none of them.
+    LOCALE_IO   top_most_nesting;
 
-        // Something which will not invoke a thread copy constructor, one of many ways obviously:
-        typedef boost::ptr_vector< boost::thread >  MYTHREADS;
+    // Something which will not invoke a thread copy constructor, one of many ways obviously:
+    typedef boost::ptr_vector< boost::thread >  MYTHREADS;
 
-        MYTHREADS threads;
-
-        // Give each thread JOBZ nicknames to process.  The last portion of, or if the entire
-        // size() is small, I'll do myself.
-        for( unsigned i=0; i<nicknames.size();  )
-        {
-            if( m_error_count >= NTOLERABLE_ERRORS )
-            {
-                // abort the remaining nicknames.
-                retv = false;
-                break;
-            }
+    MYTHREADS   threads;
+    unsigned    workers = std::max( boost::thread::hardware_concurrency(), (unsigned) MIN_WORKERS );
 
-            int jobz = JOBZ;
+    workers = std::min( workers, (unsigned) m_nicknames.size() );
 
-            if( i + jobz >= nicknames.size() )
-            {
-                jobz = nicknames.size() - i;
+    // Without a progress dialog to update, I am one of the workers.
+    for( unsigned i = aProgress ? 0 : 1;  i < workers;  ++i )
+        threads.push_back( new boost::thread( &FOOTPRINT_LIST::loader_job, this ) );
 
-                // Only a little bit to do, I'll do it myself, on current thread.
-                loader_job( &nicknames[i], jobz );
-            }
-            else
+    if( !aProgress )
+    {
+        loader_job();
+    }
+    else
+    {
+        // Update the progress until all the workers are done, in any order.
+        for( unsigned i=0;  i<threads.size();  )
+        {
+            if( threads[i].timed_join( boost::posix_time::milliseconds( PROGRESS_INTERVAL ) ) )
             {
-                // Delegate the job to a worker thread created here.
-                threads.push_back( new boost::thread( &FOOTPRINT_LIST::loader_job,
-                        this, &nicknames[i], jobz ) );
+                ++i;
+                continue;
             }
 
-            i += jobz;
-        }
+            unsigned done = m_done_count;   // thread safe to read.
+            wxString msg  = wxString::Format( _( "%u of %u libraries loaded" ),
+                                              done, (unsigned) m_nicknames.size() );
 
-        // Wait for all the worker threads to complete, it does not matter in what order
-        // we wait for them as long as a full sweep is made.  Think of the great race,
-        // everyone must finish.
-        for( unsigned i=0;  i<threads.size();  ++i )
-        {
-            threads[i].join();
+            if( !aProgress->Update( done * 100 / m_nicknames.size(), msg ) )
+                Cancel();
         }
+    }
+
+    for( unsigned i=0;  i<threads.size();  ++i )
+    {
+        threads[i].join();
+    }
 #else
-        loader_job( &nicknames[0], nicknames.size() );
+    loader_job();
 #endif
 
+    if( m_nicknames.size() > 1 )
         m_list.sort();
-    }
 
     // The result of this function can be a blend of successes and failures, whose
     // mix is given by the Count()s of the two lists.  The return value indicates whether
-    // an abort occurred, even true does not necessarily mean full success, although
+    // the load was cancelled, even true does not necessarily mean full success, although
     // false definitely means failure.
 
-    return retv;
+    return !m_cancel;
 }
 
 
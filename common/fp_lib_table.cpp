@@ -175,6 +175,17 @@ MODULE* FP_LIB_TABLE::FootprintLoad( const wxString& aNickname, const wxString&
 }
 
 
+bool FP_LIB_TABLE::FootprintLoadHeader( const wxString& aNickname, const wxString& aFootprintName,
+                                        FOOTPRINT_HEADER* aHeader )
+{
+    const ROW* row = FindRow( aNickname );
+    wxASSERT( (PLUGIN*) row->plugin );
+
+    return row->plugin->FootprintLoadHeader( row->GetFullURI( true ), aFootprintName, aHeader,
+                                             row->GetProperties() );
+}
+
+
 FP_LIB_TABLE::SAVE_T FP_LIB_TABLE::FootprintSave( const wxString& aNickname, const MODULE* aFootprint, bool aOverwrite )
 {
     const ROW* row = FindRow( aNickname );
@@ -741,7 +752,7 @@ void FP_LIB_TABLE::Load( const wxString& aFileName )
     // Empty footprint library tables are valid.
     if( wxFileName::IsFileReadable( aFileName ) )
     {
-        FILE_LINE_READER    reader( aFileName );
+        MAPPED_FILE_LINE_READER reader( aFileName );
         FP_LIB_TABLE_LEXER  lexer( &reader );
 
         Parse( &lexer );
@@ -138,6 +138,56 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
 }
 
 
+void CAIRO_COMPOSITOR::BeginTiles()
+{
+    cairo_surface_flush( m_buffers[m_current].surface );
+}
+
+
+void CAIRO_COMPOSITOR::EndTiles()
+{
+    cairo_surface_mark_dirty( m_buffers[m_current].surface );
+}
+
+
+cairo_t* CAIRO_COMPOSITOR::CreateTileContext( int aX, int aY, int aWidth, int aHeight,
+                                              const cairo_matrix_t& aMatrix )
+{
+    wxASSERT( aX >= 0 && aY >= 0 && aX + aWidth <= (int) m_width
+              && aY + aHeight <= (int) m_height );
+
+    // The tile surface uses the pixels of the buffer rectangle, so nothing has to be copied
+    unsigned char* pixels = (unsigned char*) m_buffers[m_current].bitmap.get()
+                            + aY * m_stride + aX * sizeof(int);
+
+    cairo_surface_t* surface = cairo_image_surface_create_for_data( pixels, CAIRO_FORMAT_ARGB32,
+                                                                    aWidth, aHeight, m_stride );
+    cairo_t* context = cairo_create( surface );
+
+    // The context keeps a reference to the surface
+    cairo_surface_destroy( surface );
+
+    // Same settings as the buffer
+    cairo_set_antialias( context, CAIRO_ANTIALIAS_SUBPIXEL );
+    cairo_set_line_join( context, CAIRO_LINE_JOIN_ROUND );
+    cairo_set_line_cap( context, CAIRO_LINE_CAP_ROUND );
+
+    // The tile origin is moved to the corner of the rectangle
+    cairo_matrix_t matrix = aMatrix;
+    matrix.x0 -= aX;
+    matrix.y0 -= aY;
+    cairo_set_matrix( context, &matrix );
+
+    return context;
+}
+
+
+void CAIRO_COMPOSITOR::DestroyTileContext( cairo_t* aTileContext )
+{
+    cairo_destroy( aTileContext );
+}
+
+
 void CAIRO_COMPOSITOR::clean()
 {
     CAIRO_BUFFERS::const_iterator it;
@@ -33,11 +33,18 @@
 
 #include <limits>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 using namespace KIGFX;
 
 ///> Opacity of a single layer
 const float LAYER_ALPHA = 0.8;
 
+///> Entry of the tile queue standing for a layer change
+const int TILE_LAYER_BREAK = -1;
+
 CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
         wxEvtHandler* aPaintListener, const wxString& aName ) :
     wxWindow( aParent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxEXPAND, aName )
@@ -52,6 +59,13 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     isDeleteSavedPixels = false;
     validCompositor     = false;
     groupCounter        = 0;
+    currentTarget       = TARGET_CACHED;
+
+    // Tiles are worth it only if they can be drawn in parallel
+    isTiled             = false;
+#ifdef USE_OPENMP
+    isTiled             = omp_get_max_threads() > 1;
+#endif /* USE_OPENMP */
 
     // Connecting the event handlers
     Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
@@ -154,6 +168,8 @@ void CAIRO_GAL::EndDrawing()
 
 void CAIRO_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
+    drawTiles();
+
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
     isElementAdded = true;
@@ -163,6 +179,8 @@ void CAIRO_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint
 void CAIRO_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
                              double aWidth )
 {
+    drawTiles();
+
     if( isFillEnabled )
     {
         // Filled tracks mode
@@ -201,6 +219,8 @@ void CAIRO_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPo
 
 void CAIRO_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 {
+    drawTiles();
+
     // A circle is drawn using an arc
     cairo_new_sub_path( currentContext );
     cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, 0.0, 2 * M_PI );
@@ -212,6 +232,8 @@ void CAIRO_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 void CAIRO_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
                          double aEndAngle )
 {
+    drawTiles();
+
     SWAP( aStartAngle, >, aEndAngle );
 
     cairo_new_sub_path( currentContext );
@@ -223,6 +245,8 @@ void CAIRO_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aS
 
 void CAIRO_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
+    drawTiles();
+
     // Calculate the diagonal points
     VECTOR2D diagonalPointA( aEndPoint.x,  aStartPoint.y );
     VECTOR2D diagonalPointB( aStartPoint.x, aEndPoint.y );
@@ -240,6 +264,8 @@ void CAIRO_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 
 void CAIRO_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
 {
+    drawTiles();
+
     // Iterate over the point list and draw the segments
     std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
 
@@ -256,6 +282,8 @@ void CAIRO_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
 
 void CAIRO_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
+    drawTiles();
+
     // Iterate over the point list and draw the polygon
     std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
 
@@ -273,6 +301,8 @@ void CAIRO_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 void CAIRO_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
                            const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
 {
+    drawTiles();
+
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_curve_to( currentContext, aControlPointA.x, aControlPointA.y, aControlPointB.x,
                     aControlPointB.y, aEndPoint.x, aEndPoint.y );
@@ -313,11 +343,14 @@ bool CAIRO_GAL::Show( bool aShow )
 void CAIRO_GAL::Flush()
 {
     storePath();
+    drawTiles();
 }
 
 
 void CAIRO_GAL::ClearScreen()
 {
+    drawTiles();
+
     cairo_set_source_rgb( currentContext,
                           backgroundColor.r, backgroundColor.g, backgroundColor.b );
     cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
@@ -327,6 +360,7 @@ void CAIRO_GAL::ClearScreen()
 
 void CAIRO_GAL::SetIsFill( bool aIsFillEnabled )
 {
+    drawTiles();
     storePath();
     isFillEnabled = aIsFillEnabled;
 
@@ -342,6 +376,7 @@ void CAIRO_GAL::SetIsFill( bool aIsFillEnabled )
 
 void CAIRO_GAL::SetIsStroke( bool aIsStrokeEnabled )
 {
+    drawTiles();
     storePath();
     isStrokeEnabled = aIsStrokeEnabled;
 
@@ -357,6 +392,7 @@ void CAIRO_GAL::SetIsStroke( bool aIsStrokeEnabled )
 
 void CAIRO_GAL::SetStrokeColor( const COLOR4D& aColor )
 {
+    drawTiles();
     storePath();
     strokeColor = aColor;
 
@@ -375,6 +411,7 @@ void CAIRO_GAL::SetStrokeColor( const COLOR4D& aColor )
 
 void CAIRO_GAL::SetFillColor( const COLOR4D& aColor )
 {
+    drawTiles();
     storePath();
     fillColor = aColor;
 
@@ -393,6 +430,7 @@ void CAIRO_GAL::SetFillColor( const COLOR4D& aColor )
 
 void CAIRO_GAL::SetLineWidth( double aLineWidth )
 {
+    drawTiles();
     storePath();
 
     lineWidth = aLineWidth;
@@ -419,7 +457,13 @@ void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
 {
     super::SetLayerDepth( aLayerDepth );
 
-    if( isInitialized )
+    if( !tileQueue.empty() )
+    {
+        // The tiles change the layer, so the next groups can be queued as well
+        if( tileQueue.back() != TILE_LAYER_BREAK )
+            tileQueue.push_back( TILE_LAYER_BREAK );
+    }
+    else if( isInitialized )
     {
         storePath();
 
@@ -433,6 +477,8 @@ void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
 
 void CAIRO_GAL::Transform( MATRIX3x3D aTransformation )
 {
+    drawTiles();
+
     cairo_matrix_t cairoTransformation;
 
     cairo_matrix_init( &cairoTransformation,
@@ -460,6 +506,7 @@ void CAIRO_GAL::Rotate( double aAngle )
     }
     else
     {
+        drawTiles();
         cairo_rotate( currentContext, aAngle );
     }
 }
@@ -479,6 +526,7 @@ void CAIRO_GAL::Translate( const VECTOR2D& aTranslation )
     }
     else
     {
+        drawTiles();
         cairo_translate( currentContext, aTranslation.x, aTranslation.y );
     }
 }
@@ -498,6 +546,7 @@ void CAIRO_GAL::Scale( const VECTOR2D& aScale )
     }
     else
     {
+        drawTiles();
         cairo_scale( currentContext, aScale.x, aScale.y );
     }
 }
@@ -515,6 +564,7 @@ void CAIRO_GAL::Save()
     }
     else
     {
+        drawTiles();
         cairo_save( currentContext );
     }
 }
@@ -532,6 +582,7 @@ void CAIRO_GAL::Restore()
     }
     else
     {
+        drawTiles();
         cairo_restore( currentContext );
     }
 }
@@ -539,6 +590,7 @@ void CAIRO_GAL::Restore()
 
 int CAIRO_GAL::BeginGroup()
 {
+    drawTiles();
     initSurface();
 
     // If the grouping is started: the actual path is stored in the group, when
@@ -566,95 +618,36 @@ void CAIRO_GAL::EndGroup()
 
 void CAIRO_GAL::DrawGroup( int aGroupNumber )
 {
-    // This method implements a small Virtual Machine - all stored commands
-    // are executed; nested calling is also possible
-
     storePath();
 
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    if( isTiled && isInitialized && !isGrouping && currentTarget == TARGET_CACHED )
     {
-        switch( it->command )
+        if( tileQueue.empty() )
         {
-        case CMD_SET_FILL:
-            isFillEnabled = it->boolArgument;
-            break;
-
-        case CMD_SET_STROKE:
-            isStrokeEnabled = it->boolArgument;
-            break;
-
-        case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                 it->arguments[3] );
-            break;
-
-        case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                   it->arguments[3] );
-            break;
-
-        case CMD_SET_LINE_WIDTH:
-            {
-                // Make lines appear at least 1 pixel wide, no matter of zoom
-                double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
-                double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->arguments[0], minWidth ) );
-            }
-            break;
-
-
-        case CMD_STROKE_PATH:
-            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
-            break;
-
-        case CMD_FILL_PATH:
-            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
-            break;
-
-        case CMD_TRANSFORM:
-            cairo_matrix_t matrix;
-            cairo_matrix_init( &matrix, it->arguments[0], it->arguments[1], it->arguments[2],
-                               it->arguments[3], it->arguments[4], it->arguments[5] );
-            cairo_transform( currentContext, &matrix );
-            break;
-
-        case CMD_ROTATE:
-            cairo_rotate( currentContext, it->arguments[0] );
-            break;
-
-        case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->arguments[0], it->arguments[1] );
-            break;
+            // The layer drawn so far goes to the buffer, the tiles draw the rest of it
+            cairo_pop_group_to_source( currentContext );
+            cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
+        }
 
-        case CMD_SCALE:
-            cairo_scale( currentContext, it->arguments[0], it->arguments[1] );
-            break;
+        tileQueue.push_back( aGroupNumber );
+        return;
+    }
 
-        case CMD_SAVE:
-            cairo_save( currentContext );
-            break;
+    REPLAY_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
 
-        case CMD_RESTORE:
-            cairo_restore( currentContext );
-            break;
+    replayGroup( currentContext, aGroupNumber, state );
 
-        case CMD_CALL_GROUP:
-            DrawGroup( it->intArgument );
-            break;
-        }
-    }
+    isFillEnabled   = state.isFillEnabled;
+    isStrokeEnabled = state.isStrokeEnabled;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
 }
 
 
 void CAIRO_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     storePath();
+    drawTiles();
 
     for( GROUP::iterator it = groups[aGroupNumber].begin();
          it != groups[aGroupNumber].end(); ++it )
@@ -680,6 +673,7 @@ void CAIRO_GAL::ChangeGroupDepth( int aGroupNumber, int aDepth )
 void CAIRO_GAL::DeleteGroup( int aGroupNumber )
 {
     storePath();
+    drawTiles();
 
     // Delete the Cairo paths
     std::deque<GROUP_ELEMENT>::iterator it, end;
@@ -699,10 +693,9 @@ void CAIRO_GAL::DeleteGroup( int aGroupNumber )
 
 void CAIRO_GAL::ClearCache()
 {
-    for( int i = groups.size() - 1; i >= 0; --i )
-    {
-        DeleteGroup( i );
-    }
+    // The group numbers are not necessarily contiguous
+    while( !groups.empty() )
+        DeleteGroup( groups.begin()->first );
 }
 
 
@@ -744,10 +737,21 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
     if( !validCompositor )
         return;
 
+    // The buffer does not change: the tiles change the layer, and the groups of the next
+    // layer are queued as well
+    if( !tileQueue.empty() && aTarget == currentTarget )
+    {
+        if( tileQueue.back() != TILE_LAYER_BREAK )
+            tileQueue.push_back( TILE_LAYER_BREAK );
+
+        return;
+    }
+
     // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
     if( isInitialized )
     {
         storePath();
+        drawTiles();
 
         cairo_pop_group_to_source( currentContext );
         cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
@@ -781,6 +785,8 @@ RENDER_TARGET CAIRO_GAL::GetTarget() const
 
 void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 {
+    drawTiles();
+
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
 
@@ -816,6 +822,8 @@ void CAIRO_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 
 void CAIRO_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
+    drawTiles();
+
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
     cairo_set_source_rgb( currentContext, gridColor.r, gridColor.g, gridColor.b );
@@ -871,6 +879,195 @@ void CAIRO_GAL::storePath()
 }
 
 
+void CAIRO_GAL::SetTiledRendering( bool aEnabled )
+{
+    drawTiles();
+    isTiled = aEnabled;
+}
+
+
+void CAIRO_GAL::replayGroup( cairo_t* aContext, int aGroupNumber, REPLAY_STATE& aState ) const
+{
+    // This method implements a small Virtual Machine - all stored commands
+    // are executed; nested calling is also possible.  It may run on several tiles at
+    // once, so it changes only aContext and aState.
+
+    std::map<int, GROUP>::const_iterator group = groups.find( aGroupNumber );
+
+    if( group == groups.end() )
+        return;
+
+    for( GROUP::const_iterator it = group->second.begin();
+         it != group->second.end(); ++it )
+    {
+        switch( it->command )
+        {
+        case CMD_SET_FILL:
+            aState.isFillEnabled = it->boolArgument;
+            break;
+
+        case CMD_SET_STROKE:
+            aState.isStrokeEnabled = it->boolArgument;
+            break;
+
+        case CMD_SET_FILLCOLOR:
+            aState.fillColor = COLOR4D( it->arguments[0], it->arguments[1],
+                                        it->arguments[2], it->arguments[3] );
+            break;
+
+        case CMD_SET_STROKECOLOR:
+            aState.strokeColor = COLOR4D( it->arguments[0], it->arguments[1],
+                                          it->arguments[2], it->arguments[3] );
+            break;
+
+        case CMD_SET_LINE_WIDTH:
+            {
+                // Make lines appear at least 1 pixel wide, no matter of zoom
+                double x = 1.0, y = 1.0;
+                cairo_device_to_user_distance( aContext, &x, &y );
+                double minWidth = std::min( fabs( x ), fabs( y ) );
+                cairo_set_line_width( aContext, std::max( it->arguments[0], minWidth ) );
+            }
+            break;
+
+
+        case CMD_STROKE_PATH:
+            cairo_set_source_rgb( aContext, aState.strokeColor.r, aState.strokeColor.g,
+                                  aState.strokeColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke( aContext );
+            break;
+
+        case CMD_FILL_PATH:
+            cairo_set_source_rgb( aContext, aState.fillColor.r, aState.fillColor.g,
+                                  aState.fillColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill( aContext );
+            break;
+
+        case CMD_TRANSFORM:
+            cairo_matrix_t matrix;
+            cairo_matrix_init( &matrix, it->arguments[0], it->arguments[1], it->arguments[2],
+                               it->arguments[3], it->arguments[4], it->arguments[5] );
+            cairo_transform( aContext, &matrix );
+            break;
+
+        case CMD_ROTATE:
+            cairo_rotate( aContext, it->arguments[0] );
+            break;
+
+        case CMD_TRANSLATE:
+            cairo_translate( aContext, it->arguments[0], it->arguments[1] );
+            break;
+
+        case CMD_SCALE:
+            cairo_scale( aContext, it->arguments[0], it->arguments[1] );
+            break;
+
+        case CMD_SAVE:
+            cairo_save( aContext );
+            break;
+
+        case CMD_RESTORE:
+            cairo_restore( aContext );
+            break;
+
+        case CMD_CALL_GROUP:
+            replayGroup( aContext, it->intArgument, aState );
+            break;
+        }
+    }
+}
+
+
+void CAIRO_GAL::drawTiles()
+{
+    if( tileQueue.empty() )
+        return;
+
+    int tileCount = 1;
+
+#ifdef USE_OPENMP
+    // More tiles than threads, as some tiles hold more items than others
+    tileCount = omp_get_max_threads() * 2;
+#endif /* USE_OPENMP */
+
+    int width       = screenSize.x;
+    int height      = screenSize.y;
+    int tileHeight  = ( height + tileCount - 1 ) / tileCount;
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix( currentContext, &matrix );
+    double currentLineWidth = cairo_get_line_width( currentContext );
+
+    REPLAY_STATE initialState = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+    REPLAY_STATE finalState = initialState;
+    double finalLineWidth = currentLineWidth;
+
+    compositor->BeginTiles();
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int i = 0; i < tileCount; ++i )
+    {
+        int top = i * tileHeight;
+
+        if( top >= height )
+            continue;
+
+        cairo_t* tile = compositor->CreateTileContext( 0, top, width,
+                                                       std::min( tileHeight, height - top ),
+                                                       matrix );
+        cairo_set_line_width( tile, currentLineWidth );
+
+        REPLAY_STATE state = initialState;
+
+        // Cairo grouping prevents display of overlapping items on the same layer in the
+        // lighter color, as when the groups are drawn one by one
+        cairo_push_group( tile );
+
+        for( std::vector<int>::const_iterator it = tileQueue.begin(); it != tileQueue.end(); ++it )
+        {
+            if( *it == TILE_LAYER_BREAK )
+            {
+                cairo_pop_group_to_source( tile );
+                cairo_paint_with_alpha( tile, LAYER_ALPHA );
+                cairo_push_group( tile );
+            }
+            else
+            {
+                replayGroup( tile, *it, state );
+            }
+        }
+
+        // All the tiles end in the same state
+        if( i == 0 )
+        {
+            finalState      = state;
+            finalLineWidth  = cairo_get_line_width( tile );
+        }
+
+        cairo_pop_group_to_source( tile );
+        cairo_paint_with_alpha( tile, LAYER_ALPHA );
+
+        compositor->DestroyTileContext( tile );
+    }
+
+    compositor->EndTiles();
+    tileQueue.clear();
+
+    isFillEnabled   = finalState.isFillEnabled;
+    isStrokeEnabled = finalState.isStrokeEnabled;
+    fillColor       = finalState.fillColor;
+    strokeColor     = finalState.strokeColor;
+
+    // Go on with the layer of the last queued group
+    cairo_push_group( currentContext );
+    cairo_set_line_width( currentContext, finalLineWidth );
+}
+
+
 void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
     PostPaint();
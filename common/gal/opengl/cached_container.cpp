@@ -29,13 +29,14 @@
  * GPU memory and a fast reuse of that data.
  */
 
+
 #include <gal/opengl/cached_container.h>
 #include <gal/opengl/vertex_manager.h>
 #include <gal/opengl/vertex_item.h>
 #include <gal/opengl/shader.h>
 #include <confirm.h>
 #include <wx/log.h>
-#include <list>
+#include <cstring>
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__ */
@@ -43,10 +44,12 @@
 using namespace KIGFX;
 
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
-    VERTEX_CONTAINER( aSize ), m_item( NULL )
+    VERTEX_CONTAINER( aSize ), m_item( NULL ), m_compactionLimit( defaultCompactionLimit )
 {
+    memset( &m_stats, 0, sizeof( m_stats ) );
+
     // In the beginning there is only free space
-    m_freeChunks.insert( CHUNK( aSize, 0 ) );
+    addFreeChunk( 0, aSize );
 }
 
 
@@ -81,9 +84,9 @@ void CACHED_CONTAINER::FinishItem()
         int itemOffset = m_item->GetOffset();
 
         // Add the not used memory back to the pool
-        m_freeChunks.insert( CHUNK( m_chunkSize - m_itemSize, itemOffset + m_itemSize ) );
+        addFreeChunk( itemOffset + m_itemSize, m_chunkSize - m_itemSize );
         m_freeSpace += ( m_chunkSize - m_itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
+        m_chunkSize = m_itemSize;
     }
 
 #if CACHED_CONTAINER_TEST > 1
@@ -107,15 +110,17 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 
         // Reserve a bigger memory chunk for the current item and
         // make it multiple of 3 to store triangles
-        m_chunkSize = ( 2 * m_itemSize ) + aSize + ( 3 - aSize % 3 );
+        unsigned int newChunkSize = ( 2 * m_itemSize ) + aSize + ( 3 - aSize % 3 );
         // Save the current size before reallocating
-        m_chunkOffset = reallocate( m_chunkSize );
+        m_chunkOffset = reallocate( newChunkSize );
 
         if( m_chunkOffset > m_currentSize )
         {
             m_failed = true;
             return NULL;
         }
+
+        m_chunkSize = newChunkSize;
     }
 
     VERTEX* reserved = &m_vertices[m_chunkOffset + m_itemSize];
@@ -141,7 +146,10 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 {
     wxASSERT( aItem != NULL );
-    wxASSERT( m_items.find( aItem ) != m_items.end() );
+
+    // The item may have been freed already, together with all the others, by Clear()
+    if( m_items.erase( aItem ) == 0 )
+        return;
 
     int size   = aItem->GetSize();
     int offset = aItem->GetOffset();
@@ -153,14 +161,13 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
     // Insert a free memory chunk entry in the place where item was stored
     if( size > 0 )
     {
-        m_freeChunks.insert( CHUNK( size, offset ) );
+        m_itemOffsets.erase( offset );
+        addFreeChunk( offset, size );
         m_freeSpace += size;
         // Indicate that the item is not stored in the container anymore
         aItem->setSize( 0 );
     }
 
-    m_items.erase( aItem );
-
 #if CACHED_CONTAINER_TEST > 1
     test();
 #endif
@@ -195,11 +202,12 @@ void CACHED_CONTAINER::Clear()
     }
 
     m_items.clear();
-
+    m_itemOffsets.clear();
 
     // Now there is only free space left
     m_freeChunks.clear();
-    m_freeChunks.insert( CHUNK( m_freeSpace, 0 ) );
+    m_freeOffsets.clear();
+    addFreeChunk( 0, m_freeSpace );
 }
 
 
@@ -211,6 +219,92 @@ VERTEX* CACHED_CONTAINER::GetVertices( const VERTEX_ITEM* aItem ) const
 }
 
 
+void CACHED_CONTAINER::Compact()
+{
+    if( m_compactionLimit == 0 )
+        return;
+
+    unsigned int moved = 0;
+    FREE_OFFSET_MAP::iterator hole = m_freeOffsets.begin();
+
+    // Slide the item following each free chunk into it, until there is a single free chunk.
+    // An item bigger than what may still be moved is skipped, and the next chunk is tried.
+    // The first item moved by a call may be bigger than the limit: otherwise the chunk in
+    // front of an item bigger than the limit would never be filled.
+    while( moved < m_compactionLimit && hole != m_freeOffsets.end() )
+    {
+        FREE_OFFSET_MAP::iterator next = hole;
+
+        if( ++next == m_freeOffsets.end() )
+            break;
+
+        unsigned int holeOffset = hole->first;
+        unsigned int holeSize   = hole->second;
+
+        // There is no item after the hole if it is the chunk reserved by the modified item
+        ITEM_OFFSET_MAP::iterator it = m_itemOffsets.find( holeOffset + holeSize );
+
+        if( it == m_itemOffsets.end()
+            || ( moved > 0 && moved + it->second->GetSize() > m_compactionLimit ) )
+        {
+            hole = next;
+            continue;
+        }
+
+        VERTEX_ITEM* item     = it->second;
+        unsigned int itemSize = item->GetSize();
+
+        // The areas overlap if the item is bigger than the hole
+        memmove( &m_vertices[holeOffset], &m_vertices[holeOffset + holeSize],
+                 itemSize * VertexSize );
+
+        item->setOffset( holeOffset );
+        m_itemOffsets.erase( it );
+        m_itemOffsets[holeOffset] = item;
+
+        // The hole is now after the item, and it may join the next free chunk
+        removeFreeChunk( holeOffset, holeSize );
+        addFreeChunk( holeOffset + itemSize, holeSize );
+        hole = m_freeOffsets.find( holeOffset + itemSize );
+
+        moved += itemSize;
+    }
+
+    if( moved == 0 )
+        return;
+
+    m_dirty = true;
+    m_stats.compactions++;
+    m_stats.compactedVertices += moved;
+
+#if CACHED_CONTAINER_TEST > 0
+    STATISTICS stats = GetStatistics();
+
+    wxLogDebug( wxT( "Compacted %d vertices, %d free chunks, fragmentation %.3f" ),
+                moved, stats.freeChunks, stats.Fragmentation() );
+#endif
+
+    // The free space may be at the end of the container now
+    if( m_freeSpace > ( m_currentSize / 2 ) && m_currentSize > m_initialSize )
+    {
+        resizeContainer( m_currentSize / 2 );
+    }
+}
+
+
+CACHED_CONTAINER::STATISTICS CACHED_CONTAINER::GetStatistics() const
+{
+    STATISTICS stats = m_stats;
+
+    stats.containerSize     = m_currentSize;
+    stats.freeSpace         = m_freeSpace;
+    stats.freeChunks        = m_freeOffsets.size();
+    stats.largestFreeChunk  = m_freeChunks.empty() ? 0 : m_freeChunks.rbegin()->first;
+
+    return stats;
+}
+
+
 unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
 {
     wxASSERT( aSize > 0 );
@@ -219,6 +313,38 @@ unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize 0x%08lx from %d to %d" ), (long) m_item, m_itemSize, aSize );
 #endif
 
+    // The not used part of the current chunk goes back to the pool first,
+    // so it is merged with the free space around it
+    if( m_chunkSize > m_itemSize )
+    {
+        addFreeChunk( m_chunkOffset + m_itemSize, m_chunkSize - m_itemSize );
+        m_freeSpace += ( m_chunkSize - m_itemSize );
+    }
+
+    m_chunkSize = m_itemSize;
+
+    if( m_itemSize > 0 )
+    {
+        // Grow the chunk in place, if there is enough free space just after it
+        FREE_OFFSET_MAP::iterator next = m_freeOffsets.find( m_chunkOffset + m_itemSize );
+
+        if( next != m_freeOffsets.end() && m_itemSize + next->second >= aSize )
+        {
+            unsigned int nextOffset = next->first;
+            unsigned int nextSize   = next->second;
+            unsigned int extraSize  = aSize - m_itemSize;
+
+            removeFreeChunk( nextOffset, nextSize );
+
+            if( nextSize > extraSize )
+                addFreeChunk( nextOffset + extraSize, nextSize - extraSize );
+
+            m_freeSpace -= extraSize;
+
+            return m_chunkOffset;
+        }
+    }
+
     // Is there enough space to store vertices?
     if( m_freeSpace < aSize )
     {
@@ -240,22 +366,31 @@ unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
             return UINT_MAX;
     }
 
-    // Look for the free space chunk of at least given size
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    // Look for the smallest free space chunk of at least given size
+    FREE_CHUNK_SET::iterator newChunk = m_freeChunks.lower_bound( CHUNK( aSize, 0 ) );
 
     if( newChunk == m_freeChunks.end() )
     {
-        // In the case when there is enough space to store the vertices,
-        // but the free space is not continous we should defragment the container
-        if( !defragment() )
-            return UINT_MAX;
+        // In the case when there is enough space to store the vertices, but the free space
+        // is not continous, either we make room at the end of the container and Compact()
+        // gathers the free space later, or we defragment the container now
+        if( m_compactionLimit > 0 )
+        {
+            if( !resizeContainer( getPowerOf2( m_currentSize + aSize ) ) )
+                return UINT_MAX;
+        }
+        else
+        {
+            if( !defragment() )
+                return UINT_MAX;
+        }
 
         // Update the current offset
         m_chunkOffset = m_item->GetOffset();
 
-        // We can take the first free chunk, as there is only one after defragmentation
-        // and we can be sure that it provides enough space to store the object
-        newChunk = m_freeChunks.begin();
+        // Now there is a chunk big enough at the end of the container
+        newChunk = m_freeChunks.lower_bound( CHUNK( aSize, 0 ) );
+        wxASSERT( newChunk != m_freeChunks.end() );
     }
 
     // Parameters of the allocated cuhnk
@@ -265,36 +400,36 @@ unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxASSERT( chunkSize >= aSize );
     wxASSERT( chunkOffset < m_currentSize );
 
+    // Remove the allocated chunk from the free space pool
+    removeFreeChunk( chunkOffset, chunkSize );
+
     // Check if the item was previously stored in the container
     if( m_itemSize > 0 )
     {
 #if CACHED_CONTAINER_TEST > 3
         wxLogDebug( wxT( "Moving 0x%08x from 0x%08x to 0x%08x" ),
-                    (int) m_item, oldChunkOffset, chunkOffset );
+                    (int) m_item, m_chunkOffset, chunkOffset );
 #endif
         // The item was reallocated, so we have to copy all the old data to the new place
         memcpy( &m_vertices[chunkOffset], &m_vertices[m_chunkOffset],
                 m_itemSize * VertexSize );
 
         // Free the space previously used by the chunk
-        wxASSERT( m_itemSize > 0 );
-        m_freeChunks.insert( CHUNK( m_itemSize, m_chunkOffset ) );
+        m_itemOffsets.erase( m_chunkOffset );
+        addFreeChunk( m_chunkOffset, m_itemSize );
         m_freeSpace += m_itemSize;
     }
 
-    // Remove the allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-
     // If there is some space left, return it to the pool - add an entry for it
     if( chunkSize > aSize )
     {
-        m_freeChunks.insert( CHUNK( chunkSize - aSize, chunkOffset + aSize ) );
+        addFreeChunk( chunkOffset + aSize, chunkSize - aSize );
     }
 
     m_freeSpace -= aSize;
-    // mergeFreeChunks();   // veery slow and buggy
 
     m_item->setOffset( chunkOffset );
+    m_itemOffsets[chunkOffset] = m_item;
 
     return chunkOffset;
 }
@@ -306,116 +441,111 @@ bool CACHED_CONTAINER::defragment( VERTEX* aTarget )
     wxLogDebug( wxT( "Defragmenting" ) );
 
     prof_counter totalTime;
-    prof_start( &totalTime, false );
+    prof_start( &totalTime );
 #endif
 
-    if( aTarget == NULL )
-    {
-        // No target was specified, so we have to reallocate our own space
-        aTarget = static_cast<VERTEX*>( malloc( m_currentSize * sizeof( VERTEX ) ) );
+    // Without a target the items are moved within the container.  They are moved towards its
+    // beginning in the order of their offsets, so no item is overwritten before it is moved.
+    bool inPlace = ( aTarget == NULL );
 
-        if( aTarget == NULL )
-        {
-            DisplayError( NULL, wxT( "Run out of memory" ) );
-            return false;
-        }
-    }
+    if( inPlace )
+        aTarget = m_vertices;
 
-    int newOffset = 0;
-    ITEMS::iterator it, it_end;
+    unsigned int newOffset = 0;
+    ITEM_OFFSET_MAP newItemOffsets;
+    ITEM_OFFSET_MAP::iterator it, it_end;
 
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+    for( it = m_itemOffsets.begin(), it_end = m_itemOffsets.end(); it != it_end; ++it )
     {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        VERTEX_ITEM* item    = it->second;
+        unsigned int offset  = it->first;
+        unsigned int size    = item->GetSize();
 
         // Move an item to the new container
-        memcpy( &aTarget[newOffset], &m_vertices[itemOffset], itemSize * VertexSize );
+        if( !inPlace || offset != newOffset )
+            memmove( &aTarget[newOffset], &m_vertices[offset], size * VertexSize );
 
         // Update new offset
         item->setOffset( newOffset );
+        newItemOffsets.insert( newItemOffsets.end(), std::make_pair( newOffset, item ) );
 
         // Move to the next free space
-        newOffset += itemSize;
+        newOffset += size;
+    }
+
+    if( !inPlace )
+    {
+        free( m_vertices );
+        m_vertices = aTarget;
     }
 
-    free( m_vertices );
-    m_vertices = aTarget;
+    m_itemOffsets.swap( newItemOffsets );
+    m_dirty = true;
+
+    m_stats.defragmentations++;
+    m_stats.defragmentedVertices += newOffset;
 
     // Now there is only one big chunk of free memory
+    wxASSERT( newOffset == m_currentSize - m_freeSpace );
     m_freeChunks.clear();
-    wxASSERT( m_freeSpace > 0 );
-    m_freeChunks.insert( CHUNK( m_freeSpace, m_currentSize - m_freeSpace ) );
+    m_freeOffsets.clear();
+
+    if( m_freeSpace > 0 )
+        addFreeChunk( newOffset, m_freeSpace );
 
 #if CACHED_CONTAINER_TEST > 0
     prof_end( &totalTime );
 
     wxLogDebug( wxT( "Defragmented the container storing %d vertices / %.1f ms" ),
-                m_currentSize - m_freeSpace, (double) totalTime.value / 1000.0 );
+                m_currentSize - m_freeSpace, totalTime.msecs() );
 #endif
 
     return true;
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
-
-#if CACHED_CONTAINER_TEST > 0
-    prof_counter totalTime;
-    prof_start( &totalTime, false );
-#endif
-
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
+    wxASSERT( aSize > 0 );
 
-    FREE_CHUNK_MAP::const_iterator it, it_end;
+    FREE_OFFSET_MAP::iterator next = m_freeOffsets.lower_bound( aOffset );
 
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
+    // Merge with the following free chunk
+    if( next != m_freeOffsets.end() && next->first == aOffset + aSize )
     {
-        freeChunks.push_back( std::make_pair( it->second, it->first ) );
+        aSize += next->second;
+        m_freeChunks.erase( CHUNK( next->second, next->first ) );
+        m_freeOffsets.erase( next++ );
     }
 
-    m_freeChunks.clear();
-    freeChunks.sort();
+    // Merge with the preceding free chunk
+    if( next != m_freeOffsets.begin() )
+    {
+        FREE_OFFSET_MAP::iterator prev = next;
+        --prev;
 
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int offset = freeChunks.front().first;
-    unsigned int size   = freeChunks.front().second;
-    freeChunks.pop_front();
+        wxASSERT( prev->first + prev->second <= aOffset );
 
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
-    {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
+        if( prev->first + prev->second == aOffset )
         {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size   = itf->second;
-
+            aOffset = prev->first;
+            aSize  += prev->second;
+            m_freeChunks.erase( CHUNK( prev->second, prev->first ) );
+            m_freeOffsets.erase( prev );
         }
     }
 
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
+    m_freeOffsets.insert( next, std::make_pair( aOffset, aSize ) );
+    m_freeChunks.insert( CHUNK( aSize, aOffset ) );
+}
 
-#if CACHED_CONTAINER_TEST > 0
-    prof_end( &totalTime );
 
-    wxLogDebug( wxT( "Merged free chunks / %.1f ms" ), (double) totalTime.value / 1000.0 );
-#endif
+void CACHED_CONTAINER::removeFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    wxASSERT( m_freeOffsets.count( aOffset ) && m_freeOffsets[aOffset] == aSize );
 
-    test();
+    m_freeOffsets.erase( aOffset );
+    m_freeChunks.erase( CHUNK( aSize, aOffset ) );
 }
 
 
@@ -436,21 +566,50 @@ bool CACHED_CONTAINER::resizeContainer( unsigned int aNewSize )
         if( reservedSpace() > aNewSize )
             return false;
 
-        newContainer = static_cast<VERTEX*>( malloc( aNewSize * sizeof( VERTEX ) ) );
+        FREE_OFFSET_MAP::reverse_iterator last = m_freeOffsets.rbegin();
 
-        if( newContainer == NULL )
+        if( last != m_freeOffsets.rend() && last->first + last->second == m_currentSize
+                && last->first <= aNewSize )
         {
-            DisplayError( NULL, wxT( "Run out of memory" ) );
-            return false;
-        }
+            // All the data is stored below the new size, so the free chunk at the end
+            // is simply cut
+            unsigned int lastOffset = last->first;
+            unsigned int lastSize   = last->second;
+
+            newContainer = static_cast<VERTEX*>( realloc( m_vertices, aNewSize * sizeof( VERTEX ) ) );
 
-        // Defragment directly to the new, smaller container
-        defragment( newContainer );
+            if( newContainer == NULL )
+                return false;
 
-        // We have to correct freeChunks after defragmentation
-        m_freeChunks.clear();
-        wxASSERT( aNewSize - reservedSpace() > 0 );
-        m_freeChunks.insert( CHUNK( aNewSize - reservedSpace(), reservedSpace() ) );
+            removeFreeChunk( lastOffset, lastSize );
+
+            if( lastOffset < aNewSize )
+                addFreeChunk( lastOffset, aNewSize - lastOffset );
+        }
+        else if( m_compactionLimit > 0 )
+        {
+            // Compact() has to move the data first
+            return false;
+        }
+        else
+        {
+            newContainer = static_cast<VERTEX*>( malloc( aNewSize * sizeof( VERTEX ) ) );
+
+            if( newContainer == NULL )
+            {
+                DisplayError( NULL, wxT( "Run out of memory" ) );
+                return false;
+            }
+
+            // Defragment directly to the new, smaller container
+            defragment( newContainer );
+
+            // We have to correct freeChunks after defragmentation
+            m_freeChunks.clear();
+            m_freeOffsets.clear();
+            wxASSERT( aNewSize - reservedSpace() > 0 );
+            addFreeChunk( reservedSpace(), aNewSize - reservedSpace() );
+        }
     }
     else
     {
@@ -464,13 +623,14 @@ bool CACHED_CONTAINER::resizeContainer( unsigned int aNewSize )
         }
 
         // Add an entry for the new memory chunk at the end of the container
-        m_freeChunks.insert( CHUNK( aNewSize - m_currentSize, m_currentSize ) );
+        addFreeChunk( m_currentSize, aNewSize - m_currentSize );
     }
 
     m_vertices = newContainer;
 
     m_freeSpace   += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
+    m_stats.resizes++;
 
     return true;
 }
@@ -490,14 +650,14 @@ unsigned int CACHED_CONTAINER::getPowerOf2( unsigned int aNumber ) const
 #ifdef CACHED_CONTAINER_TEST
 void CACHED_CONTAINER::showFreeChunks()
 {
-    FreeChunkMap::iterator it;
+    FREE_OFFSET_MAP::iterator it;
 
     wxLogDebug( wxT( "Free chunks:" ) );
 
-    for( it = m_freeChunks.begin(); it != m_freeChunks.end(); ++it )
+    for( it = m_freeOffsets.begin(); it != m_freeOffsets.end(); ++it )
     {
-        unsigned int offset = getChunkOffset( *it );
-        unsigned int size   = getChunkSize( *it );
+        unsigned int offset = it->first;
+        unsigned int size   = it->second;
         wxASSERT( size > 0 );
 
         wxLogDebug( wxT( "[0x%08x-0x%08x] (size %d)" ),
@@ -508,13 +668,13 @@ void CACHED_CONTAINER::showFreeChunks()
 
 void CACHED_CONTAINER::showReservedChunks()
 {
-    Items::iterator it;
+    ITEM_OFFSET_MAP::iterator it;
 
     wxLogDebug( wxT( "Reserved chunks:" ) );
 
-    for( it = m_items.begin(); it != m_items.end(); ++it )
+    for( it = m_itemOffsets.begin(); it != m_itemOffsets.end(); ++it )
     {
-        VERTEX_ITEM* item   = *it;
+        VERTEX_ITEM* item   = it->second;
         unsigned int offset = item->GetOffset();
         unsigned int size   = item->GetSize();
         wxASSERT( size > 0 );
@@ -527,23 +687,29 @@ void CACHED_CONTAINER::showReservedChunks()
 
 void CACHED_CONTAINER::test()
 {
-    // Free space check
+    // Free space check, the adjacent free chunks must have been merged
     unsigned int freeSpace = 0;
-    FreeChunkMap::iterator itf;
+    unsigned int lastEnd = UINT_MAX;
+    FREE_OFFSET_MAP::iterator itf;
+
+    wxASSERT( m_freeOffsets.size() == m_freeChunks.size() );
 
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
+    for( itf = m_freeOffsets.begin(); itf != m_freeOffsets.end(); ++itf )
+    {
+        wxASSERT( itf->first != lastEnd );
+        wxASSERT( m_freeChunks.count( CHUNK( itf->second, itf->first ) ) );
+
+        freeSpace += itf->second;
+        lastEnd = itf->first + itf->second;
+    }
 
     wxASSERT( freeSpace == m_freeSpace );
 
-    // Reserved space check
-    /*unsigned int reservedSpace = 0;
-    Items::iterator itr;
-    for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        reservedSpace += ( *itr )->GetSize();
-    reservedSpace += m_itemSize;    // Add the current chunk size
+    // Stored items check
+    ITEM_OFFSET_MAP::iterator iti;
 
-    wxASSERT( ( freeSpace + reservedSpace ) == m_currentSize );*/
+    for( iti = m_itemOffsets.begin(); iti != m_itemOffsets.end(); ++iti )
+        wxASSERT( iti->second->GetOffset() == iti->first );
 
     // Overlapping check TBD
 }
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/opengl_cache_worker.h>
+
+#include <wx/debug.h>
+
+using namespace KIGFX;
+
+OPENGL_CACHE_WORKER::OPENGL_CACHE_WORKER() :
+    stagingManager( true, STAGING_SIZE )
+{
+    currentManager = &stagingManager;
+}
+
+
+OPENGL_CACHE_WORKER::~OPENGL_CACHE_WORKER()
+{
+    ClearCache();
+}
+
+
+void OPENGL_CACHE_WORKER::BeginDrawing()
+{
+    wxASSERT_MSG( false, wxT( "A cache worker cannot draw on the screen" ) );
+}
+
+
+void OPENGL_CACHE_WORKER::EndDrawing()
+{
+    wxASSERT_MSG( false, wxT( "A cache worker cannot draw on the screen" ) );
+}
+
+
+void OPENGL_CACHE_WORKER::ResizeScreen( int aWidth, int aHeight )
+{
+    screenSize = VECTOR2D( aWidth, aHeight );
+}
+
+
+bool OPENGL_CACHE_WORKER::Show( bool aShow )
+{
+    return false;
+}
+
+
+void OPENGL_CACHE_WORKER::Flush()
+{
+}
+
+
+void OPENGL_CACHE_WORKER::ClearScreen()
+{
+}
+
+
+void OPENGL_CACHE_WORKER::Transform( MATRIX3x3D aTransformation )
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
+int OPENGL_CACHE_WORKER::BeginGroup()
+{
+    boost::shared_ptr<VERTEX_ITEM> newItem( new VERTEX_ITEM( stagingManager ) );
+    groups.push_back( newItem );
+
+    return groups.size() - 1;
+}
+
+
+void OPENGL_CACHE_WORKER::EndGroup()
+{
+    stagingManager.FinishItem();
+}
+
+
+void OPENGL_CACHE_WORKER::DrawGroup( int aGroupNumber )
+{
+    wxASSERT_MSG( false, wxT( "A cache worker cannot draw on the screen" ) );
+}
+
+
+void OPENGL_CACHE_WORKER::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
+{
+    stagingManager.ChangeItemColor( *groups[aGroupNumber], aNewColor );
+}
+
+
+void OPENGL_CACHE_WORKER::ChangeGroupDepth( int aGroupNumber, int aDepth )
+{
+    stagingManager.ChangeItemDepth( *groups[aGroupNumber], aDepth );
+}
+
+
+void OPENGL_CACHE_WORKER::DeleteGroup( int aGroupNumber )
+{
+    // The numbers of the groups are indices, so the slot is only emptied
+    groups[aGroupNumber].reset();
+}
+
+
+void OPENGL_CACHE_WORKER::ClearCache()
+{
+    // Free the whole container first, so the groups do not return their chunks one by one
+    stagingManager.Clear();
+    groups.clear();
+}
+
+
+void OPENGL_CACHE_WORKER::SaveScreen()
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
+void OPENGL_CACHE_WORKER::RestoreScreen()
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
+void OPENGL_CACHE_WORKER::SetTarget( RENDER_TARGET aTarget )
+{
+    // Groups are always cached
+    wxASSERT( aTarget == TARGET_CACHED );
+}
+
+
+RENDER_TARGET OPENGL_CACHE_WORKER::GetTarget() const
+{
+    return TARGET_CACHED;
+}
+
+
+void OPENGL_CACHE_WORKER::ClearTarget( RENDER_TARGET aTarget )
+{
+}
+
+
+void OPENGL_CACHE_WORKER::DrawCursor( const VECTOR2D& aCursorPosition )
+{
+}
+
+
+void OPENGL_CACHE_WORKER::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+}
+
+
+void OPENGL_CACHE_WORKER::initCursor( int aCursorSize )
+{
+}
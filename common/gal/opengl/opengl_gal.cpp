@@ -27,6 +27,8 @@
  */
 
 #include <gal/opengl/opengl_gal.h>
+#include <gal/opengl/opengl_cache_worker.h>
+#include <gal/opengl/cached_container.h>
 #include <gal/definitions.h>
 
 #include <wx/log.h>
@@ -40,9 +42,6 @@
 
 using namespace KIGFX;
 
-// Prototypes
-void InitTesselatorCallbacks( GLUtesselator* aTesselator );
-
 const int glAttributes[] = { WX_GL_RGBA, WX_GL_DOUBLEBUFFER, WX_GL_DEPTH_SIZE, 16, 0 };
 
 OPENGL_GAL::OPENGL_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
@@ -66,6 +65,10 @@ OPENGL_GAL::OPENGL_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     isGrouping               = false;
     groupCounter             = 0;
 
+#ifdef PROFILE
+    cacheEvents              = 0;
+#endif /* PROFILE */
+
     // Connecting the event handlers
     Connect( wxEVT_PAINT,       wxPaintEventHandler( OPENGL_GAL::onPaint ) );
 
@@ -91,18 +94,6 @@ OPENGL_GAL::OPENGL_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
 
     // Grid color settings are different in Cairo and OpenGL
     SetGridColor( COLOR4D( 0.8, 0.8, 0.8, 0.1 ) );
-
-    // Tesselator initialization
-    tesselator = gluNewTess();
-    InitTesselatorCallbacks( tesselator );
-
-    if( tesselator == NULL )
-    {
-        DisplayError( parentWindow, wxT( "Could not create the tesselator" ) );
-        exit( 1 );
-    }
-
-    gluTessProperty( tesselator, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_POSITIVE );
 }
 
 
@@ -110,7 +101,6 @@ OPENGL_GAL::~OPENGL_GAL()
 {
     glFlush();
 
-    gluDeleteTess( tesselator );
     ClearCache();
 
     delete glContext;
@@ -230,6 +220,26 @@ void OPENGL_GAL::EndDrawing()
     compositor.SetBuffer( overlayBuffer );
     overlayManager.EndDrawing();
 
+#ifdef PROFILE
+    // Watch the fragmentation of the cached vertices each time they are resized or moved
+    CACHED_CONTAINER* container = static_cast<CACHED_CONTAINER*>( cachedManager.GetContainer() );
+    CACHED_CONTAINER::STATISTICS stats = container->GetStatistics();
+    unsigned int events = stats.resizes + stats.defragmentations + stats.compactions;
+
+    if( events != cacheEvents )
+    {
+        cacheEvents = events;
+
+        wxLogDebug( wxT( "Cached vertices: size %u, free %u in %u chunks (largest %u), "
+                         "fragmentation %.3f, %u resizes, %u defragmentations (%lu vertices), "
+                         "%u compactions (%lu vertices)" ),
+                    stats.containerSize, stats.freeSpace, stats.freeChunks,
+                    stats.largestFreeChunk, stats.Fragmentation(), stats.resizes,
+                    stats.defragmentations, (unsigned long) stats.defragmentedVertices,
+                    stats.compactions, (unsigned long) stats.compactedVertices );
+    }
+#endif /* PROFILE */
+
     // Be sure that the framebuffer is not colorized (happens on specific GPU&drivers combinations)
     glColor4d( 1.0, 1.0, 1.0, 1.0 );
 
@@ -245,313 +255,6 @@ void OPENGL_GAL::EndDrawing()
 }
 
 
-void OPENGL_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    const VECTOR2D  startEndVector = aEndPoint - aStartPoint;
-    double          lineAngle = startEndVector.Angle();
-
-    drawLineQuad( aStartPoint, aEndPoint );
-
-    // Line caps
-    if( lineWidth > 1.0 )
-    {
-        drawFilledSemiCircle( aStartPoint, lineWidth / 2, lineAngle + M_PI / 2 );
-        drawFilledSemiCircle( aEndPoint,   lineWidth / 2, lineAngle - M_PI / 2 );
-    }
-}
-
-
-void OPENGL_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                              double aWidth )
-{
-    VECTOR2D startEndVector = aEndPoint - aStartPoint;
-    double   lineAngle      = startEndVector.Angle();
-
-    if( isFillEnabled )
-    {
-        // Filled tracks
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        SetLineWidth( aWidth );
-        drawLineQuad( aStartPoint, aEndPoint );
-
-        // Draw line caps
-        drawFilledSemiCircle( aStartPoint, aWidth / 2, lineAngle + M_PI / 2 );
-        drawFilledSemiCircle( aEndPoint,   aWidth / 2, lineAngle - M_PI / 2 );
-    }
-    else
-    {
-        // Outlined tracks
-        double lineLength = startEndVector.EuclideanNorm();
-
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        Save();
-
-        currentManager->Translate( aStartPoint.x, aStartPoint.y, 0.0 );
-        currentManager->Rotate( lineAngle, 0.0f, 0.0f, 1.0f );
-
-        drawLineQuad( VECTOR2D( 0.0,         aWidth / 2.0 ),
-                      VECTOR2D( lineLength,  aWidth / 2.0 ) );
-
-        drawLineQuad( VECTOR2D( 0.0,        -aWidth / 2.0 ),
-                      VECTOR2D( lineLength, -aWidth / 2.0 ) );
-
-        // Draw line caps
-        drawStrokedSemiCircle( VECTOR2D( 0.0, 0.0 ), aWidth / 2, M_PI / 2 );
-        drawStrokedSemiCircle( VECTOR2D( lineLength, 0.0 ), aWidth / 2, -M_PI / 2 );
-
-        Restore();
-    }
-}
-
-
-void OPENGL_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
-{
-    if( isFillEnabled )
-    {
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        /* Draw a triangle that contains the circle, then shade it leaving only the circle.
-         *  Parameters given to setShader are indices of the triangle's vertices
-         *  (if you want to understand more, check the vertex shader source [shader.vert]).
-         *  Shader uses this coordinates to determine if fragments are inside the circle or not.
-         *       v2
-         *       /\
-         *      //\\
-         *  v0 /_\/_\ v1
-         */
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 1.0 );
-        currentManager->Vertex( aCenterPoint.x - aRadius * sqrt( 3.0f ),            // v0
-                                aCenterPoint.y - aRadius, layerDepth );
-
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 2.0 );
-        currentManager->Vertex( aCenterPoint.x + aRadius * sqrt( 3.0f ),             // v1
-                                aCenterPoint.y - aRadius, layerDepth );
-
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 3.0 );
-        currentManager->Vertex( aCenterPoint.x, aCenterPoint.y + aRadius * 2.0f,    // v2
-                                layerDepth );
-    }
-
-    if( isStrokeEnabled )
-    {
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        /* Draw a triangle that contains the circle, then shade it leaving only the circle.
-         *  Parameters given to setShader are indices of the triangle's vertices
-         *  (if you want to understand more, check the vertex shader source [shader.vert]).
-         *  and the line width. Shader uses this coordinates to determine if fragments are
-         *  inside the circle or not.
-         *       v2
-         *       /\
-         *      //\\
-         *  v0 /_\/_\ v1
-         */
-        double outerRadius = aRadius + ( lineWidth / 2 );
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 1.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x - outerRadius * sqrt( 3.0f ),            // v0
-                                aCenterPoint.y - outerRadius, layerDepth );
-
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 2.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x + outerRadius * sqrt( 3.0f ),            // v1
-                                aCenterPoint.y - outerRadius, layerDepth );
-
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 3.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x, aCenterPoint.y + outerRadius * 2.0f,    // v2
-                                layerDepth );
-    }
-}
-
-
-void OPENGL_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
-                          double aEndAngle )
-{
-    if( aRadius <= 0 )
-        return;
-
-    // Swap the angles, if start angle is greater than end angle
-    SWAP( aStartAngle, >, aEndAngle );
-
-    VECTOR2D startPoint( cos( aStartAngle ), sin( aStartAngle ) );
-    VECTOR2D endPoint( cos( aEndAngle ), sin( aEndAngle ) );
-    VECTOR2D startEndPoint = startPoint + endPoint;
-    VECTOR2D middlePoint   = 0.5 * startEndPoint;
-
-    Save();
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, layerDepth );
-
-    if( isStrokeEnabled )
-    {
-        double alphaIncrement = 2.0 * M_PI / CIRCLE_POINTS;
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        VECTOR2D p( cos( aStartAngle ) * aRadius, sin( aStartAngle ) * aRadius );
-        double alpha;
-
-        for( alpha = aStartAngle + alphaIncrement; alpha < aEndAngle; alpha += alphaIncrement )
-        {
-            VECTOR2D p_next( cos( alpha ) * aRadius, sin( alpha ) * aRadius );
-            DrawLine( p, p_next );
-
-            p = p_next;
-        }
-
-        // Draw the last missing part
-        if( alpha != aEndAngle )
-        {
-            VECTOR2D p_last( cos( aEndAngle ) * aRadius, sin( aEndAngle ) * aRadius );
-            DrawLine( p, p_last );
-        }
-    }
-
-    if( isFillEnabled )
-    {
-        double alphaIncrement = 2 * M_PI / CIRCLE_POINTS;
-        double alpha;
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        for( alpha = aStartAngle; ( alpha + alphaIncrement ) < aEndAngle; )
-        {
-            currentManager->Vertex( middlePoint.x, middlePoint.y,  0.0 );
-            currentManager->Vertex( cos( alpha ),  sin( alpha ),   0.0 );
-            alpha += alphaIncrement;
-            currentManager->Vertex( cos( alpha ),  sin( alpha ),   0.0 );
-        }
-
-        currentManager->Vertex( middlePoint.x, middlePoint.y,  0.0 );
-        currentManager->Vertex( cos( alpha ),  sin( alpha ),   0.0 );
-        currentManager->Vertex( endPoint.x,    endPoint.y,     0.0 );
-    }
-
-    Restore();
-}
-
-
-void OPENGL_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    // Compute the diagonal points of the rectangle
-    VECTOR2D diagonalPointA( aEndPoint.x, aStartPoint.y );
-    VECTOR2D diagonalPointB( aStartPoint.x, aEndPoint.y );
-
-    // Stroke the outline
-    if( isStrokeEnabled )
-    {
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        std::deque<VECTOR2D> pointList;
-        pointList.push_back( aStartPoint );
-        pointList.push_back( diagonalPointA );
-        pointList.push_back( aEndPoint );
-        pointList.push_back( diagonalPointB );
-        pointList.push_back( aStartPoint );
-        DrawPolyline( pointList );
-    }
-
-    // Fill the rectangle
-    if( isFillEnabled )
-    {
-        currentManager->Shader( SHADER_NONE );
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );
-        currentManager->Vertex( diagonalPointA.x, diagonalPointA.y, layerDepth );
-        currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );
-
-        currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );
-        currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );
-        currentManager->Vertex( diagonalPointB.x, diagonalPointB.y, layerDepth );
-    }
-}
-
-
-void OPENGL_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
-{
-    std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
-
-    // Start from the second point
-    for( it++; it != aPointList.end(); it++ )
-    {
-        const VECTOR2D startEndVector = ( *it - *( it - 1 ) );
-        double lineAngle = startEndVector.Angle();
-
-        drawLineQuad( *( it - 1 ), *it );
-
-        // There is no need to draw line caps on both ends of polyline's segments
-        drawFilledSemiCircle( *( it - 1 ), lineWidth / 2, lineAngle + M_PI / 2 );
-    }
-
-    // ..and now - draw the ending cap
-    const VECTOR2D startEndVector = ( *( it - 1 ) - *( it - 2 ) );
-    double lineAngle = startEndVector.Angle();
-    drawFilledSemiCircle( *( it - 1 ), lineWidth / 2, lineAngle - M_PI / 2 );
-}
-
-
-void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
-{
-    // Any non convex polygon needs to be tesselated
-    // for this purpose the GLU standard functions are used
-    currentManager->Shader( SHADER_NONE );
-    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-    TessParams params = { currentManager, tessIntersects };
-    gluTessBeginPolygon( tesselator, &params );
-    gluTessBeginContour( tesselator );
-
-    boost::shared_array<GLdouble> points( new GLdouble[3 * aPointList.size()] );
-    int v = 0;
-    for( std::deque<VECTOR2D>::const_iterator it = aPointList.begin(); it != aPointList.end(); it++ )
-    {
-        points[v]     = it->x;
-        points[v + 1] = it->y;
-        points[v + 2] = layerDepth;
-        gluTessVertex( tesselator, &points[v], &points[v] );
-        v += 3;
-    }
-
-    gluTessEndContour( tesselator );
-    gluTessEndPolygon( tesselator );
-
-    // Free allocated intersecting points
-    tessIntersects.clear();
-
-    // vertexList destroyed here
-}
-
-
-void OPENGL_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
-                            const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
-{
-    // FIXME The drawing quality needs to be improved
-    // FIXME Perhaps choose a quad/triangle strip instead?
-    // FIXME Brute force method, use a better (recursive?) algorithm
-
-    std::deque<VECTOR2D> pointList;
-
-    double t  = 0.0;
-    double dt = 1.0 / (double) CURVE_POINTS;
-
-    for( int i = 0; i <= CURVE_POINTS; i++ )
-    {
-        double omt  = 1.0 - t;
-        double omt2 = omt * omt;
-        double omt3 = omt * omt2;
-        double t2   = t * t;
-        double t3   = t * t2;
-
-        VECTOR2D vertex = omt3 * aStartPoint + 3.0 * t * omt2 * aControlPointA
-                          + 3.0 * t2 * omt * aControlPointB + t3 * aEndPoint;
-
-        pointList.push_back( vertex );
-
-        t += dt;
-    }
-
-    DrawPolyline( pointList );
-}
-
-
 void OPENGL_GAL::ResizeScreen( int aWidth, int aHeight )
 {
     screenSize = VECTOR2D( aWidth, aHeight );
@@ -589,15 +292,6 @@ void OPENGL_GAL::ClearScreen()
 }
 
 
-void OPENGL_GAL::SetStrokeColor( const COLOR4D& aColor )
-{
-    strokeColor = aColor;
-
-    // This is the default drawing color
-    currentManager->Color( aColor.r, aColor.g, aColor.b, aColor.a );
-}
-
-
 void OPENGL_GAL::Transform( MATRIX3x3D aTransformation )
 {
     GLdouble matrixData[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
@@ -616,36 +310,6 @@ void OPENGL_GAL::Transform( MATRIX3x3D aTransformation )
 }
 
 
-void OPENGL_GAL::Rotate( double aAngle )
-{
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-}
-
-
-void OPENGL_GAL::Translate( const VECTOR2D& aVector )
-{
-    currentManager->Translate( aVector.x, aVector.y, 0.0f );
-}
-
-
-void OPENGL_GAL::Scale( const VECTOR2D& aScale )
-{
-    currentManager->Scale( aScale.x, aScale.y, 0.0f );
-}
-
-
-void OPENGL_GAL::Save()
-{
-    currentManager->PushMatrix();
-}
-
-
-void OPENGL_GAL::Restore()
-{
-    currentManager->PopMatrix();
-}
-
-
 int OPENGL_GAL::BeginGroup()
 {
     isGrouping = true;
@@ -692,8 +356,38 @@ void OPENGL_GAL::DeleteGroup( int aGroupNumber )
 
 void OPENGL_GAL::ClearCache()
 {
-    groups.clear();
+    // Free the whole container first, so the groups do not return their chunks one by one
     cachedManager.Clear();
+    groups.clear();
+}
+
+
+GAL* OPENGL_GAL::GetCacheWorker( int aIndex )
+{
+    wxASSERT( aIndex >= 0 );
+
+    // Workers are created only once, so they keep their staging containers between recaches
+    while( (int) cacheWorkers.size() <= aIndex )
+        cacheWorkers.push_back( boost::shared_ptr<OPENGL_CACHE_WORKER>( new OPENGL_CACHE_WORKER ) );
+
+    return cacheWorkers[aIndex].get();
+}
+
+
+int OPENGL_GAL::MergeGroup( GAL* aWorker, int aWorkerGroup )
+{
+    OPENGL_CACHE_WORKER* worker = static_cast<OPENGL_CACHE_WORKER*>( aWorker );
+    const VERTEX_ITEM& staged = worker->GetGroup( aWorkerGroup );
+
+    // The staged vertices are final (transformed, colored & shaded), so they are copied as they are
+    int groupNumber = BeginGroup();
+
+    if( staged.GetSize() > 0 )
+        cachedManager.PutVertices( staged.GetVertices(), staged.GetSize() );
+
+    EndGroup();
+
+    return groupNumber;
 }
 
 
@@ -798,117 +492,6 @@ void OPENGL_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 }
 
 
-inline void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    VECTOR2D startEndVector = aEndPoint - aStartPoint;
-    double   lineLength     = startEndVector.EuclideanNorm();
-    double   scale          = 0.5 * lineWidth / lineLength;
-
-    if( lineLength <= 0.0 )
-        return;
-
-    // The perpendicular vector also needs transformations
-    glm::vec4 vector = currentManager->GetTransformation() *
-                       glm::vec4( -startEndVector.y * scale, startEndVector.x * scale, 0.0, 0.0 );
-
-    // Line width is maintained by the vertex shader
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v0
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v1
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v3
-
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v0
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v3
-
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v2
-}
-
-
-void OPENGL_GAL::drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle )
-{
-    if( isFillEnabled )
-    {
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-        drawFilledSemiCircle( aCenterPoint, aRadius, aAngle );
-    }
-
-    if( isStrokeEnabled )
-    {
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-        drawStrokedSemiCircle( aCenterPoint, aRadius, aAngle );
-    }
-}
-
-
-void OPENGL_GAL::drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
-                                       double aAngle )
-{
-    Save();
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, 0.0f );
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-
-    /* Draw a triangle that contains the semicircle, then shade it to leave only
-     * the semicircle. Parameters given to setShader are indices of the triangle's vertices
-     *  (if you want to understand more, check the vertex shader source [shader.vert]).
-     *  Shader uses this coordinates to determine if fragments are inside the semicircle or not.
-     *       v2
-     *       /\
-     *      /__\
-     *  v0 //__\\ v1
-     */
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 4.0f );
-    currentManager->Vertex( -aRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );     // v0
-
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 5.0f );
-    currentManager->Vertex( aRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );      // v1
-
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 6.0f );
-    currentManager->Vertex( 0.0f, aRadius * 2.0f, layerDepth );                     // v2
-
-    Restore();
-}
-
-
-void OPENGL_GAL::drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
-                                        double aAngle )
-{
-    double outerRadius = aRadius + ( lineWidth / 2 );
-
-    Save();
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, 0.0f );
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-
-    /* Draw a triangle that contains the semicircle, then shade it to leave only
-     * the semicircle. Parameters given to setShader are indices of the triangle's vertices
-     *  (if you want to understand more, check the vertex shader source [shader.vert]), the
-     *  radius and the line width. Shader uses this coordinates to determine if fragments are
-     *  inside the semicircle or not.
-     *       v2
-     *       /\
-     *      /__\
-     *  v0 //__\\ v1
-     */
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 4.0f, aRadius, lineWidth );
-    currentManager->Vertex( -outerRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );     // v0
-
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 5.0f, aRadius, lineWidth );
-    currentManager->Vertex( outerRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );      // v1
-
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 6.0f, aRadius, lineWidth );
-    currentManager->Vertex( 0.0f, outerRadius * 2.0f, layerDepth );                     // v2
-
-    Restore();
-}
-
-
 void OPENGL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
     PostPaint();
@@ -1013,61 +596,3 @@ unsigned int OPENGL_GAL::getNewGroupNumber()
 
     return groupCounter++;
 }
-
-
-// -------------------------------------
-// Callback functions for the tesselator
-// -------------------------------------
-
-// Compare Redbook Chapter 11
-void CALLBACK VertexCallback( GLvoid* aVertexPtr, void* aData )
-{
-    GLdouble* vertex = static_cast<GLdouble*>( aVertexPtr );
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
-    VERTEX_MANAGER* vboManager = param->vboManager;
-
-    if( vboManager )
-        vboManager->Vertex( vertex[0], vertex[1], vertex[2] );
-}
-
-
-void CALLBACK CombineCallback( GLdouble coords[3],
-                               GLdouble* vertex_data[4],
-                               GLfloat weight[4], GLdouble** dataOut, void* aData )
-{
-    GLdouble* vertex = new GLdouble[3];
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
-
-    // Save the pointer so we can delete it later
-    param->intersectPoints.push_back( boost::shared_array<GLdouble>( vertex ) );
-
-    memcpy( vertex, coords, 3 * sizeof(GLdouble) );
-
-    *dataOut = vertex;
-}
-
-
-void CALLBACK EdgeCallback( GLboolean aEdgeFlag )
-{
-    // This callback is needed to force GLU tesselator to use triangles only
-}
-
-
-void CALLBACK ErrorCallback( GLenum aErrorCode )
-{
-    const GLubyte* eString = gluErrorString( aErrorCode );
-
-    DisplayError( NULL, wxT( "Tessellation error: " ) +
-                        wxString( (const char*)( eString ), wxConvUTF8 ) );
-
-    exit( 1 );
-}
-
-
-void InitTesselatorCallbacks( GLUtesselator* aTesselator )
-{
-    gluTessCallback( aTesselator, GLU_TESS_VERTEX_DATA,  ( void (CALLBACK*)() )VertexCallback );
-    gluTessCallback( aTesselator, GLU_TESS_COMBINE_DATA, ( void (CALLBACK*)() )CombineCallback );
-    gluTessCallback( aTesselator, GLU_TESS_EDGE_FLAG,    ( void (CALLBACK*)() )EdgeCallback );
-    gluTessCallback( aTesselator, GLU_TESS_ERROR,        ( void (CALLBACK*)() )ErrorCallback );
-}
@@ -35,12 +35,14 @@
 #include <gal/opengl/vertex_item.h>
 #include <confirm.h>
 
+#include <cstring>
+
 using namespace KIGFX;
 
-VERTEX_MANAGER::VERTEX_MANAGER( bool aCached ) :
+VERTEX_MANAGER::VERTEX_MANAGER( bool aCached, unsigned int aInitialSize ) :
     m_noTransform( true ), m_transform( 1.0f )
 {
-    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached ) );
+    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached, aInitialSize ) );
     m_gpu.reset( GPU_MANAGER::MakeManager( m_container.get() ) );
 
     // There is no shader used by default
@@ -83,6 +85,22 @@ void VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize ) co
 }
 
 
+void VERTEX_MANAGER::PutVertices( const VERTEX aVertices[], unsigned int aSize ) const
+{
+    // Obtain pointer to the vertex in currently used container
+    VERTEX* newVertex = m_container->Allocate( aSize );
+
+    if( newVertex == NULL )
+    {
+        DisplayError( NULL, wxT( "Vertex allocation error" ) );
+        return;
+    }
+
+    // The vertices are complete already, there is nothing to be applied
+    memcpy( newVertex, aVertices, aSize * VertexSize );
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -161,6 +179,8 @@ void VERTEX_MANAGER::Clear() const
 
 void VERTEX_MANAGER::BeginDrawing() const
 {
+    // Items may be moved only before the offsets of the drawn ones are used
+    m_container->Compact();
     m_gpu->BeginDrawing();
 }
 
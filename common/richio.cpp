@@ -25,6 +25,14 @@
 
 
 #include <cstdarg>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include <richio.h>
 
@@ -259,6 +267,174 @@ char* FILE_LINE_READER::ReadLine() throw( IO_ERROR )
 }
 
 
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber,
+            unsigned aMaxLineLength ) throw( IO_ERROR ) :
+    LINE_READER( aMaxLineLength ),
+    data( NULL ),
+    size( 0 ),
+    ndx( 0 ),
+    isMapped( false ),
+    hasTail( false ),
+    patched( NULL ),
+    patchedChar( 0 )
+{
+    buffer  = line;
+    source  = aFileName;
+    lineNum = aStartingLineNumber;
+
+    wxString msg = wxString::Format(
+        _( "Unable to open filename '%s' for reading" ), aFileName.GetData() );
+
+#ifndef _WIN32
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd < 0 )
+        THROW_IO_ERROR( msg );
+
+    struct stat status;
+
+    if( fstat( fd, &status ) != 0 )
+    {
+        close( fd );
+        THROW_IO_ERROR( msg );
+    }
+
+    size = status.st_size;
+
+    // An empty file cannot be mapped, but has no line anyway
+    if( size )
+    {
+        void* mapping = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+        if( mapping == MAP_FAILED )
+        {
+            close( fd );
+            THROW_IO_ERROR( msg );
+        }
+
+        data     = (char*) mapping;
+        isMapped = true;
+
+        // The end of the last page of the mapping is also mapped, and can hold the nul
+        hasTail  = ( size % sysconf( _SC_PAGESIZE ) ) != 0;
+
+        madvise( mapping, size, MADV_SEQUENTIAL );
+    }
+
+    close( fd );
+#else
+    FILE* fp = wxFopen( aFileName, wxT( "rt" ) );
+
+    if( !fp )
+        THROW_IO_ERROR( msg );
+
+    fseek( fp, 0, SEEK_END );
+    long fileSize = ftell( fp );
+    rewind( fp );
+
+    data = new char[ fileSize + 1 ];
+
+    // In text mode, the count of bytes read can be smaller than the file size
+    size    = fread( data, 1, fileSize, fp );
+    hasTail = true;
+
+    fclose( fp );
+#endif
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+#ifndef _WIN32
+    if( isMapped )
+        munmap( data, size );
+#endif
+
+    if( !isMapped )
+        delete[] data;
+
+    // ~LINE_READER() frees its own buffer, not a line in data
+    line = buffer;
+}
+
+
+void MAPPED_FILE_LINE_READER::restorePatch()
+{
+    if( patched )
+    {
+        *patched = patchedChar;
+        patched  = NULL;
+    }
+}
+
+
+void MAPPED_FILE_LINE_READER::Rewind()
+{
+    restorePatch();
+
+    line    = buffer;
+    line[0] = 0;
+    length  = 0;
+    ndx     = 0;
+    lineNum = 0;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine() throw( IO_ERROR )
+{
+    restorePatch();
+
+    line   = buffer;
+    length = 0;
+
+    // lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++lineNum;
+
+    if( ndx >= size )
+    {
+        line[0] = 0;
+        return NULL;
+    }
+
+    char*   begin = data + ndx;
+    char*   nl    = (char*) memchr( begin, '\n', size - ndx );
+    size_t  len   = nl ? nl - begin + 1 : size - ndx;  // include the newline
+
+    if( len >= maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    ndx += len;
+
+    if( ndx < size || hasTail )
+    {
+        // Terminate the line in place
+        patched     = data + ndx;
+        patchedChar = *patched;
+        *patched    = 0;
+
+        line = begin;
+    }
+    else
+    {
+        // Unterminated last line ending exactly at a page boundary: copy it
+        if( len + 1 > capacity )
+        {
+            expandCapacity( len + 1 );
+            buffer = line;
+        }
+
+        memcpy( line, begin, len );
+        line[len] = 0;
+    }
+
+    length = len;
+
+    return line;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     lines( aString ),
@@ -540,6 +716,9 @@ void STRING_FORMATTER::StripUseless()
 
 //-----<FILE_OUTPUTFORMATTER>----------------------------------------
 
+#define FILE_OUTPUTFORMATTER_BUFSIZE    ( 1024 * 1024 )
+
+
 FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
         const wxChar* aMode,  char aQuoteChar ) throw( IO_ERROR ) :
     OUTPUTFORMATTER( OUTPUTFMTBUFZ, aQuoteChar ),
@@ -554,6 +733,10 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
                             m_filename.GetData() );
         THROW_IO_ERROR( msg );
     }
+
+    // Fewer system calls for the large files, as board files can be
+    m_fileBuffer.resize( FILE_OUTPUTFORMATTER_BUFSIZE );
+    setvbuf( m_fp, &m_fileBuffer[0], _IOFBF, m_fileBuffer.size() );
 }
 
 
@@ -22,6 +22,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <map>
 #include <boost/foreach.hpp>
 
 #include <base_struct.h>
@@ -38,6 +39,10 @@
 #include <profile.h>
 #endif /* PROFILE  */
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 using namespace KIGFX;
 
 VIEW::VIEW( bool aIsDynamic ) :
@@ -85,6 +90,7 @@ void VIEW::AddLayer( int aLayer, bool aDisplayOnly )
         m_layers[aLayer].enabled        = true;
         m_layers[aLayer].displayOnly    = aDisplayOnly;
         m_layers[aLayer].target         = TARGET_CACHED;
+        m_layers[aLayer].minSize        = 0.0;
     }
 
     sortLayers();
@@ -110,6 +116,46 @@ void VIEW::Add( VIEW_ITEM* aItem )
 }
 
 
+void VIEW::Add( const std::vector<VIEW_ITEM*>& aItems )
+{
+#ifdef PROFILE
+    prof_counter totalRealTime;
+    prof_start( &totalRealTime );
+#endif /* PROFILE */
+
+    std::map<int, std::vector<VIEW_ITEM*> > layerItems;
+
+    BOOST_FOREACH( VIEW_ITEM* item, aItems )
+    {
+        int layers[VIEW_MAX_LAYERS], layers_count;
+
+        item->ViewGetLayers( layers, layers_count );
+        item->saveLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; i++ )
+            layerItems[layers[i]].push_back( item );
+
+        if( m_dynamic )
+            item->viewAssign( this );
+    }
+
+    for( std::map<int, std::vector<VIEW_ITEM*> >::const_iterator it = layerItems.begin();
+         it != layerItems.end(); ++it )
+    {
+        VIEW_LAYER& l = m_layers[it->first];
+        l.items->BulkLoad( it->second );
+        MarkTargetDirty( l.target );
+    }
+
+#ifdef PROFILE
+    prof_end( &totalRealTime );
+
+    wxLogDebug( wxT( "Add: %u items, %.1f ms" ), (unsigned int) aItems.size(),
+                totalRealTime.msecs() );
+#endif /* PROFILE */
+}
+
+
 void VIEW::Remove( VIEW_ITEM* aItem )
 {
     if( m_dynamic )
@@ -579,8 +625,11 @@ void VIEW::UpdateAllLayersOrder()
 struct VIEW::drawItem
 {
     drawItem( VIEW* aView, const VIEW_LAYER* aCurrentLayer ) :
-        currentLayer( aCurrentLayer ), view( aView )
+        currentLayer( aCurrentLayer ), view( aView ), minSize( 0.0 )
     {
+        // The minimal size of items is converted to world units once for all the items
+        if( currentLayer->minSize > 0.0 )
+            minSize = currentLayer->minSize / std::abs( view->ToScreen( 1.0, false ) );
     }
 
     bool operator()( VIEW_ITEM* aItem )
@@ -591,6 +640,10 @@ struct VIEW::drawItem
         if( !drawCondition )
             return true;
 
+        // Items too small to be seen are not worth their vertices
+        if( minSize > 0.0 && aItem->ViewGetDetailSize( currentLayer->id ) < minSize )
+            return true;
+
         view->draw( aItem, currentLayer->id );
 
         return true;
@@ -598,6 +651,7 @@ struct VIEW::drawItem
 
     const VIEW_LAYER* currentLayer;
     VIEW* view;
+    double minSize;     ///< minimal size of the drawn items, in world units
     int layersCount, layers[VIEW_MAX_LAYERS];
 };
 
@@ -704,16 +758,18 @@ struct VIEW::recacheItem
     recacheItem( VIEW* aView, GAL* aGal, int aLayer, bool aImmediately ) :
         view( aView ), gal( aGal ), layer( aLayer ), immediately( aImmediately )
     {
+#ifdef PROFILE
+        count = 0;
+#endif /* PROFILE */
     }
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        // Remove previously cached group
-        int prevGroup = aItem->getGroup( layer );
-
-        if( prevGroup >= 0 )
-            gal->DeleteGroup( prevGroup );
+#ifdef PROFILE
+        ++count;
+#endif /* PROFILE */
 
+        // The previously cached groups were all freed at once by RecacheAllItems()
         if( immediately )
         {
             int group = gal->BeginGroup();
@@ -736,6 +792,28 @@ struct VIEW::recacheItem
     GAL* gal;
     int layer;
     bool immediately;
+
+#ifdef PROFILE
+    unsigned int count;
+#endif /* PROFILE */
+};
+
+
+struct VIEW::collectItems
+{
+    collectItems( std::vector<VIEW_ITEM*>& aItems ) :
+        items( aItems )
+    {
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        items.push_back( aItem );
+
+        return true;
+    }
+
+    std::vector<VIEW_ITEM*>& items;
 };
 
 
@@ -996,10 +1074,56 @@ void VIEW::RecacheAllItems( bool aImmediately )
     r.SetMaximum();
 
 #ifdef PROFILE
-    prof_counter totalRealTime;
+    prof_counter totalRealTime, clearRealTime;
     prof_start( &totalRealTime );
+    prof_start( &clearRealTime );
 #endif /* PROFILE */
 
+    // Every cached group is replaced below, so they are all freed at once.  Deleting them
+    // item by item returns each chunk to the free list of the vertex container, which
+    // shrinks and defragments itself again and again while it empties.
+    m_gal->ClearCache();
+
+#ifdef PROFILE
+    prof_end( &clearRealTime );
+    unsigned int itemsCount = 0;
+#endif /* PROFILE */
+
+    // The GAL holds the drawing state (colors, line widths, layer depth) and is bound to
+    // a single rendering context, so other threads draw the items using cache workers
+    // of the GAL, each one with its own painter.  GALs & painters that cannot be shared
+    // out have the items drawn on this thread.
+    std::vector<GAL*> workers;
+    std::vector<PAINTER*> painters;
+
+#ifdef USE_OPENMP
+    int threads = omp_get_max_threads();
+
+    if( aImmediately && threads > 1 )
+    {
+        for( int t = 0; t < threads; ++t )
+        {
+            GAL* worker = m_gal->GetCacheWorker( t );
+            PAINTER* painter = worker ? m_painter->Clone( worker ) : NULL;
+
+            if( painter == NULL )
+                break;
+
+            workers.push_back( worker );
+            painters.push_back( painter );
+        }
+
+        if( (int) painters.size() < threads )
+        {
+            for( unsigned int t = 0; t < painters.size(); ++t )
+                delete painters[t];
+
+            workers.clear();
+            painters.clear();
+        }
+    }
+#endif /* USE_OPENMP */
+
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
     {
         VIEW_LAYER* l = &( ( *i ).second );
@@ -1008,21 +1132,109 @@ void VIEW::RecacheAllItems( bool aImmediately )
         {
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            recacheItem visitor( this, m_gal, l->id, aImmediately );
-            l->items->Query( r, visitor );
+
+#ifdef USE_OPENMP
+            if( !painters.empty() )
+            {
+                std::vector<VIEW_ITEM*> items;
+                collectItems collector( items );
+                l->items->Query( r, collector );
+                recacheLayerParallel( l, items, workers, painters );
+
+#ifdef PROFILE
+                itemsCount += items.size();
+#endif /* PROFILE */
+            }
+            else
+#endif /* USE_OPENMP */
+            {
+                recacheItem visitor( this, m_gal, l->id, aImmediately );
+                l->items->Query( r, visitor );
+
+#ifdef PROFILE
+                itemsCount += visitor.count;
+#endif /* PROFILE */
+            }
+
             MarkTargetDirty( l->target );
         }
     }
 
+    for( unsigned int t = 0; t < painters.size(); ++t )
+        delete painters[t];
+
 #ifdef PROFILE
     prof_end( &totalRealTime );
 
-    wxLogDebug( wxT( "RecacheAllItems::immediately: %u %.1f ms" ),
-                aImmediately, totalRealTime.msecs() );
+    // The times by board size: the number of items drawn is the sum over the cached layers
+    wxLogDebug( wxT( "RecacheAllItems::immediately: %u, %u items, clear %.1f ms, total %.1f ms" ),
+                aImmediately, itemsCount, clearRealTime.msecs(), totalRealTime.msecs() );
 #endif /* PROFILE */
 }
 
 
+#ifdef USE_OPENMP
+void VIEW::recacheLayerParallel( VIEW_LAYER* aLayer, const std::vector<VIEW_ITEM*>& aItems,
+                                 const std::vector<GAL*>& aWorkers,
+                                 const std::vector<PAINTER*>& aPainters )
+{
+    int layer = aLayer->id;
+    int count = aItems.size();
+
+    // Group numbers in the workers, -1 for items that the painters cannot draw
+    std::vector<int> groups( count, -1 );
+    std::vector<int> owners( count, 0 );
+
+    for( unsigned int t = 0; t < aWorkers.size(); ++t )
+        aWorkers[t]->SetLayerDepth( aLayer->renderingOrder );
+
+    // Turn the items into vertices, it is the most time consuming part of recaching
+    #pragma omp parallel
+    {
+        int t = omp_get_thread_num();
+        GAL* worker = aWorkers[t];
+        PAINTER* painter = aPainters[t];
+
+        #pragma omp for schedule(dynamic, 64)
+        for( int i = 0; i < count; ++i )
+        {
+            int group = worker->BeginGroup();
+
+            if( painter->Draw( aItems[i], layer ) )
+            {
+                groups[i] = group;
+                owners[i] = t;
+            }
+
+            worker->EndGroup();
+        }
+    }
+
+    // Copy the groups in the order of items, as they would be cached by a single thread
+    for( int i = 0; i < count; ++i )
+    {
+        VIEW_ITEM* item = aItems[i];
+
+        if( groups[i] >= 0 )
+        {
+            item->setGroup( layer, m_gal->MergeGroup( aWorkers[owners[i]], groups[i] ) );
+        }
+        else
+        {
+            // Alternative drawing method, it may use any GAL so it is done on this thread
+            int group = m_gal->BeginGroup();
+            item->setGroup( layer, group );
+            item->ViewDraw( layer, m_gal );
+            m_gal->EndGroup();
+        }
+    }
+
+    for( unsigned int t = 0; t < aWorkers.size(); ++t )
+        aWorkers[t]->ClearCache();
+}
+#endif /* USE_OPENMP */
+
+
 bool VIEW::IsTargetDirty( int aTarget ) const
 {
     wxASSERT( aTarget < TARGETS_NUMBER );
@@ -41,6 +41,8 @@
 #include <fp_lib_table.h>
 #include <netlist_reader.h>
 
+#include <wx/progdlg.h>
+
 #include <cvpcb_mainframe.h>
 #include <cvpcb.h>
 #include <cvstruct.h>
@@ -760,7 +762,15 @@ bool CVPCB_MAINFRAME::LoadFootprintFiles()
         return false;
     }
 
-    m_footprints.ReadFootprintFiles( fptbl );
+    // Loading all the libraries may be long: show the progress, and allow to abort it.
+    unsigned libraryCount = fptbl->GetLogicalLibs().size();
+
+    wxProgressDialog progressDialog( _( "Load Footprint Libraries" ),
+                                     wxString::Format( _( "%u of %u libraries loaded" ),
+                                                       0u, libraryCount ),
+                                     100, this, wxPD_AUTO_HIDE | wxPD_CAN_ABORT );
+
+    m_footprints.ReadFootprintFiles( fptbl, NULL, &progressDialog );
 
     if( m_footprints.GetErrorCount() )
     {
@@ -286,6 +286,19 @@ public:
      */
     static std::string FormatInternalUnits( int aValue );
 
+    /**
+     * Function FormatInternalUnits
+     * converts \a aValue like the function above, into \a aBuffer, with no allocation.
+     * Used when saving a board, for the very many coordinates of tracks and zones.
+     *
+     * @param aBuffer receives the nul terminated text, and must hold at least
+     *  FORMAT_IU_MAX_LEN chars.
+     * @return int - the length of the text.
+     */
+    static int FormatInternalUnits( int aValue, char* aBuffer );
+
+#define FORMAT_IU_MAX_LEN   50
+
     /**
      * Function FormatAngle
      * converts \a aAngle from board units to a string appropriate for writing to file.
@@ -0,0 +1,87 @@
+/**
+ * @file decimal_parser.h
+ * @brief Locale independent conversion of decimal numbers read from and written to files.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DECIMAL_PARSER_H
+#define DECIMAL_PARSER_H
+
+// These functions do not depend on wxWidgets, so the test programs in tools/ can
+// use them alone.  The decimal separator is always '.', whatever the locale.
+
+
+/**
+ * Function ParseDecimalInt
+ * converts the text [@a aStart, @a aEnd) to an int.  The text is an optional sign
+ * followed by decimal digits.
+ *
+ * @return false if the text is not such a number or does not fit in an int.
+ */
+bool ParseDecimalInt( const char* aStart, const char* aEnd, int* aResult );
+
+/**
+ * Function ParseDecimalDouble
+ * converts the text [@a aStart, @a aEnd) to a double.  The text is an optional sign,
+ * decimal digits with an optional '.', and an optional exponent.
+ * <p>
+ * Only the numbers which can be converted exactly with one floating point operation
+ * are handled (up to 15 significant digits and a decimal exponent between -22 and 22,
+ * which covers the numbers written by KiCad).  The result is then the same as the
+ * result of strtod() in the C locale.
+ * </p>
+ * @return false if the text is not such a number: the caller must use strtod().
+ */
+bool ParseDecimalDouble( const char* aStart, const char* aEnd, double* aResult );
+
+/**
+ * Function ParseMillimetresToNanometres
+ * converts the text [@a aStart, @a aEnd), a number of millimetres in fixed point
+ * format (an optional sign, digits, an optional '.' and digits), to an int number of
+ * nanometres.  The conversion is done on the decimal digits, so the result is the
+ * exact value rounded to the nearest nanometre, halfway cases away from zero.
+ * Any value written by the board file formatter is read back without change.
+ *
+ * @return false if the text is not in this format (for instance, it has an exponent),
+ * or if the result does not fit in an int.
+ */
+bool ParseMillimetresToNanometres( const char* aStart, const char* aEnd, int* aResult );
+
+/**
+ * Function FormatNanometresAsMillimetres
+ * writes @a aValue, a number of nanometres, as a number of millimetres in fixed point
+ * format, without trailing zeros in the fractional part, and without '.' if there is
+ * no fractional part.  This is the text printf( "%.10g" ) gives for the values of more
+ * than 100 nm.  The conversion is done with integer arithmetic.
+ *
+ * @param aBuffer receives the nul terminated text, and must hold at least
+ *  FORMAT_MILLIMETRES_MAX_LEN chars.
+ * @return int - the length of the text.
+ */
+int FormatNanometresAsMillimetres( int aValue, char* aBuffer );
+
+#define FORMAT_MILLIMETRES_MAX_LEN  20
+
+#endif  // DECIMAL_PARSER_H
@@ -43,6 +43,7 @@ protected:
     EDA_ITEM*     first;          ///< first element in list, or NULL if list empty
     EDA_ITEM*     last;           ///< last elment in list, or NULL if empty
     unsigned      count;          ///< how many elements are in the list, automatically maintained.
+    unsigned      changeCount;    ///< incremented each time an element is added or removed
     bool          meOwner;        ///< I must delete the objects I hold in my destructor
 
     /**
@@ -54,6 +55,7 @@ protected:
         first(0),
         last(0),
         count(0),
+        changeCount(0),
         meOwner(true)
     {
     }
@@ -125,6 +127,14 @@ public:
      */
     unsigned GetCount() const { return count; }
 
+    /**
+     * Function GetChangeCount
+     * returns a number which changes each time an element is added to or removed
+     * from the list, so a cache built from the list content can check cheaply
+     * that it is still up to date.
+     */
+    unsigned GetChangeCount() const { return changeCount; }
+
 #if defined(DEBUG)
     void VerifyListIntegrity();
 #endif
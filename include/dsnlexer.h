@@ -478,7 +478,7 @@ public:
      */
     wxString FromUTF8()
     {
-        return wxString::FromUTF8( curText.c_str() );
+        return wxString::FromUTF8( curText.c_str(), curText.size() );
     }
 
     /**
@@ -30,11 +30,14 @@
 #define FOOTPRINT_INFO_H_
 
 
+#include <vector>
+
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/foreach.hpp>
 
 #include <ki_mutex.h>
 #include <kicad_string.h>
+#include <io_mgr.h>             // FOOTPRINT_HEADER
 
 
 #define USE_FPI_LAZY            0   // 1:yes lazy,  0:no early
@@ -43,12 +46,13 @@
 class FP_LIB_TABLE;
 class FOOTPRINT_LIST;
 class wxTopLevelWindow;
+class wxProgressDialog;
 
 
 /*
  * Class FOOTPRINT_INFO
  * is a helper class to handle the list of footprints available in libraries. It stores
- * footprint names, doc and keywords
+ * footprint names and the FOOTPRINT_HEADER of the footprint, not the footprint itself.
  */
 class FOOTPRINT_INFO
 {
@@ -67,8 +71,7 @@ public:
         m_loaded( false ),
         m_nickname( aNickname ),
         m_fpname( aFootprintName ),
-        m_num( 0 ),
-        m_pad_count( 0 )
+        m_num( 0 )
     {
 #if !USE_FPI_LAZY
         load();
@@ -78,19 +81,33 @@ public:
     const wxString& GetDoc()
     {
         ensure_loaded();
-        return m_doc;
+        return m_header.m_description;
     }
 
     const wxString& GetKeywords()
     {
         ensure_loaded();
-        return m_keywords;
+        return m_header.m_keywords;
     }
 
     unsigned GetPadCount()
     {
         ensure_loaded();
-        return m_pad_count;
+        return m_header.m_padCount;
+    }
+
+    /// @return the area of the pads and drawings of the footprint, in footprint coordinates.
+    const EDA_RECT& GetBoundingBox()
+    {
+        ensure_loaded();
+        return m_header.m_boundingBox;
+    }
+
+    /// @return the layers of the footprint, its pads and its drawings.
+    LAYER_MSK GetLayers()
+    {
+        ensure_loaded();
+        return m_header.m_layers;
     }
 
     int GetOrderNum()
@@ -128,9 +145,8 @@ private:
     wxString    m_nickname;     ///< library as known in FP_LIB_TABLE
     wxString    m_fpname;       ///< Module name.
     int         m_num;          ///< Order number in the display list.
-    int         m_pad_count;    ///< Number of pads
-    wxString    m_doc;          ///< Footprint description.
-    wxString    m_keywords;     ///< Footprint keywords.
+
+    FOOTPRINT_HEADER m_header;  ///< Footprint description, keywords, pad count...
 };
 
 
@@ -165,15 +181,25 @@ class FOOTPRINT_LIST
     MUTEX   m_errors_lock;
     MUTEX   m_list_lock;
 
+    std::vector< wxString > m_nicknames;    ///< the libraries to load
+    unsigned            m_next_nickname;    ///< next library of the queue, under m_queue_lock
+    volatile unsigned   m_done_count;       ///< libraries loaded, thread safe to read.
+    volatile bool       m_cancel;           ///< stops handing out the libraries
+    MUTEX               m_queue_lock;
+
+    /**
+     * Function nextLibrary
+     * takes the next library of the queue.
+     * @return false if the queue is empty or the load was cancelled.
+     */
+    bool nextLibrary( wxString* aNickname );
+
     /**
      * Function loader_job
-     * loads footprints from @a aNicknameList and calls AddItem() on to help fill
-     * m_list.
-     *
-     * @param aNicknameList is a wxString[] holding libraries to load all footprints from.
-     * @param aJobZ is the size of the job, i.e. the count of nicknames.
+     * loads footprints from the libraries taken from the queue one at a time, until
+     * it is empty or the load is cancelled, and calls AddItem() on to help fill m_list.
      */
-    void loader_job( const wxString* aNicknameList, int aJobZ );
+    void loader_job();
 
     void addItem( FOOTPRINT_INFO* aItem )
     {
@@ -189,7 +215,10 @@ public:
 
     FOOTPRINT_LIST() :
         m_lib_table( 0 ),
-        m_error_count( 0 )
+        m_error_count( 0 ),
+        m_next_nickname( 0 ),
+        m_done_count( 0 ),
+        m_cancel( false )
     {
     }
 
@@ -234,11 +263,21 @@ public:
      * @param aTable defines all the libraries.
      * @param aNickname is the library to read from, or if NULL means read all
      *         footprints from all known libraries in aTable.
-     * @return bool - true if it ran to completion, else false if it aborted after
-     *  some number of errors.  If true, it does not mean there were no errors, check
-     *  GetErrorCount() for that, should be zero to indicate success.
+     * @param aProgress is an optional progress dialog with a range of 100, updated with
+     *         the libraries loaded.  The load is cancelled if the user aborts it.
+     * @return bool - true if it ran to completion, else false if it was cancelled.
+     *  If true, it does not mean there were no errors, check GetErrorCount() for that,
+     *  should be zero to indicate success.
+     */
+    bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = NULL,
+                             wxProgressDialog* aProgress = NULL );
+
+    /**
+     * Function Cancel
+     * stops ReadFootprintFiles() once the libraries being loaded are done.  It may be
+     * called from any thread.
      */
-    bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = NULL );
+    void Cancel()                   { m_cancel = true; }
 
     void DisplayErrors( wxTopLevelWindow* aCaller = NULL );
 
@@ -42,6 +42,7 @@ class FPID;
 class NETLIST;
 class REPORTER;
 class SEARCH_STACK;
+struct FOOTPRINT_HEADER;
 
 /**
  * Class FP_LIB_TABLE
@@ -398,6 +399,25 @@ public:
      */
     MODULE* FootprintLoad( const wxString& aNickname, const wxString& aFootprintName );
 
+    /**
+     * Function FootprintLoadHeader
+     * reads the FOOTPRINT_HEADER of footprint @a aFootprintName in the library given by
+     * @a aNickname, without loading the footprint when the library plugin has an index.
+     *
+     * @param aNickname is a locator for the "library", it is a "name"
+     *     in FP_LIB_TABLE::ROW
+     *
+     * @param aFootprintName is the name of the footprint.
+     *
+     * @param aHeader receives the header of the footprint.
+     *
+     * @return  bool - true if found, else false.
+     *
+     * @throw   IO_ERROR if the library cannot be found or read.
+     */
+    bool FootprintLoadHeader( const wxString& aNickname, const wxString& aFootprintName,
+                              FOOTPRINT_HEADER* aHeader );
+
     /**
      * Enum SAVE_T
      * is the set of return values from FootprintSave() below.
@@ -83,6 +83,38 @@ public:
         cairo_get_matrix( m_mainContext, &m_matrix );
     }
 
+    /**
+     * Function BeginTiles()
+     * prepares the current buffer to be drawn in tiles: the drawing done so far with its
+     * context is finished, so the tiles can draw over it.
+     */
+    virtual void BeginTiles();
+
+    /**
+     * Function EndTiles()
+     * tells the current buffer that its pixels were changed by the tiles.
+     */
+    virtual void EndTiles();
+
+    /**
+     * Function CreateTileContext()
+     * creates a context which draws to a rectangle of the current buffer, with its own
+     * surface sharing the buffer pixels, so the tiles of a buffer can be drawn by several
+     * threads at once.  It may be called from any thread between BeginTiles() and EndTiles().
+     *
+     * @param aX, aY, aWidth, aHeight is the tile rectangle, in pixels.
+     * @param aMatrix is the world to screen transformation of the whole buffer.
+     * @return the tile context, to be destroyed with DestroyTileContext().
+     */
+    virtual cairo_t* CreateTileContext( int aX, int aY, int aWidth, int aHeight,
+                                        const cairo_matrix_t& aMatrix );
+
+    /**
+     * Function DestroyTileContext()
+     * frees a context created by CreateTileContext().
+     */
+    virtual void DestroyTileContext( cairo_t* aTileContext );
+
 protected:
     typedef boost::shared_array<unsigned int> BitmapPtr;
     typedef struct
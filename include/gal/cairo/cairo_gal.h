@@ -28,6 +28,7 @@
 #define CAIROGAL_H_
 
 #include <map>
+#include <vector>
 #include <iterator>
 
 #include <cairo.h>
@@ -256,6 +257,24 @@ public:
         paintListener = aPaintListener;
     }
 
+    /**
+     * Function SetTiledRendering()
+     * enables drawing the cached groups in tiles.  The groups drawn one after another are
+     * queued instead of being drawn, and the queue is replayed on each horizontal tile of
+     * the screen, in parallel, when something else has to be drawn.  It is enabled by default
+     * when there are several processors.
+     */
+    void SetTiledRendering( bool aEnabled );
+
+    /**
+     * Function GetTiledRendering()
+     * @return true if the cached groups are drawn in tiles.
+     */
+    bool GetTiledRendering() const
+    {
+        return isTiled;
+    }
+
 protected:
     virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
 
@@ -326,6 +345,19 @@ private:
     unsigned int                groupCounter;       ///< Counter used for generating keys for groups
     GROUP*                      currentGroup;       ///< Currently used group
 
+    /// State changed by the commands of the groups
+    typedef struct
+    {
+        bool        isFillEnabled;
+        bool        isStrokeEnabled;
+        COLOR4D     fillColor;
+        COLOR4D     strokeColor;
+    } REPLAY_STATE;
+
+    // Variables for the tiled rendering
+    bool                        isTiled;            ///< Are the groups drawn in tiles ?
+    std::vector<int>            tileQueue;          ///< Groups to draw in tiles, and layer changes
+
     // Variables related to Cairo <-> wxWidgets
     cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
     cairo_t*            currentContext;         ///< Currently used Cairo context for drawing
@@ -339,6 +371,21 @@ private:
     // Methods
     void storePath();                           ///< Store the actual path
 
+    /**
+     * @brief Executes the commands of a group.
+     *
+     * @param aContext is the context to draw on.
+     * @param aGroupNumber is the group to execute.
+     * @param aState is the state to update with the commands.
+     */
+    void replayGroup( cairo_t* aContext, int aGroupNumber, REPLAY_STATE& aState ) const;
+
+    /**
+     * @brief Draws the queued groups on all the tiles of the current buffer, and empties
+     * the queue.  Must be called before anything else is drawn.
+     */
+    void drawTiles();
+
     // Event handlers
     /**
      * @brief Paint event handler.
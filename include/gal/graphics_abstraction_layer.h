@@ -416,6 +416,33 @@ public:
      */
     virtual void ClearCache() = 0;
 
+    /**
+     * @brief Get a GAL that draws groups on an other thread.
+     *
+     * The worker only turns the drawn shapes into its own groups, which are later merged into
+     * this GAL with MergeGroup(). Every thread needs its own worker; the workers have to be
+     * obtained on the thread that owns this GAL.
+     *
+     * @param aIndex is the number of the worker.
+     * @return the worker or NULL if the groups cannot be drawn on other threads.
+     */
+    virtual GAL* GetCacheWorker( int aIndex )
+    {
+        return NULL;
+    }
+
+    /**
+     * @brief Copy a group drawn by a worker into a new group of this GAL.
+     *
+     * @param aWorker is the worker returned by GetCacheWorker().
+     * @param aWorkerGroup is the number of the group returned by the worker BeginGroup().
+     * @return the number of the new group or -1 if it could not be created.
+     */
+    virtual int MergeGroup( GAL* aWorker, int aWorkerGroup )
+    {
+        return -1;
+    }
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
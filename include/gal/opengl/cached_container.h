@@ -72,20 +72,99 @@ public:
      */
     virtual VERTEX* GetVertices( const VERTEX_ITEM* aItem ) const;
 
+    /**
+     * Function Compact()
+     * moves the items stored after the free chunks towards the beginning of the container, at
+     * most GetCompactionLimit() vertices per call, so the free space gathers at its end.
+     * An item bigger than the limit is moved alone, by a call which moves nothing else.
+     */
+    virtual void Compact();
+
+    /**
+     * Function SetCompactionLimit()
+     * sets the number of vertices Compact() may move at once.  With a limit of 0 there is no
+     * incremental compaction: the whole container is defragmented when no free chunk is big
+     * enough for an item.  Otherwise the container grows instead, and Compact() does the job
+     * a bit at a time.
+     *
+     * @param aMaxVertices is the number of vertices.
+     */
+    void SetCompactionLimit( unsigned int aMaxVertices )
+    {
+        m_compactionLimit = aMaxVertices;
+    }
+
+    unsigned int GetCompactionLimit() const
+    {
+        return m_compactionLimit;
+    }
+
+    ///> Statistics of the memory use, to watch the fragmentation of the container
+    struct STATISTICS
+    {
+        unsigned int        containerSize;          ///< vertices the container can hold
+        unsigned int        freeSpace;              ///< vertices not used by any item
+        unsigned int        freeChunks;             ///< number of free chunks
+        unsigned int        largestFreeChunk;       ///< vertices of the largest free chunk
+        unsigned int        resizes;                ///< container resizes so far
+        unsigned int        defragmentations;       ///< full defragmentations so far
+        unsigned long long  defragmentedVertices;   ///< vertices moved by them
+        unsigned int        compactions;            ///< calls of Compact() which moved items
+        unsigned long long  compactedVertices;      ///< vertices moved by them
+
+        /**
+         * Function Fragmentation()
+         * @return 0 if the free space is contiguous, and towards 1 as it gets split in
+         * small chunks.
+         */
+        double Fragmentation() const
+        {
+            return freeSpace ? 1.0 - (double) largestFreeChunk / freeSpace : 0.0;
+        }
+    };
+
+    /**
+     * Function GetStatistics()
+     * returns the current state of the free space and the counts of moved vertices.
+     */
+    STATISTICS GetStatistics() const;
+
+    ///> Default number of vertices Compact() may move at once
+    static const unsigned int defaultCompactionLimit = 32768;
+
 protected:
-    ///> Maps size of free memory chunks to their offsets
+    ///> Free memory chunks (size & offset), ordered by size then offset, so the best fitting
+    ///> chunk for a given size is found with lower_bound()
     typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
+    typedef std::set<CHUNK> FREE_CHUNK_SET;
+
+    ///> Maps offset of free memory chunks to their sizes
+    typedef std::map<unsigned int, unsigned int> FREE_OFFSET_MAP;
 
     /// List of all the stored items
     typedef std::set<VERTEX_ITEM*> ITEMS;
 
+    /// Stored items which hold vertices, by offset
+    typedef std::map<unsigned int, VERTEX_ITEM*> ITEM_OFFSET_MAP;
+
     ///> Stores size & offset of free chunks.
-    FREE_CHUNK_MAP      m_freeChunks;
+    FREE_CHUNK_SET      m_freeChunks;
+
+    ///> Stores the same free chunks by offset, to merge the adjacent ones
+    FREE_OFFSET_MAP     m_freeOffsets;
 
     ///> Stored VERTEX_ITEMs
     ITEMS               m_items;
 
+    ///> Stored VERTEX_ITEMs which hold vertices, by offset
+    ITEM_OFFSET_MAP     m_itemOffsets;
+
+    ///> Maximal number of vertices moved by Compact(), 0 to defragment at once
+    unsigned int        m_compactionLimit;
+
+    ///> Counters of the statistics
+    STATISTICS          m_stats;
+
     ///> Currently modified item
     VERTEX_ITEM*        m_item;
 
@@ -116,18 +195,26 @@ protected:
     virtual bool defragment( VERTEX* aTarget = NULL );
 
     /**
-     * Function mergeFreeChunks()
-     * looks for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
+     * Function addFreeChunk()
+     * returns a chunk to the free space pool, merging it with the adjacent free chunks.
+     * m_freeSpace is not changed.
      */
-    virtual void mergeFreeChunks();
+    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Function removeFreeChunk()
+     * removes the free chunk starting at @a aOffset from the pool.  m_freeSpace is not changed.
+     */
+    void removeFreeChunk( unsigned int aOffset, unsigned int aSize );
 
     /**
      * Function resizeContainer()
      *
-     * prepares a bigger container of a given size.
+     * prepares a bigger or smaller container of a given size.  The container is shrunk without
+     * moving the items when they all fit below the new size; otherwise it is defragmented, unless
+     * there is incremental compaction.
      * @param aNewSize is the new size of container, expressed in vertices
-     * @return false in case of failure (eg. memory shortage)
+     * @return false in case of failure (eg. memory shortage, or the items would have to be moved)
      */
     virtual bool resizeContainer( unsigned int aNewSize );
 
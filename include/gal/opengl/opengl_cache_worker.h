@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file opengl_cache_worker.h
+ * @brief Draws the groups of an OPENGL_GAL on an other thread.
+ */
+
+#ifndef OPENGL_CACHE_WORKER_H_
+#define OPENGL_CACHE_WORKER_H_
+
+#include <gal/opengl/opengl_base_gal.h>
+#include <gal/opengl/vertex_manager.h>
+#include <gal/opengl/vertex_item.h>
+
+#include <vector>
+#include <boost/smart_ptr/shared_ptr.hpp>
+
+namespace KIGFX
+{
+/**
+ * @brief Class OPENGL_CACHE_WORKER stages the groups drawn on a thread other than the one owning
+ * the OpenGL context.
+ *
+ * The groups are stored in system memory only; OPENGL_GAL::MergeGroup() copies them to the
+ * cached target of the OPENGL_GAL that created the worker.  A worker can draw only groups,
+ * any other use of it is an error.
+ */
+class OPENGL_CACHE_WORKER : public OPENGL_BASE_GAL
+{
+public:
+    OPENGL_CACHE_WORKER();
+
+    virtual ~OPENGL_CACHE_WORKER();
+
+    /**
+     * @brief Return the vertices stored by a group.
+     *
+     * @param aGroupNumber is the number returned by BeginGroup().
+     */
+    const VERTEX_ITEM& GetGroup( int aGroupNumber ) const
+    {
+        return *groups[aGroupNumber];
+    }
+
+    // -------------------------------------------
+    // Screen methods (not used by a worker)
+    // -------------------------------------------
+
+    /// @copydoc GAL::BeginDrawing()
+    virtual void BeginDrawing();
+
+    /// @copydoc GAL::EndDrawing()
+    virtual void EndDrawing();
+
+    /// @copydoc GAL::ResizeScreen()
+    virtual void ResizeScreen( int aWidth, int aHeight );
+
+    /// @copydoc GAL::Show()
+    virtual bool Show( bool aShow );
+
+    /// @copydoc GAL::Flush()
+    virtual void Flush();
+
+    /// @copydoc GAL::ClearScreen()
+    virtual void ClearScreen();
+
+    /// @copydoc GAL::Transform()
+    virtual void Transform( MATRIX3x3D aTransformation );
+
+    // -------------
+    // Group methods
+    // -------------
+
+    /// @copydoc GAL::BeginGroup()
+    virtual int BeginGroup();
+
+    /// @copydoc GAL::EndGroup()
+    virtual void EndGroup();
+
+    /// @copydoc GAL::DrawGroup()
+    virtual void DrawGroup( int aGroupNumber );
+
+    /// @copydoc GAL::ChangeGroupColor()
+    virtual void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor );
+
+    /// @copydoc GAL::ChangeGroupDepth()
+    virtual void ChangeGroupDepth( int aGroupNumber, int aDepth );
+
+    /// @copydoc GAL::DeleteGroup()
+    virtual void DeleteGroup( int aGroupNumber );
+
+    /// @copydoc GAL::ClearCache()
+    virtual void ClearCache();
+
+    // --------------------------------------------------------
+    // Handling the world <-> screen transformation
+    // --------------------------------------------------------
+
+    /// @copydoc GAL::SaveScreen()
+    virtual void SaveScreen();
+
+    /// @copydoc GAL::RestoreScreen()
+    virtual void RestoreScreen();
+
+    /// @copydoc GAL::SetTarget()
+    virtual void SetTarget( RENDER_TARGET aTarget );
+
+    /// @copydoc GAL::GetTarget()
+    virtual RENDER_TARGET GetTarget() const;
+
+    /// @copydoc GAL::ClearTarget()
+    virtual void ClearTarget( RENDER_TARGET aTarget );
+
+    // -------
+    // Cursor
+    // -------
+
+    /// @copydoc GAL::DrawCursor()
+    virtual void DrawCursor( const VECTOR2D& aCursorPosition );
+
+protected:
+    ///< Initial number of vertices of the staging container, it grows when needed
+    static const unsigned int STAGING_SIZE = 65536;
+
+    VERTEX_MANAGER          stagingManager;         ///< Stores the vertices of the drawn groups
+    std::vector< boost::shared_ptr<VERTEX_ITEM> > groups;   ///< Groups drawn since ClearCache()
+
+    /// @copydoc GAL::drawGridLine()
+    virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+
+    /// @copydoc GAL::initCursor()
+    virtual void initCursor( int aCursorSize );
+};
+} // namespace KIGFX
+
+#endif  // OPENGL_CACHE_WORKER_H_
@@ -30,7 +30,7 @@
 #define OPENGLGAL_H_
 
 // GAL imports
-#include <gal/graphics_abstraction_layer.h>
+#include <gal/opengl/opengl_base_gal.h>
 #include <gal/opengl/shader.h>
 #include <gal/opengl/vertex_manager.h>
 #include <gal/opengl/vertex_item.h>
@@ -53,13 +53,10 @@
 #include <iostream>
 #include <fstream>
 
-#ifndef CALLBACK
-#define CALLBACK
-#endif
-
 namespace KIGFX
 {
 class SHADER;
+class OPENGL_CACHE_WORKER;
 
 /**
  * @brief Class OpenGL_GAL is the OpenGL implementation of the Graphics Abstraction Layer.
@@ -68,7 +65,7 @@ class SHADER;
  * and quads. The purpuse is to provide a fast graphics interface, that takes advantage of modern
  * graphics card GPUs. All methods here benefit thus from the hardware acceleration.
  */
-class OPENGL_GAL : public GAL, public wxGLCanvas
+class OPENGL_GAL : public OPENGL_BASE_GAL, public wxGLCanvas
 {
 public:
 
@@ -102,33 +99,6 @@ public:
     /// @copydoc GAL::EndDrawing()
     virtual void EndDrawing();
 
-    /// @copydoc GAL::DrawLine()
-    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
-
-    /// @copydoc GAL::DrawSegment()
-    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                              double aWidth );
-
-    /// @copydoc GAL::DrawCircle()
-    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius );
-
-    /// @copydoc GAL::DrawArc()
-    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
-                          double aStartAngle, double aEndAngle );
-
-    /// @copydoc GAL::DrawRectangle()
-    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
-
-    /// @copydoc GAL::DrawPolyline()
-    virtual void DrawPolyline( std::deque<VECTOR2D>& aPointList );
-
-    /// @copydoc GAL::DrawPolygon()
-    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList );
-
-    /// @copydoc GAL::DrawCurve()
-    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
-                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint );
-
     // --------------
     // Screen methods
     // --------------
@@ -145,13 +115,6 @@ public:
     /// @copydoc GAL::ClearScreen()
     virtual void ClearScreen();
 
-    // -----------------
-    // Attribute setting
-    // -----------------
-
-    /// @copydoc GAL::SetStrokeColor()
-    virtual void SetStrokeColor( const COLOR4D& aColor );
-
     // --------------
     // Transformation
     // --------------
@@ -159,21 +122,6 @@ public:
     /// @copydoc GAL::Transform()
     virtual void Transform( MATRIX3x3D aTransformation );
 
-    /// @copydoc GAL::Rotate()
-    virtual void Rotate( double aAngle );
-
-    /// @copydoc GAL::Translate()
-    virtual void Translate( const VECTOR2D& aTranslation );
-
-    /// @copydoc GAL::Scale()
-    virtual void Scale( const VECTOR2D& aScale );
-
-    /// @copydoc GAL::Save()
-    virtual void Save();
-
-    /// @copydoc GAL::Restore()
-    virtual void Restore();
-
     // --------------------------------------------
     // Group methods
     // ---------------------------------------------
@@ -199,6 +147,12 @@ public:
     /// @copydoc GAL::ClearCache()
     virtual void ClearCache();
 
+    /// @copydoc GAL::GetCacheWorker()
+    virtual GAL* GetCacheWorker( int aIndex );
+
+    /// @copydoc GAL::MergeGroup()
+    virtual int MergeGroup( GAL* aWorker, int aWorkerGroup );
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -249,25 +203,12 @@ public:
         paintListener = aPaintListener;
     }
 
-    ///< Parameters passed to the GLU tesselator
-    typedef struct
-    {
-        /// Manager used for storing new vertices
-        VERTEX_MANAGER* vboManager;
-
-        /// Intersect points, that have to be freed after tessellation
-        std::deque< boost::shared_array<GLdouble> >& intersectPoints;
-    } TessParams;
-
 protected:
     virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
 
 private:
     /// Super class definition
-    typedef GAL super;
-
-    static const int    CIRCLE_POINTS   = 64;   ///< The number of points for circle approximation
-    static const int    CURVE_POINTS    = 32;   ///< The number of points for curve approximation
+    typedef OPENGL_BASE_GAL super;
 
     wxClientDC*             clientDC;               ///< Drawing context
     wxGLContext*            glContext;              ///< OpenGL context of wxWidgets
@@ -279,11 +220,14 @@ private:
     typedef std::map< unsigned int, boost::shared_ptr<VERTEX_ITEM> > GROUPS_MAP;
     GROUPS_MAP              groups;                 ///< Stores informations about VBO objects (groups)
     unsigned int            groupCounter;           ///< Counter used for generating keys for groups
-    VERTEX_MANAGER*         currentManager;         ///< Currently used VERTEX_MANAGER (for storing VERTEX_ITEMs)
     VERTEX_MANAGER          cachedManager;          ///< Container for storing cached VERTEX_ITEMs
     VERTEX_MANAGER          nonCachedManager;       ///< Container for storing non-cached VERTEX_ITEMs
     VERTEX_MANAGER          overlayManager;         ///< Container for storing overlaid VERTEX_ITEMs
 
+#ifdef PROFILE
+    unsigned int            cacheEvents;            ///< Resizes and moves of the cached vertices
+#endif /* PROFILE */
+
     // Framebuffer & compositing
     OPENGL_COMPOSITOR       compositor;             ///< Handles multiple rendering targets
     unsigned int            mainBuffer;             ///< Main rendering target
@@ -301,50 +245,8 @@ private:
 
     VECTOR2D                cursorPosition;         ///< Current cursor position
 
-    // Polygon tesselation
-    /// The tessellator
-    GLUtesselator*          tesselator;
-    /// Storage for intersecting points
-    std::deque< boost::shared_array<GLdouble> > tessIntersects;
-
-    /**
-     * @brief Draw a quad for the line.
-     *
-     * @param aStartPoint is the start point of the line.
-     * @param aEndPoint is the end point of the line.
-     */
-    inline void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
-
-    /**
-     * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
-     * the proper function (drawStrokedSemiCircle or drawFilledSemiCircle).
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
-
-    /**
-     * @brief Draw a filled semicircle.
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
-
-    /**
-     * @brief Draw a stroked semicircle.
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+    /// Workers drawing the groups on other threads, created by GetCacheWorker()
+    std::vector< boost::shared_ptr<OPENGL_CACHE_WORKER> > cacheWorkers;
 
     // Event handling
     /**
@@ -43,8 +43,12 @@ public:
     /**
      * Function MakeContainer()
      * Returns a pointer to a new container of an appropriate type.
+     *
+     * @param aCached says if the container is going to be cached.
+     * @param aSize is the initial number of vertices the container can hold (0 stands for
+     * the default size).
      */
-    static VERTEX_CONTAINER* MakeContainer( bool aCached );
+    static VERTEX_CONTAINER* MakeContainer( bool aCached, unsigned int aSize = 0 );
 
     virtual ~VERTEX_CONTAINER();
 
@@ -61,6 +65,13 @@ public:
      */
     virtual void FinishItem() {};
 
+    /**
+     * Function Compact()
+     * is called once per frame, before the vertices are uploaded to the GPU, to let the
+     * container reduce its fragmentation a bit at a time.
+     */
+    virtual void Compact() {};
+
     /**
      * Function Allocate()
      * returns allocated space (possibly resizing the reserved memory chunk or allocating a new
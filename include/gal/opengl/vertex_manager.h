@@ -55,8 +55,10 @@ public:
      *
      * @param aCached says if vertices should be cached in GPU or system memory. For data that
      * does not change every frame, it is better to store vertices in GPU memory.
+     * @param aInitialSize is the initial number of vertices of the container (0 stands for
+     * the container default size).
      */
-    VERTEX_MANAGER( bool aCached );
+    VERTEX_MANAGER( bool aCached, unsigned int aInitialSize = 0 );
 
     /**
      * Function Vertex()
@@ -96,6 +98,17 @@ public:
      */
     void Vertices( const VERTEX aVertices[], unsigned int aSize ) const;
 
+    /**
+     * Function PutVertices()
+     * adds one or more vertices to the currently set item, as they are. Unlike Vertices(), the
+     * current transformation, color & shader are not applied, so it is meant to copy vertices
+     * that were already prepared by an other VERTEX_MANAGER.
+     *
+     * @param aVertices contains vertices to be added
+     * @param aSize is the number of vertices to be added.
+     */
+    void PutVertices( const VERTEX aVertices[], unsigned int aSize ) const;
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -311,6 +324,15 @@ public:
      */
     void EndDrawing() const;
 
+    /**
+     * Function GetContainer()
+     * returns the container of the vertices, eg. to read the statistics of a CACHED_CONTAINER.
+     */
+    inline VERTEX_CONTAINER* GetContainer() const
+    {
+        return m_container.get();
+    }
+
 protected:
     /**
      * Function putVertex()
@@ -30,6 +30,9 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include <vector>
+#include <algorithm>
+
 #define ASSERT assert    // RTree uses ASSERT( condition )
 #ifndef Min
   #define Min std::min
@@ -120,6 +123,22 @@ public:
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Entry for BulkLoad()
+    struct BulkEntry
+    {
+        ELEMTYPE    m_min[NUMDIMS];                 ///< Min of bounding rect
+        ELEMTYPE    m_max[NUMDIMS];                 ///< Max of bounding rect
+        DATATYPE    m_data;                         ///< Data Id or Ptr
+    };
+
+    /// Insert many entries at once.
+    /// If the tree is empty, it is built bottom-up from the entries sorted by the
+    /// Sort-Tile-Recursive method: the nodes are full and overlap little, and the
+    /// construction is much faster than inserting the entries one by one.
+    /// Otherwise the entries are simply inserted one by one.
+    /// \param a_entries Entries to insert
+    void BulkLoad( const std::vector<BulkEntry>& a_entries );
+
     /// Find all within search rectangle
     /// \param a_min Min of search bounding rect
     /// \param a_max Max of search bounding rect
@@ -401,6 +420,21 @@ protected:
         Branch  m_branch[MAXNODES];                 ///< Branch
     };
 
+    /// Orders branches by the center of their rect along an axis
+    struct BranchCenterLess
+    {
+        BranchCenterLess( int a_axis ) : m_axis( a_axis ) {}
+
+        bool operator()( const Branch& a_branchA, const Branch& a_branchB ) const
+        {
+            // Sum of min and max in double, as it may overflow ELEMTYPE
+            return (double) a_branchA.m_rect.m_min[m_axis] + a_branchA.m_rect.m_max[m_axis] <
+                   (double) a_branchB.m_rect.m_min[m_axis] + a_branchB.m_rect.m_max[m_axis];
+        }
+
+        int m_axis;
+    };
+
     /// A link list of nodes for reinsertion after a delete operation
     struct ListNode
     {
@@ -468,6 +502,7 @@ protected:
     bool            Overlap( Rect* a_rectA, Rect* a_rectB );
     void            ReInsert( Node* a_node, ListNode** a_listNode );
     ELEMTYPE        MinDist( const ELEMTYPE a_point[NUMDIMS], Rect* a_rect );
+    void            SortTileRecursive( Branch* a_branches, int a_count, int a_axis );
     void            InsertNNListSorted( std::vector<NNNode*>* nodeList, NNNode* newNode );
 
     bool Search( Node * a_node, Rect * a_rect, int& a_foundCount, bool a_resultCallback(
@@ -692,6 +727,117 @@ void RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<BulkEntry>& a_entries )
+{
+    if( m_root->m_count > 0 )
+    {
+        for( unsigned int index = 0; index < a_entries.size(); ++index )
+        {
+            Insert( a_entries[index].m_min, a_entries[index].m_max, a_entries[index].m_data );
+        }
+
+        return;
+    }
+
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( unsigned int index = 0; index < a_entries.size(); ++index )
+    {
+        for( int axis = 0; axis < NUMDIMS; ++axis )
+        {
+#ifdef _DEBUG
+            ASSERT( a_entries[index].m_min[axis] <= a_entries[index].m_max[axis] );
+#endif    // _DEBUG
+            branches[index].m_rect.m_min[axis]  = a_entries[index].m_min[axis];
+            branches[index].m_rect.m_max[axis]  = a_entries[index].m_max[axis];
+        }
+
+        branches[index].m_data = a_entries[index].m_data;
+    }
+
+    // Pack each level in nodes, from the leaves up, until the root can hold the rest
+    int level = 0;
+
+    while( (int) branches.size() > MAXNODES )
+    {
+        int count = branches.size();
+
+        SortTileRecursive( &branches[0], count, 0 );
+
+        std::vector<Branch> parents;
+        parents.reserve( count / MAXNODES + 1 );
+
+        for( int first = 0; first < count; )
+        {
+            int nodeCount = std::min( count - first, (int) MAXNODES );
+
+            // Do not leave less than MINNODES branches to the last node: share them
+            // with this one instead
+            int rest = count - first - nodeCount;
+
+            if( rest > 0 && rest < MINNODES )
+                nodeCount = ( count - first ) / 2;
+
+            Node* node = AllocNode();
+            node->m_level = level;
+
+            for( int index = 0; index < nodeCount; ++index )
+            {
+                node->m_branch[index] = branches[first + index];
+            }
+
+            node->m_count = nodeCount;
+
+            Branch branch;
+            branch.m_rect   = NodeCover( node );
+            branch.m_child  = node;
+            parents.push_back( branch );
+
+            first += nodeCount;
+        }
+
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root->m_level = level;
+
+    for( unsigned int index = 0; index < branches.size(); ++index )
+    {
+        m_root->m_branch[index] = branches[index];
+    }
+
+    m_root->m_count = branches.size();
+}
+
+
+// Sort-Tile-Recursive ordering: sort the branches along the first axis, cut them in
+// slabs, and sort each slab along the next axis, so each run of MAXNODES branches
+// covers a compact tile.
+RTREE_TEMPLATE
+void RTREE_QUAL::SortTileRecursive( Branch* a_branches, int a_count, int a_axis )
+{
+    if( a_count <= MAXNODES )
+        return;
+
+    std::sort( a_branches, a_branches + a_count, BranchCenterLess( a_axis ) );
+
+    if( a_axis == NUMDIMS - 1 )
+        return;
+
+    // Cut in (number of nodes)^(1/remaining axes) slabs, each a whole number of nodes
+    int nodeCount   = ( a_count + MAXNODES - 1 ) / MAXNODES;
+    int slabCount   = (int) ceil( pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_axis ) ) );
+    int slabSize    = MAXNODES * ( ( nodeCount + slabCount - 1 ) / slabCount );
+
+    for( int first = 0; first < a_count; first += slabSize )
+    {
+        SortTileRecursive( a_branches + first, std::min( slabSize, a_count - first ), a_axis + 1 );
+    }
+}
+
+
 RTREE_TEMPLATE
 int RTREE_QUAL::Search( const ELEMTYPE a_min[NUMDIMS],
                         const ELEMTYPE a_max[NUMDIMS],
@@ -254,6 +254,18 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a painter sharing the settings of this one, but drawing on an other GAL, so
+     * items may be drawn by several threads at once. The caller takes the ownership.
+     * @param aGal is the GAL used by the new painter.
+     * @return The new painter or NULL if the painter cannot be used by other threads.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return NULL;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
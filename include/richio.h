@@ -381,6 +381,61 @@ public:
 };
 
 
+/**
+ * Class MAPPED_FILE_LINE_READER
+ * is a LINE_READER that maps a whole file in memory and returns its lines in
+ * place, without copying them to a line buffer.
+ * <p>
+ * The file is mapped privately (copy on write): the byte following the returned
+ * line is temporarily replaced by a nul, and restored by the next ReadLine(), so
+ * a line stays valid and nul terminated until the next ReadLine() call, as with the
+ * other LINE_READERs.  On platforms without mmap(), the file is read in memory in
+ * one block instead.
+ */
+class MAPPED_FILE_LINE_READER : public LINE_READER
+{
+protected:
+    char*   data;           ///< the content of the file
+    size_t  size;           ///< no. bytes in data
+    size_t  ndx;            ///< offset in data of the next line
+    bool    isMapped;       ///< true if data is mapped, false if it was allocated
+    bool    hasTail;        ///< true if data[size] can be written
+
+    char*   buffer;         ///< the line buffer of LINE_READER, used for an unterminated
+                            ///< last line
+    char*   patched;        ///< the byte replaced by the nul after the current line
+    char    patchedChar;    ///< the original value of *patched
+
+    void    restorePatch();
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * opens and maps @a aFileName.
+     *
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or read.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX ) throw( IO_ERROR );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() throw( IO_ERROR );   // see LINE_READER::ReadLine() description
+
+    /**
+     * Function Rewind
+     * goes back to the beginning of the file and resets the line number back to zero.
+     */
+    void Rewind();
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -529,6 +584,21 @@ public:
      */
     int PRINTF_FUNC Print( int nestLevel, const char* fmt, ... ) throw( IO_ERROR );
 
+    /**
+     * Function PrintRaw
+     * writes text built by the caller to the output stream as it is.  It is faster
+     * than Print() with a "%s" format, for the code which writes much output.
+     *
+     * @param aText is the start of the text.
+     * @param aCount tells how many bytes to write.
+     * @throw IO_ERROR, if there is a problem outputting, such as a full disk.
+     */
+    void PrintRaw( const char* aText, int aCount ) throw( IO_ERROR )
+    {
+        if( aCount > 0 )
+            write( aText, aCount );
+    }
+
     /**
      * Function GetQuoteChar
      * performs quote character need determination.
@@ -647,8 +717,9 @@ protected:
     void write( const char* aOutBuf, int aCount ) throw( IO_ERROR );
     //-----</OUTPUTFORMATTER>-----------------------------------------------
 
-    FILE*       m_fp;               ///< takes ownership
-    wxString    m_filename;
+    FILE*               m_fp;           ///< takes ownership
+    wxString            m_filename;
+    std::vector<char>   m_fileBuffer;   ///< stdio buffer of m_fp, larger than the default one
 };
 
 
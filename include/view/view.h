@@ -78,6 +78,15 @@ public:
      */
     void Add( VIEW_ITEM* aItem );
 
+    /**
+     * Function Add()
+     * Adds many VIEW_ITEMs to the view at once. The layers which are empty are built from
+     * all their items (bulk loaded), which is much faster than adding the items one by one
+     * when a whole document is loaded.
+     * @param aItems: items to be added. No ownership is given
+     */
+    void Add( const std::vector<VIEW_ITEM*>& aItems );
+
     /**
      * Function Remove()
      * Removes a VIEW_ITEM from the view.
@@ -308,6 +317,29 @@ public:
         m_layers[aLayer].target = aTarget;
     }
 
+    /**
+     * Function SetLayerMinimumSize()
+     * Sets the size below which the items of a layer are not drawn (level of details). The size
+     * of an item is given by VIEW_ITEM::ViewGetDetailSize().
+     * @param aLayer is the layer.
+     * @param aPixels is the minimal size of items on the screen, expressed in pixels. 0 shows all
+     * the items.
+     */
+    inline void SetLayerMinimumSize( int aLayer, double aPixels )
+    {
+        m_layers[aLayer].minSize = aPixels;
+    }
+
+    /**
+     * Function GetLayerMinimumSize()
+     * Returns the size below which the items of a layer are not drawn, in pixels.
+     * @param aLayer is the layer.
+     */
+    inline double GetLayerMinimumSize( int aLayer ) const
+    {
+        return m_layers.at( aLayer ).minSize;
+    }
+
     /**
      * Function SetLayerOrder()
      * Sets rendering order of a particular layer. Lower values are rendered first.
@@ -513,6 +545,7 @@ private:
         int                     id;              ///* layer ID
         RENDER_TARGET           target;          ///* where the layer should be rendered
         std::set<int>           requiredLayers;  ///* layers that have to be enabled to show the layer
+        double                  minSize;         ///* items smaller on the screen (in pixels) are not drawn
     };
 
     // Convenience typedefs
@@ -528,10 +561,27 @@ private:
     struct unlinkItem;
     struct updateItemsColor;
     struct changeItemsDepth;
+    struct collectItems;
 
     ///* Redraws contents within rect aRect
     void redrawRect( const BOX2I& aRect );
 
+#ifdef USE_OPENMP
+    /**
+     * Function recacheLayerParallel()
+     * Recaches items of a layer: the items are drawn by several threads, each one using its
+     * own cache worker GAL and painter, then the drawn groups are merged into m_gal one by one.
+     *
+     * @param aLayer is the layer to be recached.
+     * @param aItems are the items of the layer.
+     * @param aWorkers are the cache workers of m_gal, one per thread.
+     * @param aPainters are the painters drawing on aWorkers.
+     */
+    void recacheLayerParallel( VIEW_LAYER* aLayer, const std::vector<VIEW_ITEM*>& aItems,
+                               const std::vector<GAL*>& aWorkers,
+                               const std::vector<PAINTER*>& aPainters );
+#endif /* USE_OPENMP */
+
     inline void clearTargetDirty( int aTarget )
     {
         wxASSERT( aTarget < TARGETS_NUMBER );
@@ -32,6 +32,7 @@
 
 #include <vector>
 #include <bitset>
+#include <algorithm>
 #include <math/box2.h>
 #include <view/view.h>
 #include <gal/definitions.h>
@@ -257,6 +258,19 @@ public:
         return 0;
     }
 
+    /**
+     * Function ViewGetDetailSize()
+     * Returns the size of the item details on a given layer, in world units. The item is not
+     * drawn when this size is smaller on the screen than the minimal size of the layer (see
+     * VIEW::SetLayerMinimumSize()). By default it is the bigger side of the bounding box.
+     */
+    virtual double ViewGetDetailSize( int aLayer ) const
+    {
+        const BOX2I bbox = ViewBBox();
+
+        return std::max( bbox.GetWidth(), bbox.GetHeight() );
+    }
+
     /**
      * Function ViewUpdate()
      * For dynamic VIEWs, informs the associated VIEW that the graphical representation of
@@ -55,6 +55,30 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items at once. An empty tree is built at once from the items sorted by
+     * their position, which is faster and gives a better packed tree than inserting them one
+     * by one.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<BulkEntry> entries( aItems.size() );
+
+        for( unsigned int i = 0; i < aItems.size(); ++i )
+        {
+            const BOX2I& bbox = aItems[i]->ViewBBox();
+
+            entries[i].m_min[0] = bbox.GetX();
+            entries[i].m_min[1] = bbox.GetY();
+            entries[i].m_max[0] = bbox.GetRight();
+            entries[i].m_max[1] = bbox.GetBottom();
+            entries[i].m_data   = aItems[i];
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
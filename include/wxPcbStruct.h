@@ -1368,9 +1368,8 @@ public:
      * The old fillings are removed
      * @param aActiveWindow = the current active window, if a progress bar is shown
      *                      = NULL to do not display a progress bar
-     * @param aVerbose = true to show error messages
      */
-    int Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose = true );
+    void Fill_All_Zones( wxWindow * aActiveWindow );
 
 
     /**
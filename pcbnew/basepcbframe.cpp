@@ -836,6 +836,13 @@ void PCB_BASE_FRAME::LoadSettings( wxConfigBase* aCfg )
 
         // Load display options (such as filled/outline display of items)
         settings->LoadDisplayOptions( DisplayOpt );
+
+        // Items too small to be seen are not drawn (level of details)
+        for( LAYER_NUM i = 0; (unsigned) i < sizeof(GAL_LAYER_ORDER) / sizeof(LAYER_NUM); ++i )
+        {
+            LAYER_NUM layer = GAL_LAYER_ORDER[i];
+            view->SetLayerMinimumSize( layer, settings->GetMinimumSize( layer ) );
+        }
     }
 
     // WxWidgets 2.9.1 seems call setlocale( LC_NUMERIC, "" )
@@ -0,0 +1,756 @@
+/**
+ * @file board_spatial_index.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+
+#include <board_spatial_index.h>
+
+
+/* Visitor used to gather the items found by a RTree search
+ */
+template <class T>
+struct ITEM_COLLECTOR
+{
+    std::vector<T*>& m_items;
+
+    ITEM_COLLECTOR( std::vector<T*>& aItems ) : m_items( aItems ) {}
+
+    bool operator()( T* aItem )
+    {
+        m_items.push_back( aItem );
+        return true;    // continue the search
+    }
+};
+
+
+template <class TREE, class T>
+static void treeInsert( TREE* aTree, const EDA_RECT& aArea, T* aItem )
+{
+    const int mmin[2] = { aArea.GetX(), aArea.GetY() };
+    const int mmax[2] = { aArea.GetRight(), aArea.GetBottom() };
+
+    aTree->Insert( mmin, mmax, aItem );
+}
+
+
+template <class TREE, class T>
+static void treeRemove( TREE* aTree, const EDA_RECT& aArea, T* aItem )
+{
+    const int mmin[2] = { aArea.GetX(), aArea.GetY() };
+    const int mmax[2] = { aArea.GetRight(), aArea.GetBottom() };
+
+    aTree->Remove( mmin, mmax, aItem );
+}
+
+
+template <class TREE, class T>
+static void treeSearch( TREE* aTree, const wxPoint& aPosition, std::vector<T*>& aResult )
+{
+    const int point[2] = { aPosition.x, aPosition.y };
+
+    ITEM_COLLECTOR<T> collector( aResult );
+    aTree->Search( point, point, collector );
+}
+
+
+/* Used to sort items by rank
+ */
+template <class T>
+static bool rankLess( const std::pair<double, T*>& aFirst, const std::pair<double, T*>& aSecond )
+{
+    return aFirst.first < aSecond.first;
+}
+
+
+BOARD_SPATIAL_INDEX::BOARD_SPATIAL_INDEX( BOARD* aBoard ) :
+    m_board( aBoard )
+{
+    for( int layer = 0; layer < NB_LAYERS; ++layer )
+        m_trackTrees[layer] = new TRACK_RTREE();
+
+    m_viaTree    = new TRACK_RTREE();
+    m_moduleTree = new MODULE_RTREE();
+    m_padTree    = new PAD_RTREE();
+
+    m_isBuilt = false;
+    m_trackListChangeCount = 0;
+    m_moduleListChangeCount = 0;
+}
+
+
+BOARD_SPATIAL_INDEX::~BOARD_SPATIAL_INDEX()
+{
+    for( int layer = 0; layer < NB_LAYERS; ++layer )
+        delete m_trackTrees[layer];
+
+    delete m_viaTree;
+    delete m_moduleTree;
+    delete m_padTree;
+}
+
+
+bool BOARD_SPATIAL_INDEX::IsSynced() const
+{
+    return m_isBuilt
+        && m_trackListChangeCount == m_board->m_Track.GetChangeCount()
+        && m_moduleListChangeCount == m_board->m_Modules.GetChangeCount();
+}
+
+
+void BOARD_SPATIAL_INDEX::Clear()
+{
+    for( int layer = 0; layer < NB_LAYERS; ++layer )
+        m_trackTrees[layer]->RemoveAll();
+
+    m_viaTree->RemoveAll();
+    m_moduleTree->RemoveAll();
+    m_padTree->RemoveAll();
+
+    m_tracks.clear();
+    m_modules.clear();
+    m_padModules.clear();
+    m_floatingTracks.clear();
+    m_floatingModules.clear();
+
+    m_isBuilt = false;
+}
+
+
+void BOARD_SPATIAL_INDEX::build()
+{
+    Clear();
+
+    double rank = 0.0;
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        TRACK_ENTRY& entry = m_tracks[track];
+        entry.m_Tree = NULL;
+        entry.m_Rank = rank++;
+
+        if( isChanging( track ) )
+            m_floatingTracks.insert( track );
+        else
+            anchorTrack( track );
+    }
+
+    rank = 0.0;
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        MODULE_ENTRY& entry = m_modules[module];
+        entry.m_InTree = false;
+        entry.m_Rank = rank++;
+
+        if( isChanging( module ) )
+            m_floatingModules.insert( module );
+        else
+            anchorModule( module );
+    }
+
+    recordChangeCounts();
+}
+
+
+void BOARD_SPATIAL_INDEX::update()
+{
+    if( !IsSynced() )
+    {
+        build();
+        return;
+    }
+
+    // Put back in the trees the items which are no longer changing
+    if( !m_floatingTracks.empty() )
+    {
+        std::vector<TRACK*> tracks( m_floatingTracks.begin(), m_floatingTracks.end() );
+
+        for( unsigned ii = 0; ii < tracks.size(); ++ii )
+        {
+            if( !isChanging( tracks[ii] ) )
+                anchorTrack( tracks[ii] );
+        }
+    }
+
+    if( !m_floatingModules.empty() )
+    {
+        std::vector<MODULE*> modules( m_floatingModules.begin(), m_floatingModules.end() );
+
+        for( unsigned ii = 0; ii < modules.size(); ++ii )
+        {
+            if( !isChanging( modules[ii] ) )
+                anchorModule( modules[ii] );
+        }
+    }
+}
+
+
+void BOARD_SPATIAL_INDEX::recordChangeCounts()
+{
+    m_trackListChangeCount = m_board->m_Track.GetChangeCount();
+    m_moduleListChangeCount = m_board->m_Modules.GetChangeCount();
+    m_isBuilt = true;
+}
+
+
+void BOARD_SPATIAL_INDEX::Add( BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        addTrack( (TRACK*) aItem );
+        break;
+
+    case PCB_MODULE_T:
+        addModule( (MODULE*) aItem );
+        break;
+
+    default:
+        break;
+    }
+
+    recordChangeCounts();
+}
+
+
+void BOARD_SPATIAL_INDEX::Remove( BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        removeTrack( (TRACK*) aItem );
+        break;
+
+    case PCB_MODULE_T:
+        removeModule( (MODULE*) aItem );
+        break;
+
+    default:
+        break;
+    }
+
+    recordChangeCounts();
+}
+
+
+void BOARD_SPATIAL_INDEX::ItemChanging( BOARD_ITEM* aItem )
+{
+    // If the lists were changed, the index will be rebuilt anyway
+    if( !IsSynced() )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        if( m_tracks.count( (TRACK*) aItem ) )
+            floatTrack( (TRACK*) aItem );
+
+        break;
+
+    case PCB_MODULE_T:
+        if( m_modules.count( (MODULE*) aItem ) )
+            floatModule( (MODULE*) aItem );
+
+        break;
+
+    case PCB_PAD_T:
+        if( m_modules.count( (MODULE*) aItem->GetParent() ) )
+            floatModule( (MODULE*) aItem->GetParent() );
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void BOARD_SPATIAL_INDEX::addTrack( TRACK* aTrack )
+{
+    if( m_tracks.count( aTrack ) )
+        removeTrack( aTrack );
+
+    // The rank is between the ranks of the neighbours, which are already indexed
+    std::map<TRACK*, TRACK_ENTRY>::iterator back = m_tracks.end();
+    std::map<TRACK*, TRACK_ENTRY>::iterator next = m_tracks.end();
+
+    if( aTrack->Back() )
+        back = m_tracks.find( aTrack->Back() );
+
+    if( aTrack->Next() )
+        next = m_tracks.find( aTrack->Next() );
+
+    TRACK_ENTRY& entry = m_tracks[aTrack];
+    entry.m_Tree = NULL;
+
+    if( back != m_tracks.end() && next != m_tracks.end() )
+    {
+        entry.m_Rank = ( back->second.m_Rank + next->second.m_Rank ) / 2;
+
+        // No more room between the neighbours
+        if( entry.m_Rank <= back->second.m_Rank || entry.m_Rank >= next->second.m_Rank )
+            renumberTracks();
+    }
+    else if( back != m_tracks.end() )
+        entry.m_Rank = back->second.m_Rank + 1.0;
+    else if( next != m_tracks.end() )
+        entry.m_Rank = next->second.m_Rank - 1.0;
+    else
+        entry.m_Rank = 0.0;
+
+    if( isChanging( aTrack ) )
+        m_floatingTracks.insert( aTrack );
+    else
+        anchorTrack( aTrack );
+}
+
+
+void BOARD_SPATIAL_INDEX::removeTrack( TRACK* aTrack )
+{
+    std::map<TRACK*, TRACK_ENTRY>::iterator it = m_tracks.find( aTrack );
+
+    if( it == m_tracks.end() )
+        return;
+
+    if( it->second.m_Tree )
+        treeRemove( it->second.m_Tree, it->second.m_Area, aTrack );
+
+    m_floatingTracks.erase( aTrack );
+    m_tracks.erase( it );
+}
+
+
+void BOARD_SPATIAL_INDEX::anchorTrack( TRACK* aTrack )
+{
+    TRACK_ENTRY& entry = m_tracks[aTrack];
+
+    entry.m_Area = trackArea( aTrack );
+    entry.m_Tree = trackTree( aTrack );
+
+    if( entry.m_Tree )
+        treeInsert( entry.m_Tree, entry.m_Area, aTrack );
+
+    m_floatingTracks.erase( aTrack );
+}
+
+
+void BOARD_SPATIAL_INDEX::floatTrack( TRACK* aTrack )
+{
+    TRACK_ENTRY& entry = m_tracks[aTrack];
+
+    if( entry.m_Tree )
+        treeRemove( entry.m_Tree, entry.m_Area, aTrack );
+
+    entry.m_Tree = NULL;
+    m_floatingTracks.insert( aTrack );
+}
+
+
+void BOARD_SPATIAL_INDEX::renumberTracks()
+{
+    double rank = 0.0;
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        std::map<TRACK*, TRACK_ENTRY>::iterator it = m_tracks.find( track );
+
+        if( it != m_tracks.end() )
+            it->second.m_Rank = rank++;
+    }
+}
+
+
+void BOARD_SPATIAL_INDEX::addModule( MODULE* aModule )
+{
+    if( m_modules.count( aModule ) )
+        removeModule( aModule );
+
+    std::map<MODULE*, MODULE_ENTRY>::iterator back = m_modules.end();
+    std::map<MODULE*, MODULE_ENTRY>::iterator next = m_modules.end();
+
+    if( aModule->Back() )
+        back = m_modules.find( aModule->Back() );
+
+    if( aModule->Next() )
+        next = m_modules.find( aModule->Next() );
+
+    MODULE_ENTRY& entry = m_modules[aModule];
+    entry.m_InTree = false;
+
+    if( back != m_modules.end() && next != m_modules.end() )
+    {
+        entry.m_Rank = ( back->second.m_Rank + next->second.m_Rank ) / 2;
+
+        if( entry.m_Rank <= back->second.m_Rank || entry.m_Rank >= next->second.m_Rank )
+            renumberModules();
+    }
+    else if( back != m_modules.end() )
+        entry.m_Rank = back->second.m_Rank + 1.0;
+    else if( next != m_modules.end() )
+        entry.m_Rank = next->second.m_Rank - 1.0;
+    else
+        entry.m_Rank = 0.0;
+
+    if( isChanging( aModule ) )
+        m_floatingModules.insert( aModule );
+    else
+        anchorModule( aModule );
+}
+
+
+void BOARD_SPATIAL_INDEX::removeModule( MODULE* aModule )
+{
+    std::map<MODULE*, MODULE_ENTRY>::iterator it = m_modules.find( aModule );
+
+    if( it == m_modules.end() )
+        return;
+
+    if( it->second.m_InTree )
+        treeRemove( m_moduleTree, it->second.m_Area, aModule );
+
+    removePads( aModule );
+
+    m_floatingModules.erase( aModule );
+    m_modules.erase( it );
+}
+
+
+void BOARD_SPATIAL_INDEX::anchorModule( MODULE* aModule )
+{
+    MODULE_ENTRY& entry = m_modules[aModule];
+
+    entry.m_Area = aModule->GetBoundaryBox();
+    entry.m_Area.Normalize();
+    entry.m_InTree = true;
+    treeInsert( m_moduleTree, entry.m_Area, aModule );
+
+    insertPads( aModule );
+
+    m_floatingModules.erase( aModule );
+}
+
+
+void BOARD_SPATIAL_INDEX::floatModule( MODULE* aModule )
+{
+    MODULE_ENTRY& entry = m_modules[aModule];
+
+    if( entry.m_InTree )
+        treeRemove( m_moduleTree, entry.m_Area, aModule );
+
+    entry.m_InTree = false;
+    removePads( aModule );
+
+    m_floatingModules.insert( aModule );
+}
+
+
+void BOARD_SPATIAL_INDEX::insertPads( MODULE* aModule )
+{
+    MODULE_ENTRY& entry = m_modules[aModule];
+
+    entry.m_Pads.clear();
+
+    for( D_PAD* pad = aModule->Pads(); pad; pad = pad->Next() )
+    {
+        EDA_RECT area = padArea( pad );
+
+        treeInsert( m_padTree, area, pad );
+        entry.m_Pads.push_back( std::make_pair( pad, area ) );
+        m_padModules[pad] = aModule;
+    }
+
+    entry.m_PadListChangeCount = aModule->Pads().GetChangeCount();
+}
+
+
+void BOARD_SPATIAL_INDEX::removePads( MODULE* aModule )
+{
+    MODULE_ENTRY& entry = m_modules[aModule];
+
+    // The pads can have been deleted: use only the recorded pointers and areas
+    for( unsigned ii = 0; ii < entry.m_Pads.size(); ++ii )
+    {
+        D_PAD* pad = entry.m_Pads[ii].first;
+
+        treeRemove( m_padTree, entry.m_Pads[ii].second, pad );
+
+        std::map<D_PAD*, MODULE*>::iterator it = m_padModules.find( pad );
+
+        if( it != m_padModules.end() && it->second == aModule )
+            m_padModules.erase( it );
+    }
+
+    entry.m_Pads.clear();
+}
+
+
+void BOARD_SPATIAL_INDEX::renumberModules()
+{
+    double rank = 0.0;
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        std::map<MODULE*, MODULE_ENTRY>::iterator it = m_modules.find( module );
+
+        if( it != m_modules.end() )
+            it->second.m_Rank = rank++;
+    }
+}
+
+
+BOARD_SPATIAL_INDEX::TRACK_RTREE* BOARD_SPATIAL_INDEX::trackTree( TRACK* aTrack )
+{
+    if( aTrack->Type() == PCB_VIA_T )
+        return m_viaTree;
+
+    LAYER_NUM layer = aTrack->GetLayer();
+
+    if( layer < 0 || layer >= NB_LAYERS )
+        return NULL;
+
+    return m_trackTrees[layer];
+}
+
+
+void BOARD_SPATIAL_INDEX::collectTracks( TRACK_RTREE* aTree, const wxPoint& aPosition,
+                                         std::vector<TRACK*>& aResult )
+{
+    treeSearch( aTree, aPosition, aResult );
+}
+
+
+void BOARD_SPATIAL_INDEX::sortTracks( std::vector<TRACK*>& aTracks )
+{
+    std::vector< std::pair<double, TRACK*> > ranked;
+
+    for( unsigned ii = 0; ii < aTracks.size(); ++ii )
+        ranked.push_back( std::make_pair( m_tracks[aTracks[ii]].m_Rank, aTracks[ii] ) );
+
+    std::sort( ranked.begin(), ranked.end(), rankLess<TRACK> );
+
+    for( unsigned ii = 0; ii < ranked.size(); ++ii )
+        aTracks[ii] = ranked[ii].second;
+}
+
+
+void BOARD_SPATIAL_INDEX::QueryTracks( const wxPoint& aPosition, LAYER_MSK aLayerMask,
+                                       std::vector<TRACK*>& aResult, bool aWithVias )
+{
+    update();
+
+    aResult.clear();
+
+    for( LAYER_NUM layer = 0; layer < NB_LAYERS; ++layer )
+    {
+        if( aLayerMask & GetLayerMask( layer ) )
+            collectTracks( m_trackTrees[layer], aPosition, aResult );
+    }
+
+    if( aWithVias )
+        collectTracks( m_viaTree, aPosition, aResult );
+
+    for( std::set<TRACK*>::iterator it = m_floatingTracks.begin();
+         it != m_floatingTracks.end(); ++it )
+    {
+        TRACK* track = *it;
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            if( !aWithVias )
+                continue;
+        }
+        else if( !( aLayerMask & track->GetLayerMask() ) )
+        {
+            continue;
+        }
+
+        if( trackArea( track ).Contains( aPosition ) )
+            aResult.push_back( track );
+    }
+
+    sortTracks( aResult );
+}
+
+
+void BOARD_SPATIAL_INDEX::QueryVias( const wxPoint& aPosition, std::vector<TRACK*>& aResult )
+{
+    update();
+
+    aResult.clear();
+
+    collectTracks( m_viaTree, aPosition, aResult );
+
+    for( std::set<TRACK*>::iterator it = m_floatingTracks.begin();
+         it != m_floatingTracks.end(); ++it )
+    {
+        TRACK* track = *it;
+
+        if( track->Type() == PCB_VIA_T && trackArea( track ).Contains( aPosition ) )
+            aResult.push_back( track );
+    }
+
+    sortTracks( aResult );
+}
+
+
+void BOARD_SPATIAL_INDEX::QueryModules( const wxPoint& aPosition, std::vector<MODULE*>& aResult )
+{
+    update();
+
+    std::vector<MODULE*> found;
+    treeSearch( m_moduleTree, aPosition, found );
+
+    for( std::set<MODULE*>::iterator it = m_floatingModules.begin();
+         it != m_floatingModules.end(); ++it )
+    {
+        if( (*it)->GetBoundaryBox().Contains( aPosition ) )
+            found.push_back( *it );
+    }
+
+    std::vector< std::pair<double, MODULE*> > ranked;
+
+    for( unsigned ii = 0; ii < found.size(); ++ii )
+        ranked.push_back( std::make_pair( m_modules[found[ii]].m_Rank, found[ii] ) );
+
+    std::sort( ranked.begin(), ranked.end(), rankLess<MODULE> );
+
+    aResult.clear();
+
+    for( unsigned ii = 0; ii < ranked.size(); ++ii )
+        aResult.push_back( ranked[ii].second );
+}
+
+
+void BOARD_SPATIAL_INDEX::QueryPads( const wxPoint& aPosition, std::vector<D_PAD*>& aResult )
+{
+    update();
+
+    std::vector<D_PAD*> found;
+    treeSearch( m_padTree, aPosition, found );
+
+    // Find the footprints of the pads, without reading the pads, which can have been
+    // deleted.  The pads of a footprint whose pad list changed are indexed again.
+    std::set<MODULE*> modules;
+    bool reindexed = false;
+
+    for( unsigned ii = 0; ii < found.size(); ++ii )
+    {
+        std::map<D_PAD*, MODULE*>::iterator it = m_padModules.find( found[ii] );
+
+        if( it == m_padModules.end() )
+            continue;
+
+        MODULE* module = it->second;
+
+        if( m_modules[module].m_PadListChangeCount != module->Pads().GetChangeCount() )
+        {
+            removePads( module );
+            insertPads( module );
+            reindexed = true;
+        }
+
+        modules.insert( module );
+    }
+
+    if( reindexed )
+    {
+        found.clear();
+        treeSearch( m_padTree, aPosition, found );
+    }
+
+    std::set<D_PAD*> candidates( found.begin(), found.end() );
+
+    for( std::set<MODULE*>::iterator it = m_floatingModules.begin();
+         it != m_floatingModules.end(); ++it )
+        modules.insert( *it );
+
+    std::vector< std::pair<double, MODULE*> > ranked;
+
+    for( std::set<MODULE*>::iterator it = modules.begin(); it != modules.end(); ++it )
+        ranked.push_back( std::make_pair( m_modules[*it].m_Rank, *it ) );
+
+    std::sort( ranked.begin(), ranked.end(), rankLess<MODULE> );
+
+    // Walk the pad lists to give the pads in list order
+    aResult.clear();
+
+    for( unsigned ii = 0; ii < ranked.size(); ++ii )
+    {
+        MODULE* module = ranked[ii].second;
+        bool    floating = !m_modules[module].m_InTree;
+
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            if( floating ? padArea( pad ).Contains( aPosition ) : candidates.count( pad ) > 0 )
+                aResult.push_back( pad );
+        }
+    }
+}
+
+
+bool BOARD_SPATIAL_INDEX::isChanging( BOARD_ITEM* aItem )
+{
+    return aItem->GetFlags() & ( IS_MOVED | IS_DRAGGED | IS_RESIZED | IN_EDIT );
+}
+
+
+EDA_RECT BOARD_SPATIAL_INDEX::trackArea( TRACK* aTrack )
+{
+    // Round ends: this is their radius, rounded up
+    int radius = ( aTrack->GetWidth() + 1 ) / 2;
+
+    EDA_RECT area( aTrack->GetStart(), wxSize( 0, 0 ) );
+
+    if( aTrack->Type() != PCB_VIA_T )
+        area.Merge( aTrack->GetEnd() );
+
+    area.Inflate( radius );
+    area.Normalize();
+
+    return area;
+}
+
+
+EDA_RECT BOARD_SPATIAL_INDEX::padArea( D_PAD* aPad )
+{
+    // The area tested first by D_PAD::HitTest()
+    EDA_RECT area( aPad->ShapePos(), wxSize( 0, 0 ) );
+    area.Inflate( aPad->GetBoundingRadius() );
+    area.Normalize();
+
+    return area;
+}
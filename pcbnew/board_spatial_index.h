@@ -0,0 +1,201 @@
+/**
+ * @file board_spatial_index.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_SPATIAL_INDEX_H
+#define BOARD_SPATIAL_INDEX_H
+
+#include <vector>
+#include <map>
+#include <set>
+
+#include <base_struct.h>                     // EDA_RECT
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+class BOARD;
+class BOARD_ITEM;
+class TRACK;
+class MODULE;
+class D_PAD;
+
+
+/**
+ * Class BOARD_SPATIAL_INDEX
+ * holds R-trees of the tracks (one tree per layer), vias, footprints and pads of a
+ * BOARD, used by the BOARD functions which look for an item at a given position.
+ *
+ * The index gives candidates: the callers still run the exact hit tests, and use
+ * the rank of the candidates (their order in the board lists) to return the same
+ * item as a scan of the lists would.
+ *
+ * The index is kept up to date by BOARD::Add() and BOARD::Remove(), and by
+ * ItemChanging() for items which are about to be moved or modified.  The lists are
+ * also changed directly in many places: the change counters of m_Track, m_Modules
+ * and of the pad lists are compared to the ones recorded by the index, and the index
+ * (or a footprint) is rebuilt when they do not match.
+ *
+ * The index is not thread safe.
+ */
+class BOARD_SPATIAL_INDEX
+{
+public:
+    BOARD_SPATIAL_INDEX( BOARD* aBoard );
+    ~BOARD_SPATIAL_INDEX();
+
+    /**
+     * Function IsSynced
+     * @return true if the index matches the current content of the board lists.
+     */
+    bool IsSynced() const;
+
+    /**
+     * Function Add
+     * adds \a aItem to the index, after it was added to the board lists.
+     * Must be called only if IsSynced() was true before adding the item.
+     */
+    void Add( BOARD_ITEM* aItem );
+
+    /**
+     * Function Remove
+     * removes \a aItem from the index, after it was removed from the board lists.
+     * Must be called only if IsSynced() was true before removing the item.
+     */
+    void Remove( BOARD_ITEM* aItem );
+
+    /**
+     * Function ItemChanging
+     * takes a track, via, footprint or pad out of the trees, because its shape or
+     * position is about to change.  The item is tested linearly by the queries until
+     * it is put back in the trees, at its new position, by the first query which
+     * finds it is no longer moved or edited.
+     */
+    void ItemChanging( BOARD_ITEM* aItem );
+
+    /**
+     * Function QueryTracks
+     * collects the tracks found at \a aPosition on the layers of \a aLayerMask,
+     * sorted in m_Track order.
+     * @param aWithVias true to also collect the vias found at \a aPosition, on any layer.
+     */
+    void QueryTracks( const wxPoint& aPosition, LAYER_MSK aLayerMask,
+                      std::vector<TRACK*>& aResult, bool aWithVias = false );
+
+    /**
+     * Function QueryVias
+     * collects the vias found at \a aPosition, sorted in m_Track order.
+     */
+    void QueryVias( const wxPoint& aPosition, std::vector<TRACK*>& aResult );
+
+    /**
+     * Function QueryModules
+     * collects the footprints whose boundary box contains \a aPosition, sorted in
+     * m_Modules order.
+     */
+    void QueryModules( const wxPoint& aPosition, std::vector<MODULE*>& aResult );
+
+    /**
+     * Function QueryPads
+     * collects the pads whose bounding circle contains \a aPosition, sorted in
+     * m_Modules order, then in pad list order.
+     */
+    void QueryPads( const wxPoint& aPosition, std::vector<D_PAD*>& aResult );
+
+    /**
+     * Function Clear
+     * empties the index.  It is rebuilt by the next query.
+     */
+    void Clear();
+
+private:
+    typedef RTree<TRACK*, int, 2, float>    TRACK_RTREE;
+    typedef RTree<MODULE*, int, 2, float>   MODULE_RTREE;
+    typedef RTree<D_PAD*, int, 2, float>    PAD_RTREE;
+
+    struct TRACK_ENTRY
+    {
+        EDA_RECT    m_Area;         ///< the area in the tree
+        TRACK_RTREE* m_Tree;        ///< the tree holding the track, NULL if not in a tree
+        double      m_Rank;         ///< order key in m_Track
+    };
+
+    struct MODULE_ENTRY
+    {
+        EDA_RECT    m_Area;         ///< the area in the tree
+        bool        m_InTree;       ///< false when the footprint is tested linearly
+        double      m_Rank;         ///< order key in m_Modules
+        unsigned    m_PadListChangeCount;   ///< change count of the pad list when indexed
+        std::vector< std::pair<D_PAD*, EDA_RECT> > m_Pads;  ///< pads in the tree and their
+                                                            ///< area (can be deleted since)
+    };
+
+    void build();
+    void update();
+
+    void addTrack( TRACK* aTrack );
+    void removeTrack( TRACK* aTrack );
+    void anchorTrack( TRACK* aTrack );
+    void floatTrack( TRACK* aTrack );
+
+    void addModule( MODULE* aModule );
+    void removeModule( MODULE* aModule );
+    void anchorModule( MODULE* aModule );
+    void floatModule( MODULE* aModule );
+    void removePads( MODULE* aModule );
+    void insertPads( MODULE* aModule );
+
+    void renumberTracks();
+    void renumberModules();
+    void recordChangeCounts();
+
+    TRACK_RTREE* trackTree( TRACK* aTrack );
+    void collectTracks( TRACK_RTREE* aTree, const wxPoint& aPosition,
+                        std::vector<TRACK*>& aResult );
+    void sortTracks( std::vector<TRACK*>& aTracks );
+
+    static bool isChanging( BOARD_ITEM* aItem );
+    static EDA_RECT trackArea( TRACK* aTrack );
+    static EDA_RECT padArea( D_PAD* aPad );
+
+    BOARD*                  m_board;
+    bool                    m_isBuilt;
+    unsigned                m_trackListChangeCount;
+    unsigned                m_moduleListChangeCount;
+
+    TRACK_RTREE*            m_trackTrees[NB_LAYERS];
+    TRACK_RTREE*            m_viaTree;
+    MODULE_RTREE*           m_moduleTree;
+    PAD_RTREE*              m_padTree;
+
+    std::map<TRACK*, TRACK_ENTRY>   m_tracks;
+    std::map<MODULE*, MODULE_ENTRY> m_modules;
+    std::map<D_PAD*, MODULE*>       m_padModules;   ///< the footprint of the pads in the tree
+
+    std::set<TRACK*>        m_floatingTracks;   ///< items changing, tested linearly
+    std::set<MODULE*>       m_floatingModules;
+};
+
+#endif  // BOARD_SPATIAL_INDEX_H
@@ -27,6 +27,7 @@
 #include <class_drawpanel.h>
 #include <class_drawpanel_gal.h>
 #include <macros.h>
+#include <trigo.h>
 
 #include <pcbnew.h>
 #include <wxPcbStruct.h>
@@ -290,6 +291,63 @@ void BOARD_ITEM::SwapData( BOARD_ITEM* aImage )
 }
 
 
+/* Records for the DRC the area aItem covered before aCommand, because some callers save
+ * the command only after doing it (eg. block move or footprint placement).  For a changed
+ * item the area of the copy kept in aLink is used, else the current area of the item is
+ * transformed back like PutDataInPreviousState() would do.
+ */
+static void setDrcDirtyPreviousArea( BOARD* aBoard, BOARD_ITEM* aItem, BOARD_ITEM* aLink,
+                                     UNDO_REDO_T aCommand, const wxPoint& aTransformPoint,
+                                     double aRotationAngle )
+{
+    EDA_RECT area;
+
+    if( aCommand == UR_CHANGED )
+    {
+        if( aLink && BOARD::GetDrcArea( aLink, area ) )
+            aBoard->SetDrcDirtyArea( area );
+
+        return;
+    }
+
+    if( aCommand != UR_MOVED && aCommand != UR_ROTATED && aCommand != UR_ROTATED_CLOCKWISE
+        && aCommand != UR_FLIPPED )
+        return;
+
+    if( !BOARD::GetDrcArea( aItem, area ) )
+        return;
+
+    wxPoint corners[2] = { area.GetOrigin(), area.GetEnd() };
+
+    for( int ii = 0; ii < 2; ++ii )
+    {
+        switch( aCommand )
+        {
+        case UR_MOVED:
+            corners[ii] -= aTransformPoint;
+            break;
+
+        case UR_ROTATED:
+            RotatePoint( &corners[ii], aTransformPoint, -aRotationAngle );
+            break;
+
+        case UR_ROTATED_CLOCKWISE:
+            RotatePoint( &corners[ii], aTransformPoint, aRotationAngle );
+            break;
+
+        default:    // UR_FLIPPED: mirrored around the horizontal axis of the flip point
+            corners[ii].y = aTransformPoint.y - ( corners[ii].y - aTransformPoint.y );
+            break;
+        }
+    }
+
+    // A box rotated by a multiple of 90 degrees is still a box with these corners
+    area = EDA_RECT( corners[0], wxSize( 0, 0 ) );
+    area.Merge( corners[1] );
+    aBoard->SetDrcDirtyArea( area );
+}
+
+
 void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
                                          UNDO_REDO_T    aCommandType,
                                          const wxPoint& aTransformPoint )
@@ -314,6 +372,10 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
 
     ITEM_PICKER itemWrapper( aItem, aCommandType );
 
+    // The item is about to be changed: record its current area for the DRC
+    GetBoard()->SetDrcDirty( aItem );
+    GetBoard()->ItemChanging( aItem );
+
     switch( aCommandType )
     {
     case UR_CHANGED:                        // Create a copy of item
@@ -347,6 +409,11 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
     break;
     }
 
+    BOARD_ITEM* link = (BOARD_ITEM*) itemWrapper.GetLink();
+
+    setDrcDirtyPreviousArea( GetBoard(), aItem, link, aCommandType, aTransformPoint,
+                             m_rotationAngle );
+
     if( commandToUndo->GetCount() )
     {
         /* Save the copy in undo list */
@@ -401,6 +468,10 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsList,
 
         wxASSERT( item );
 
+        // The item is about to be changed: record its current area for the DRC
+        GetBoard()->SetDrcDirty( item );
+        GetBoard()->ItemChanging( item );
+
         switch( command )
         {
         case UR_CHANGED:
@@ -431,6 +502,11 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsList,
         break;
 
         }
+
+        BOARD_ITEM* link = (BOARD_ITEM*) commandToUndo->GetPickedItemLink( ii );
+
+        setDrcDirtyPreviousArea( GetBoard(), item, link, command, aTransformPoint,
+                                 m_rotationAngle );
     }
 
     if( commandToUndo->GetCount() )
@@ -497,6 +573,10 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
 
         item->ClearFlags();
 
+        // The item area changes: the next incremental DRC must test it
+        GetBoard()->SetDrcDirty( item );
+        GetBoard()->ItemChanging( item );
+
         // see if we must rebuild ratsnets and pointers lists
         switch( item->Type() )
         {
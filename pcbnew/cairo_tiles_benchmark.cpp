@@ -0,0 +1,292 @@
+/**
+ * @file cairo_tiles_benchmark.cpp
+ * @brief Measures caching the items of a board in CAIRO_GAL, and compares drawing the
+ * board in one piece and in tiles.
+ *
+ * Usage: cairo_tiles_benchmark board1.kicad_pcb [board2.kicad_pcb ...]
+ *
+ * Each board is loaded in a VIEW drawn by a CAIRO_GAL of 1600x1200 pixels, and all
+ * its items are cached several times by VIEW::RecacheAllItems(): this prints the count
+ * of items and the mean time of a recache, to compare the recache times by board size.
+ * The board is then drawn at several zoom levels, from the whole board to a small part
+ * of it, once without and once with the tiled rendering.  For each board and zoom level,
+ * this prints the mean time of a frame in both modes, and the count
+ * of pixels which differ between the last frames drawn in both modes.  The program fails
+ * if this count is not 0.
+ *
+ * The program does not wait for any user input, but a GAL window needs a display: on a
+ * machine without one, run it in a virtual X server (xvfb-run cairo_tiles_benchmark ...).
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include <fctsys.h>
+#include <wx/init.h>
+#include <wx/app.h>
+#include <wx/frame.h>
+#include <wx/dcclient.h>
+#include <wx/dcmemory.h>
+#include <common.h>
+#include <io_mgr.h>
+
+#include <class_board.h>
+
+#include <view/view.h>
+#include <gal/cairo/cairo_gal.h>
+#include <pcb_painter.h>
+#include <standalone_pgm.h>
+
+
+static const int SCREEN_WIDTH  = 1600;
+static const int SCREEN_HEIGHT = 1200;
+static const int FRAME_COUNT   = 10;
+static const int RECACHE_COUNT = 5;
+
+// Zoom levels, relative to the zoom showing the whole board
+static const double zoomLevels[] = { 1.0, 4.0, 16.0, 64.0 };
+
+// Biggest difference of a color component between two pixels seen as identical
+// (the antialiasing on the tile borders can round differently)
+static const int PIXEL_TOLERANCE = 2;
+
+
+class BENCHMARK_APP : public wxApp
+{
+public:
+    bool OnInit()
+    {
+        return true;
+    }
+};
+
+IMPLEMENT_APP_NO_MAIN( BENCHMARK_APP )
+
+
+/* Draws aCount frames, as EDA_DRAW_PANEL_GAL::onPaint() does, and returns the mean time
+ * of a frame in ms
+ */
+static double drawFrames( KIGFX::CAIRO_GAL* aGal, KIGFX::VIEW* aView, int aCount )
+{
+    unsigned startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        aView->MarkDirty();
+
+        aGal->BeginDrawing();
+        aGal->SetBackgroundColor( KIGFX::COLOR4D( 0.0, 0.0, 0.0, 1.0 ) );
+        aGal->ClearScreen();
+
+        aView->ClearTargets();
+        aView->Redraw();
+
+        aGal->EndDrawing();
+    }
+
+    return ( GetRunningMicroSecs() - startTime ) / 1000.0 / aCount;
+}
+
+
+/* Reads back the part of the last drawn frame visible in the parent window
+ */
+static wxImage grabFrame( KIGFX::CAIRO_GAL* aGal )
+{
+    wxSize size = aGal->GetParent()->GetClientSize();
+
+    size.x = std::min( size.x, SCREEN_WIDTH );
+    size.y = std::min( size.y, SCREEN_HEIGHT );
+
+    wxClientDC clientDC( aGal );
+    wxBitmap   bitmap( size.x, size.y );
+    wxMemoryDC memoryDC( bitmap );
+
+    memoryDC.Blit( 0, 0, size.x, size.y, &clientDC, 0, 0 );
+    memoryDC.SelectObject( wxNullBitmap );
+
+    return bitmap.ConvertToImage();
+}
+
+
+/* Returns the count of pixels which differ between aImage1 and aImage2
+ */
+static unsigned compareFrames( const wxImage& aImage1, const wxImage& aImage2 )
+{
+    if( aImage1.GetSize() != aImage2.GetSize() )
+        return aImage1.GetWidth() * aImage1.GetHeight();
+
+    const unsigned char* data1 = aImage1.GetData();
+    const unsigned char* data2 = aImage2.GetData();
+    unsigned pixelCount = aImage1.GetWidth() * aImage1.GetHeight();
+    unsigned diffCount = 0;
+
+    for( unsigned ii = 0; ii < pixelCount; ii++, data1 += 3, data2 += 3 )
+    {
+        for( int c = 0; c < 3; c++ )
+        {
+            if( std::abs( (int) data1[c] - (int) data2[c] ) > PIXEL_TOLERANCE )
+            {
+                diffCount++;
+                break;
+            }
+        }
+    }
+
+    return diffCount;
+}
+
+
+static bool benchmarkBoard( const wxString& aFileName, wxFrame* aFrame )
+{
+    BOARD* board;
+
+    try
+    {
+        IO_MGR::PCB_FILE_T fileType = aFileName.EndsWith( wxT( ".kicad_pcb" ) ) ?
+                                      IO_MGR::KICAD : IO_MGR::LEGACY;
+
+        board = IO_MGR::Load( fileType, aFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return false;
+    }
+
+    KIGFX::CAIRO_GAL* gal = new KIGFX::CAIRO_GAL( aFrame );
+
+    gal->SetWorldUnitLength( 1.0 / 1e9 * 2.54 );    // 1 inch in nanometers
+    gal->SetScreenDPI( 106 );
+    gal->ResizeScreen( SCREEN_WIDTH, SCREEN_HEIGHT );
+    gal->SetCursorEnabled( false );
+
+    KIGFX::PCB_PAINTER* painter = new KIGFX::PCB_PAINTER( gal );
+    KIGFX::VIEW*        view = new KIGFX::VIEW( false );
+
+    view->SetPainter( painter );
+    view->SetGAL( gal );
+    view->SetScaleLimits( 1e6, 1e-3 );
+
+    std::vector<KIGFX::VIEW_ITEM*> items;
+    board->GetViewItems( items );
+
+    view->Add( items );
+    view->RecacheAllItems( true );      // first recache not counted
+
+    unsigned startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < RECACHE_COUNT; ++ii )
+        view->RecacheAllItems( true );
+
+    double recacheTime = ( GetRunningMicroSecs() - startTime ) / 1000.0 / RECACHE_COUNT;
+
+    printf( "%s\titems %u\trecache %.3f ms\n",
+            TO_UTF8( aFileName ), (unsigned) items.size(), recacheTime );
+
+    // The zoom showing the whole board
+    EDA_RECT bbox = board->ComputeBoundingBox();
+    bool     identical = true;
+
+    view->SetScale( 1.0 );
+    double fitScale = std::min( SCREEN_WIDTH / view->ToScreen( bbox.GetWidth(), false ),
+                                SCREEN_HEIGHT / view->ToScreen( bbox.GetHeight(), false ) );
+
+    for( unsigned ii = 0; ii < sizeof(zoomLevels) / sizeof(zoomLevels[0]); ++ii )
+    {
+        view->SetScale( fitScale * zoomLevels[ii] );
+        view->SetCenter( VECTOR2D( bbox.Centre() ) );
+
+        gal->SetTiledRendering( false );
+        drawFrames( gal, view, 1 );     // first frame not counted
+        double serialTime = drawFrames( gal, view, FRAME_COUNT );
+        wxImage serialFrame = grabFrame( gal );
+
+        gal->SetTiledRendering( true );
+        drawFrames( gal, view, 1 );
+        double tiledTime = drawFrames( gal, view, FRAME_COUNT );
+        wxImage tiledFrame = grabFrame( gal );
+
+        unsigned diffCount = compareFrames( serialFrame, tiledFrame );
+
+        if( diffCount )
+            identical = false;
+
+        printf( "%s\titems %u\tzoom x%g\tserial %.3f ms\ttiled %.3f ms\tratio %.2f"
+                "\tdiff %u px\n",
+                TO_UTF8( aFileName ), (unsigned) items.size(), zoomLevels[ii],
+                serialTime, tiledTime, tiledTime > 0.0 ? serialTime / tiledTime : 0.0,
+                diffCount );
+    }
+
+    delete view;
+    delete painter;
+    delete gal;
+    delete board;
+
+    if( !identical )
+        fprintf( stderr, "%s: the tiled and serial frames differ\n", TO_UTF8( aFileName ) );
+
+    return identical;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s board.kicad_pcb [board.kicad_pcb ...]\n", argv[0] );
+        return 1;
+    }
+
+    if( !wxEntryStart( argc, argv ) || !wxTheApp->CallOnInit() )
+    {
+        fprintf( stderr, "error: cannot initialize the display\n" );
+        return 1;
+    }
+
+    SetLocaleTo_C_standard();
+    InitStandalonePgm();
+
+    // The GAL needs a realized parent window to draw on
+    wxFrame* frame = new wxFrame( NULL, wxID_ANY, wxT( "cairo_tiles_benchmark" ),
+                                  wxDefaultPosition, wxSize( SCREEN_WIDTH, SCREEN_HEIGHT ) );
+    frame->Show();
+
+    int result = 0;
+
+    for( int ii = 1; ii < argc; ii++ )
+    {
+        if( !benchmarkBoard( FROM_UTF8( argv[ii] ), frame ) )
+            result = 1;
+    }
+
+    frame->Destroy();
+    wxEntryCleanup();
+
+    return result;
+}
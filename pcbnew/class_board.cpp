@@ -45,6 +45,8 @@
 #include <ratsnest_data.h>
 #include <ratsnest_viewitem.h>
 #include <worksheet_viewitem.h>
+#include <board_spatial_index.h>
+#include <track_snapshot.h>
 
 #include <pcbnew.h>
 #include <colors_selection.h>
@@ -80,6 +82,8 @@ BOARD::BOARD() :
     m_CurrentZoneContour = NULL;            // This ZONE_CONTAINER handle the
                                             // zone contour currently in progress
 
+    m_drcDirtyRecording = false;            // Nothing to record before a DRC run
+
     BuildListOfNets();                      // prepare pad and netlist containers.
 
     for( LAYER_NUM layer = FIRST_LAYER; layer < NB_LAYERS; ++layer )
@@ -110,6 +114,8 @@ BOARD::BOARD() :
     m_ratsnest = new RN_DATA( this );
     m_ratsnestViewItem = new KIGFX::RATSNEST_VIEWITEM( m_ratsnest );
 
+    m_spatialIndex = new BOARD_SPATIAL_INDEX( this );
+
     // Initialize view item for displaying worksheet frame
     m_worksheetViewItem = new KIGFX::WORKSHEET_VIEWITEM( &m_paper, &m_titles );
     m_worksheetViewItem->SetFileName( std::string( m_fileName.mb_str() ) );
@@ -127,6 +133,7 @@ BOARD::~BOARD()
     delete m_worksheetViewItem;
     delete m_ratsnestViewItem;
     delete m_ratsnest;
+    delete m_spatialIndex;
 
     m_FullRatsnest.clear();
     m_LocalRatsnest.clear();
@@ -187,6 +194,9 @@ void BOARD::Move( const wxPoint& aMoveVector )        // overload
 
     // visit this BOARD with the above inspector, which moves all items.
     Visit( &inspector, &aMoveVector, top_level_board_stuff );
+
+    // All positions have changed: the index is rebuilt by the next query
+    m_spatialIndex->Clear();
 }
 
 
@@ -785,6 +795,9 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
         return;
     }
 
+    // The index can follow the change only if it matches the lists before it
+    bool indexSynced = m_spatialIndex->IsSynced();
+
     switch( aBoardItem->Type() )
     {
     // this one uses a vector
@@ -852,6 +865,11 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
         break;
     }
 
+    SetDrcDirty( aBoardItem );
+
+    if( indexSynced )
+        m_spatialIndex->Add( aBoardItem );
+
     m_ratsnest->Add( aBoardItem );
 }
 
@@ -861,6 +879,8 @@ BOARD_ITEM* BOARD::Remove( BOARD_ITEM* aBoardItem )
     // find these calls and fix them!  Don't send me no stinking' NULL.
     wxASSERT( aBoardItem );
 
+    bool indexSynced = m_spatialIndex->IsSynced();
+
     switch( aBoardItem->Type() )
     {
     case PCB_MARKER_T:
@@ -916,12 +936,58 @@ BOARD_ITEM* BOARD::Remove( BOARD_ITEM* aBoardItem )
         wxFAIL_MSG( wxT( "BOARD::Remove() needs more ::Type() support" ) );
     }
 
+    SetDrcDirty( aBoardItem );
+    m_drcDirtyItems.erase( aBoardItem );
+
+    if( indexSynced )
+        m_spatialIndex->Remove( aBoardItem );
+
     m_ratsnest->Remove( aBoardItem );
 
     return aBoardItem;
 }
 
 
+void BOARD::GetViewItems( std::vector<KIGFX::VIEW_ITEM*>& aItems ) const
+{
+    // Zones
+    for( int i = 0; i < GetAreaCount(); ++i )
+        aItems.push_back( GetArea( i ) );
+
+    // Drawings
+    for( BOARD_ITEM* drawing = m_Drawings; drawing; drawing = drawing->Next() )
+        aItems.push_back( drawing );
+
+    // Tracks
+    for( TRACK* track = m_Track; track; track = track->Next() )
+        aItems.push_back( track );
+
+    // Modules and their additional elements
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        // Module's pads
+        for( D_PAD* pad = module->Pads().GetFirst(); pad; pad = pad->Next() )
+            aItems.push_back( pad );
+
+        // Module's drawings (mostly silkscreen)
+        for( BOARD_ITEM* drawing = module->GraphicalItems().GetFirst(); drawing;
+             drawing = drawing->Next() )
+            aItems.push_back( drawing );
+
+        // Module's texts (name and value)
+        aItems.push_back( &module->Reference() );
+        aItems.push_back( &module->Value() );
+
+        // The module itself
+        aItems.push_back( module );
+    }
+
+    // Segzones (equivalent of ZONE_CONTAINER for legacy boards)
+    for( SEGZONE* zone = m_Zone; zone; zone = zone->Next() )
+        aItems.push_back( zone );
+}
+
+
 void BOARD::DeleteMARKERs()
 {
     // the vector does not know how to delete the MARKER_PCB, it holds pointers
@@ -932,6 +998,102 @@ void BOARD::DeleteMARKERs()
 }
 
 
+// Above these counts, the changes are forgotten and the next DRC is a full one
+static const unsigned MAX_DRC_DIRTY_AREAS = 256;
+static const unsigned MAX_DRC_DIRTY_ITEMS = 4096;
+
+
+bool BOARD::GetDrcArea( BOARD_ITEM* aItem, EDA_RECT& aArea )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_ZONE_AREA_T:
+        aArea = aItem->GetBoundingBox();
+        break;
+
+    case PCB_MODULE_T:
+        // The footprint bounding box can be outdated, but the pads are always right
+        {
+            MODULE* module = (MODULE*) aItem;
+
+            aArea = EDA_RECT( module->GetPosition(), wxSize( 0, 0 ) );
+
+            for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+                aArea.Merge( pad->GetBoundingBox() );
+        }
+        break;
+
+    default:    // Not a copper item: nothing to test
+        return false;
+    }
+
+    aArea.Normalize();
+    return true;
+}
+
+
+void BOARD::SetDrcDirty( BOARD_ITEM* aItem )
+{
+    if( !m_drcDirtyRecording )
+        return;
+
+    EDA_RECT area;
+
+    if( !GetDrcArea( aItem, area ) )
+        return;
+
+    m_drcDirtyItems.insert( aItem );
+    SetDrcDirtyArea( area );
+}
+
+
+void BOARD::SetDrcDirtyArea( const EDA_RECT& aArea )
+{
+    if( !m_drcDirtyRecording )
+        return;
+
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    // Merge the area into the first one it intersects, most changes are local
+    std::vector<EDA_RECT>::iterator it;
+
+    for( it = m_drcDirtyAreas.begin(); it != m_drcDirtyAreas.end(); ++it )
+    {
+        if( it->Intersects( area ) )
+        {
+            it->Merge( area );
+            break;
+        }
+    }
+
+    if( it == m_drcDirtyAreas.end() )
+        m_drcDirtyAreas.push_back( area );
+
+    if( m_drcDirtyAreas.size() > MAX_DRC_DIRTY_AREAS ||
+        m_drcDirtyItems.size() > MAX_DRC_DIRTY_ITEMS )
+    {
+        ClearDrcDirty( false );
+    }
+}
+
+
+void BOARD::ItemChanging( BOARD_ITEM* aItem )
+{
+    m_spatialIndex->ItemChanging( aItem );
+}
+
+
+void BOARD::ClearDrcDirty( bool aRecord )
+{
+    m_drcDirtyAreas.clear();
+    m_drcDirtyItems.clear();
+    m_drcDirtyRecording = aRecord;
+}
+
+
 void BOARD::DeleteZONEOutlines()
 {
     // the vector does not know how to delete the ZONE Outlines, it holds
@@ -1563,12 +1725,13 @@ int BOARD::SetAreasNetCodesFromNetNames( void )
 
 TRACK* BOARD::GetViaByPosition( const wxPoint& aPosition, LAYER_NUM aLayer)
 {
-    TRACK* track;
+    std::vector<TRACK*> vias;
+
+    m_spatialIndex->QueryVias( aPosition, vias );
 
-    for( track = m_Track;  track; track = track->Next() )
+    for( unsigned ii = 0; ii < vias.size(); ++ii )
     {
-        if( track->Type() != PCB_VIA_T )
-            continue;
+        TRACK* track = vias[ii];
 
         if( track->GetStart() != aPosition )
             continue;
@@ -1576,36 +1739,42 @@ TRACK* BOARD::GetViaByPosition( const wxPoint& aPosition, LAYER_NUM aLayer)
         if( track->GetState( BUSY | IS_DELETED ) )
             continue;
 
-        if( aLayer == UNDEFINED_LAYER )
-            break;
-
-        if( track->IsOnLayer( aLayer ) )
-            break;
+        if( aLayer == UNDEFINED_LAYER || track->IsOnLayer( aLayer ) )
+            return track;
     }
 
-    return track;
+    return NULL;
 }
 
 
 D_PAD* BOARD::GetPad( const wxPoint& aPosition, LAYER_MSK aLayerMask )
 {
-    D_PAD* pad = NULL;
+    if( aLayerMask == 0 )
+        aLayerMask = ALL_LAYERS;
+
+    // The candidates are sorted by footprint, then in pad list order: the first
+    // pad hit is the one a walk through the footprints would find.
+    std::vector<D_PAD*> pads;
+
+    m_spatialIndex->QueryPads( aPosition, pads );
 
-    for( MODULE* module = m_Modules;  module && ( pad == NULL );  module = module->Next() )
+    for( unsigned ii = 0; ii < pads.size(); ++ii )
     {
-        if( aLayerMask )
-            pad = module->GetPad( aPosition, aLayerMask );
-        else
-            pad = module->GetPad( aPosition, ALL_LAYERS );
+        D_PAD* pad = pads[ii];
+
+        if( ( pad->GetLayerMask() & aLayerMask ) == 0 )
+            continue;
+
+        if( pad->HitTest( aPosition ) )
+            return pad;
     }
 
-    return pad;
+    return NULL;
 }
 
 
 D_PAD* BOARD::GetPad( TRACK* aTrace, int aEndPoint )
 {
-    D_PAD*  pad = NULL;
     wxPoint aPosition;
 
     LAYER_MSK aLayerMask = GetLayerMask( aTrace->GetLayer() );
@@ -1619,15 +1788,7 @@ D_PAD* BOARD::GetPad( TRACK* aTrace, int aEndPoint )
         aPosition = aTrace->GetEnd();
     }
 
-    for( MODULE* module = m_Modules;  module;  module = module->Next() )
-    {
-        pad = module->GetPad( aPosition, aLayerMask );
-
-        if( pad != NULL )
-            break;
-    }
-
-    return pad;
+    return GetPad( aPosition, aLayerMask );
 }
 
 
@@ -1777,31 +1938,55 @@ void BOARD::GetSortedPadListByXthenYCoord( std::vector<D_PAD*>& aVector, int aNe
 }
 
 
+void BOARD::BuildTrackSnapshot( TRACK_SNAPSHOT& aSnapshot ) const
+{
+    aSnapshot.Build( m_Track );
+}
+
+
+/* Test used by BOARD::GetTrace() for each segment or via
+ */
+static bool isTraceHit( BOARD* aBoard, TRACK* aTrack, const wxPoint& aPosition,
+                        LAYER_MSK aLayerMask )
+{
+    LAYER_NUM layer = aTrack->GetLayer();
+
+    if( aTrack->GetState( BUSY | IS_DELETED ) )
+        return false;
+
+    if( aBoard->IsLayerVisible( layer ) == false )
+        return false;
+
+    if( aTrack->Type() != PCB_VIA_T && (GetLayerMask( layer ) & aLayerMask) == 0 )
+        return false;   /* Segments on different layers. */
+
+    return aTrack->HitTest( aPosition );
+}
+
+
 TRACK* BOARD::GetTrace( TRACK* aTrace, const wxPoint& aPosition, LAYER_MSK aLayerMask )
 {
-    for( TRACK* track = aTrace;   track;  track =  track->Next() )
+    // A search from the beginning of the list only needs the indexed candidates,
+    // which are given in list order.
+    if( aTrace && aTrace == m_Track )
     {
-        LAYER_NUM layer = track->GetLayer();
+        std::vector<TRACK*> candidates;
 
-        if( track->GetState( BUSY | IS_DELETED ) )
-            continue;
-
-        if( m_designSettings.IsLayerVisible( layer ) == false )
-            continue;
+        m_spatialIndex->QueryTracks( aPosition, aLayerMask, candidates, true );
 
-        if( track->Type() == PCB_VIA_T )    /* VIA encountered. */
+        for( unsigned ii = 0; ii < candidates.size(); ++ii )
         {
-            if( track->HitTest( aPosition ) )
-                return track;
+            if( isTraceHit( this, candidates[ii], aPosition, aLayerMask ) )
+                return candidates[ii];
         }
-        else
-        {
-            if( (GetLayerMask( layer ) & aLayerMask) == 0 )
-                continue;   /* Segments on different layers. */
 
-            if( track->HitTest( aPosition ) )
-                return track;
-        }
+        return NULL;
+    }
+
+    for( TRACK* track = aTrace;   track;  track =  track->Next() )
+    {
+        if( isTraceHit( this, track, aPosition, aLayerMask ) )
+            return track;
     }
 
     return NULL;
@@ -2058,8 +2243,15 @@ MODULE* BOARD::GetFootprint( const wxPoint& aPosition, LAYER_NUM aActiveLayer,
     int     alt_min_dim = 0x7FFFFFFF;
     bool    current_layer_back = IsBackLayer( aActiveLayer );
 
-    for( pt_module = m_Modules;  pt_module;  pt_module = (MODULE*) pt_module->Next() )
+    // The footprints whose bounds contain the ref point, in list order
+    std::vector<MODULE*> candidates;
+
+    m_spatialIndex->QueryModules( aPosition, candidates );
+
+    for( unsigned ii = 0; ii < candidates.size(); ++ii )
     {
+        pt_module = candidates[ii];
+
         // is the ref point within the module's bounds?
         if( !pt_module->HitTest( aPosition ) )
             continue;
@@ -2118,21 +2310,39 @@ MODULE* BOARD::GetFootprint( const wxPoint& aPosition, LAYER_NUM aActiveLayer,
 
 BOARD_CONNECTED_ITEM* BOARD::GetLockPoint( const wxPoint& aPosition, LAYER_MSK aLayerMask )
 {
-    for( MODULE* module = m_Modules; module; module = module->Next() )
+    // Without layer, no pad and no segment end can be found, but GetPad()
+    // would search all layers.
+    if( aLayerMask )
     {
-        D_PAD* pad = module->GetPad( aPosition, aLayerMask );
+        D_PAD* pad = GetPad( aPosition, aLayerMask );
 
         if( pad )
             return pad;
     }
 
-    /* No pad has been located so check for a segment of the trace. */
-    TRACK* segment = ::GetTrace( m_Track, NULL, aPosition, aLayerMask );
+    /* No pad has been located so check for a segment of the trace.
+     * A segment ending at aPosition is in the candidates of the index, so this is
+     * the search of ::GetTrace( m_Track, NULL, aPosition, aLayerMask ).
+     */
+    std::vector<TRACK*> candidates;
 
-    if( segment == NULL )
-        segment = GetTrace( m_Track, aPosition, aLayerMask );
+    m_spatialIndex->QueryTracks( aPosition, aLayerMask, candidates, true );
+
+    for( unsigned ii = 0; ii < candidates.size(); ++ii )
+    {
+        TRACK* track = candidates[ii];
+
+        if( track->GetState( IS_DELETED | BUSY ) )
+            continue;
+
+        if( ( aLayerMask & track->GetLayerMask() ) == 0 )
+            continue;
+
+        if( aPosition == track->GetStart() || aPosition == track->GetEnd() )
+            return track;
+    }
 
-    return segment;
+    return GetTrace( m_Track, aPosition, aLayerMask );
 }
 
 
@@ -31,6 +31,8 @@
 #define CLASS_BOARD_H_
 
 
+#include <set>
+
 #include <dlist.h>
 
 #include <common.h>                         // PAGE_INFO
@@ -57,11 +59,14 @@ class MSG_PANEL_ITEM;
 class NETLIST;
 class REPORTER;
 class RN_DATA;
+class BOARD_SPATIAL_INDEX;
+class TRACK_SNAPSHOT;
 
 namespace KIGFX
 {
     class RATSNEST_VIEWITEM;
     class WORKSHEET_VIEWITEM;
+    class VIEW_ITEM;
 }
 
 
@@ -221,6 +226,17 @@ private:
     /// edge zone descriptors, owned by pointer.
     ZONE_CONTAINERS         m_ZoneDescriptorList;
 
+    /// Areas of the copper items added, modified or removed since the last DRC run
+    std::vector<EDA_RECT>   m_drcDirtyAreas;
+
+    /// Copper items added or modified since the last DRC run (non-owning, some
+    /// of them can have been deleted since)
+    std::set<BOARD_ITEM*>   m_drcDirtyItems;
+
+    /// True when the changes are recorded for an incremental DRC, i.e. after a DRC
+    /// run and until too many changes are recorded
+    bool                    m_drcDirtyRecording;
+
     LAYER                   m_Layer[NB_LAYERS];
 
     wxPoint                 m_grid_origin;
@@ -233,6 +249,7 @@ private:
     EDA_RECT                m_BoundingBox;
     NETINFO_LIST            m_NetInfo;              ///< net info list (name, design constraints ..
     RN_DATA*                m_ratsnest;
+    BOARD_SPATIAL_INDEX*    m_spatialIndex;         ///< position index of tracks, vias and pads
     KIGFX::RATSNEST_VIEWITEM* m_ratsnestViewItem;   ///< VIEW_ITEM that draws ratsnest
     KIGFX::WORKSHEET_VIEWITEM* m_worksheetViewItem; ///< VIEW_ITEM that draws worksheet frame
 
@@ -393,6 +410,15 @@ public:
         return m_worksheetViewItem;
     }
 
+    /**
+     * Function GetViewItems
+     * collects the board items drawn in a VIEW: zones, drawings, tracks, footprints
+     * with their pads, drawings and texts, and legacy zone segments.  The worksheet
+     * and ratsnest VIEW_ITEMs are not collected.
+     * @param aItems The vector to which the items are appended.
+     */
+    void GetViewItems( std::vector<KIGFX::VIEW_ITEM*>& aItems ) const;
+
     /**
      * Function DeleteMARKERs
      * deletes ALL MARKERS from the board.
@@ -405,6 +431,76 @@ public:
      */
     void DeleteZONEOutlines();
 
+    /**
+     * Function SetDrcDirty
+     * records that a copper item (track, via, footprint or zone) is added, removed
+     * or about to be modified, so that an incremental DRC rechecks its neighbourhood.
+     * The area currently covered by the item is stored, and the item itself is
+     * remembered to read its final area when the DRC runs.
+     * Called by Add(), Remove() and the undo/redo functions.
+     * @param aItem The item which changes.
+     */
+    void SetDrcDirty( BOARD_ITEM* aItem );
+
+    /**
+     * Function SetDrcDirtyArea
+     * records that the copper in \a aArea changed, without any item to read again
+     * when the DRC runs.  Used for the area an item left, when it is recorded only
+     * after being moved.
+     * @param aArea The changed area.
+     */
+    void SetDrcDirtyArea( const EDA_RECT& aArea );
+
+    /**
+     * Function GetDrcArea
+     * gives the area an incremental DRC rechecks for a changed item.
+     * @param aItem The item, which can be a copy not on the board.
+     * @param aArea Receives the area of the item.
+     * @return bool - false if the item is not a copper item (track, via, footprint or
+     *  zone), so no DRC is needed for it.
+     */
+    static bool GetDrcArea( BOARD_ITEM* aItem, EDA_RECT& aArea );
+
+    /**
+     * Function ItemChanging
+     * tells the board that \a aItem (a track, via, footprint or pad) is about to be
+     * moved or modified, so that the position queries (GetPad(), GetTrace(),
+     * GetLockPoint() ...) index it again at its new position.
+     * Called by the undo/redo functions.
+     * @param aItem The item which changes.
+     */
+    void ItemChanging( BOARD_ITEM* aItem );
+
+    /**
+     * Function ClearDrcDirty
+     * forgets the changes recorded by SetDrcDirty().
+     * @param aRecord True after a DRC run, to record the next changes for an incremental
+     *  DRC.  False to record nothing until the next DRC run, as for a new or loaded board.
+     */
+    void ClearDrcDirty( bool aRecord );
+
+    /**
+     * Function IsDrcDirtyRecorded
+     * @return true if all the changes since the last DRC run are recorded, false if
+     * no DRC was run on the board or too many changes were made since.  In the last
+     * case, an incremental DRC would not be faster than a full one.
+     */
+    bool IsDrcDirtyRecorded() const { return m_drcDirtyRecording; }
+
+    /**
+     * Function GetDrcDirtyAreas
+     * @return the areas covered by the changed items when they were recorded.
+     */
+    const std::vector<EDA_RECT>& GetDrcDirtyAreas() const { return m_drcDirtyAreas; }
+
+    /**
+     * Function GetDrcDirtyItems
+     * @return the changed items.  Some of them can have been deleted since they
+     * were recorded, so the caller must check an item is still on the board
+     * before using it.
+     */
+    const std::set<BOARD_ITEM*>& GetDrcDirtyItems() const { return m_drcDirtyItems; }
+
     /**
      * Function GetMARKER
      * returns the MARKER at a given index.
@@ -1235,6 +1331,26 @@ public:
         return (int) m_ZoneDescriptorList.size();
     }
 
+    /**
+     * Function FillZones
+     * fills the zones \a aZones[0] to \a aZones[aCount-1] in parallel, except the ones
+     * whose fill fingerprint shows that nothing was changed since their last fill.
+     * The filled areas of a zone depend only on the board items and on the outlines
+     * of the other zones, not on their filled areas.  Keepout zones cannot be filled.
+     * @param aZones The zones to fill.
+     * @param aCount The count of zones to fill.
+     * @return int - The count of zones actually filled.
+     */
+    int FillZones( ZONE_CONTAINER* const* aZones, int aCount );
+
+    /**
+     * Function FillAllZones
+     * removes the legacy zone segments and fills all the zones which are not keepouts
+     * with FillZones().  It does not update the connections and the ratsnest.
+     * @return int - The count of zones actually filled.
+     */
+    int FillAllZones();
+
     /* Functions used in test, merge and cut outlines */
 
     /**
@@ -1437,6 +1553,15 @@ public:
      */
     void GetSortedPadListByXthenYCoord( std::vector<D_PAD*>& aVector, int aNetCode = -1 );
 
+    /**
+     * Function BuildTrackSnapshot
+     * fills \a aSnapshot with a copy of the geometry of m_Track (segments and vias),
+     * stored in contiguous arrays for the passes which only read the tracks.
+     * The snapshot must be built again when the tracks change.
+     * @param aSnapshot Where to put the track data.
+     */
+    void BuildTrackSnapshot( TRACK_SNAPSHOT& aSnapshot ) const;
+
     /**
      * Function GetTrace
      * find the segment of \a aTrace at \a aPosition on \a aLayer if \a Layer is visible.
@@ -34,6 +34,7 @@
 
 #include <class_board.h>
 #include <string>
+#include <decimal_parser.h>
 
 wxString BOARD_ITEM::ShowShape( STROKE_T aShape )
 {
@@ -86,31 +87,43 @@ wxString BOARD_ITEM::GetLayerName() const
 }
 
 
-std::string BOARD_ITEM::FormatInternalUnits( int aValue )
+int BOARD_ITEM::FormatInternalUnits( int aValue, char* aBuffer )
 {
-#if 1
+    // Nanometres: the same text as below, with integer arithmetic only
+    if( IU_PER_MM == 1e6 )
+        return FormatNanometresAsMillimetres( aValue, aBuffer );
 
-    char    buf[50];
     int     len;
     double  mm = aValue / IU_PER_MM;
 
     if( mm != 0.0 && fabs( mm ) <= 0.0001 )
     {
-        len = sprintf( buf, "%.10f", mm );
+        len = sprintf( aBuffer, "%.10f", mm );
 
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+        while( --len > 0 && aBuffer[len] == '0' )
+            aBuffer[len] = '\0';
 
-        if( buf[len] == '.' )
-            buf[len] = '\0';
+        if( aBuffer[len] == '.' )
+            aBuffer[len] = '\0';
         else
             ++len;
     }
     else
     {
-        len = sprintf( buf, "%.10g", mm );
+        len = sprintf( aBuffer, "%.10g", mm );
     }
 
+    return len;
+}
+
+
+std::string BOARD_ITEM::FormatInternalUnits( int aValue )
+{
+#if 1
+
+    char    buf[FORMAT_IU_MAX_LEN];
+    int     len = FormatInternalUnits( aValue, buf );
+
     return std::string( buf, len );
 
 #else
@@ -179,13 +192,19 @@ std::string BOARD_ITEM::FormatAngle( double aAngle )
 
 std::string BOARD_ITEM::FormatInternalUnits( const wxPoint& aPoint )
 {
-    return FormatInternalUnits( aPoint.x ) + " " + FormatInternalUnits( aPoint.y );
+    char    buf[2 * FORMAT_IU_MAX_LEN];
+    int     len = FormatInternalUnits( aPoint.x, buf );
+
+    buf[len++] = ' ';
+    len += FormatInternalUnits( aPoint.y, buf + len );
+
+    return std::string( buf, len );
 }
 
 
 std::string BOARD_ITEM::FormatInternalUnits( const wxSize& aSize )
 {
-    return FormatInternalUnits( aSize.GetWidth() ) + " " + FormatInternalUnits( aSize.GetHeight() );
+    return FormatInternalUnits( wxPoint( aSize.GetWidth(), aSize.GetHeight() ) );
 }
 
 
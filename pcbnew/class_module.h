@@ -106,6 +106,13 @@ public:
     // Virtual function
     const EDA_RECT GetBoundingBox() const;
 
+    /**
+     * Function GetBoundaryBox
+     * @return the bounding box computed by the last CalculateBoundingBox() call,
+     * which is the area tested by HitTest().
+     */
+    const EDA_RECT& GetBoundaryBox() const      { return m_BoundaryBox; }
+
     DLIST<D_PAD>& Pads()                        { return m_Pads; }
     const DLIST<D_PAD>& Pads() const            { return m_Pads; }
 
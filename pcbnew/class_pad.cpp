@@ -885,6 +885,19 @@ unsigned int D_PAD::ViewGetLOD( int aLayer ) const
 }
 
 
+double D_PAD::ViewGetDetailSize( int aLayer ) const
+{
+    // The pad number and the netname are not bigger than the smaller side of the pad
+    if( IsNetnameLayer( aLayer ) )
+        return std::min( m_Size.x, m_Size.y );
+
+    if( aLayer == ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ) )
+        return std::max( m_Drill.x, m_Drill.y );
+
+    return VIEW_ITEM::ViewGetDetailSize( aLayer );
+}
+
+
 const BOX2I D_PAD::ViewBBox() const
 {
     // Bounding box includes soldermask too
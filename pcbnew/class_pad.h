@@ -423,6 +423,9 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLOD()
     virtual unsigned int ViewGetLOD( int aLayer ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetDetailSize()
+    virtual double ViewGetDetailSize( int aLayer ) const;
+
     /// @copydoc VIEW_ITEM::ViewBBox()
     virtual const BOX2I ViewBBox() const;
 
@@ -203,3 +203,10 @@ EDA_ITEM* TEXTE_PCB::Clone() const
 {
     return new TEXTE_PCB( *this );
 }
+
+
+double TEXTE_PCB::ViewGetDetailSize( int aLayer ) const
+{
+    // A text can be read when its characters can be seen, whatever its length
+    return std::abs( m_Size.y );
+}
@@ -135,6 +135,9 @@ public:
 
     EDA_ITEM* Clone() const;
 
+    /// @copydoc VIEW_ITEM::ViewGetDetailSize()
+    virtual double ViewGetDetailSize( int aLayer ) const;
+
 #if defined(DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const { ShowDummy( os ); }    // override
 #endif
@@ -462,3 +462,10 @@ void TEXTE_MODULE::ViewGetLayers( int aLayers[], int& aCount ) const
 
     aCount = 1;
 }
+
+
+double TEXTE_MODULE::ViewGetDetailSize( int aLayer ) const
+{
+    // A text can be read when its characters can be seen, whatever its length
+    return std::abs( m_Size.y );
+}
@@ -171,6 +171,9 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetDetailSize()
+    virtual double ViewGetDetailSize( int aLayer ) const;
+
 #if defined(DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const { ShowDummy( os ); }    // override
 #endif
@@ -764,6 +764,16 @@ unsigned int TRACK::ViewGetLOD( int aLayer ) const
 }
 
 
+double TRACK::ViewGetDetailSize( int aLayer ) const
+{
+    // The netname is not higher than the track width
+    if( IsNetnameLayer( aLayer ) )
+        return m_Width;
+
+    return VIEW_ITEM::ViewGetDetailSize( aLayer );
+}
+
+
 void SEGVIA::Draw( EDA_DRAW_PANEL* panel, wxDC* aDC, GR_DRAWMODE aDrawMode,
                    const wxPoint& aOffset )
 {
@@ -987,6 +997,15 @@ void SEGVIA::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
+double SEGVIA::ViewGetDetailSize( int aLayer ) const
+{
+    if( aLayer == ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ) )
+        return GetDrillValue();
+
+    return m_Width;
+}
+
+
 // see class_track.h
 void TRACK::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
 {
@@ -338,6 +338,9 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLOD()
     virtual unsigned int ViewGetLOD( int aLayer ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetDetailSize()
+    virtual double ViewGetDetailSize( int aLayer ) const;
+
 #if defined (DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const { ShowDummy( os ); }    // override
 
@@ -425,6 +428,9 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetDetailSize()
+    virtual double ViewGetDetailSize( int aLayer ) const;
+
 #if defined (DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const { ShowDummy( os ); }    // override
 #endif
@@ -55,6 +55,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
 {
     m_CornerSelection = -1;
     m_IsFilled = false;                         // fill status : true when the zone is filled
+    m_fillFingerprint = 0;
     m_FillMode = 0;                             // How to fill areas: 0 = use filled polygons, != 0 fill with segments
     m_priority = 0;
     m_smoothedPoly = NULL;
@@ -80,6 +81,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     // For corner moving, corner index to drag, or -1 if no selection
     m_CornerSelection = -1;
     m_IsFilled = aZone.m_IsFilled;
+    m_fillFingerprint = aZone.m_fillFingerprint;
     m_ZoneClearance = aZone.m_ZoneClearance;     // clearance value
     m_ZoneMinThickness = aZone.m_ZoneMinThickness;
     m_FillMode = aZone.m_FillMode;               // Filling mode (segments/polygons)
@@ -124,6 +126,7 @@ bool ZONE_CONTAINER::UnFill()
     m_FilledPolysList.RemoveAllContours();
     m_FillSegmList.clear();
     m_IsFilled = false;
+    m_fillFingerprint = 0;
 
     return change;
 }
@@ -816,6 +819,7 @@ void ZONE_CONTAINER::Copy( ZONE_CONTAINER* src )
     m_FilledPolysList.Append( src->m_FilledPolysList );
     m_FillSegmList.clear();
     m_FillSegmList = src->m_FillSegmList;
+    m_fillFingerprint = src->m_fillFingerprint;
 }
 
 
@@ -205,6 +205,29 @@ public:
     bool IsFilled() const { return m_IsFilled; }
     void SetIsFilled( bool isFilled ) { m_IsFilled = isFilled; }
 
+    /**
+     * Function BuildFillFingerprint
+     * computes a hash of all the data the filled areas of this zone depend on:
+     * the zone outline and settings, and the board items found inside the zone
+     * bounding box inflated by the biggest clearance, with their clearances.
+     * If the fingerprint did not change since the zone was filled, filling it again
+     * would give the same filled areas.
+     * @param aPcb = the board
+     * @return the fingerprint (never 0)
+     */
+    unsigned long long BuildFillFingerprint( BOARD* aPcb ) const;
+
+    /**
+     * Function GetFillFingerprint
+     * @return the fingerprint of the board when the current filled areas were
+     * calculated, or 0 if not known (not filled, or filled areas modified since)
+     */
+    unsigned long long GetFillFingerprint() const { return m_fillFingerprint; }
+    void SetFillFingerprint( unsigned long long aFingerprint )
+    {
+        m_fillFingerprint = aFingerprint;
+    }
+
     int GetZoneClearance() const { return m_ZoneClearance; }
     void SetZoneClearance( int aZoneClearance ) { m_ZoneClearance = aZoneClearance; }
 
@@ -495,6 +518,7 @@ public:
     void ClearFilledPolysList()
     {
         m_FilledPolysList.RemoveAllContours();
+        m_fillFingerprint = 0;
     }
 
    /**
@@ -615,6 +639,9 @@ private:
     /** True when a zone was filled, false after deleting the filled areas. */
     bool                  m_IsFilled;
 
+    /// Fingerprint of the data used to calculate the filled areas (0 if unknown).
+    unsigned long long    m_fillFingerprint;
+
     ///< Width of the gap in thermal reliefs.
     int                   m_ThermalReliefGap;
 
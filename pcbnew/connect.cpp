@@ -142,92 +142,53 @@ void CONNECTIONS::CollectItemsNearTo( std::vector<CONNECTED_POINT*>& aList,
 {
     /* Search items in m_Candidates that position is <= aDistMax from aPosition
      * (Rectilinear distance)
-     * m_Candidates is sorted by X then Y values, so a fast binary search is used
-     * to locate the "best" entry point in list
-     * The best entry is a pad having its m_Pos.x == (or near) aPosition.x
-     * All candidates are near this candidate in list
-     * So from this entry point, a linear search is made to find all candidates
+     * m_candidatesHash stores the candidates in grid cells, so only the few cells
+     * near aPosition are explored, and candidates are given in m_candidates order
      */
-    int idxmax = m_candidates.size()-1;
-
-    int delta = m_candidates.size();
+    std::vector<int> ids;
 
-    int idx = 0;        // Starting index is the beginning of list
-    while( delta )
-    {
-        // Calculate half size of remaining interval to test.
-        // Ensure the computed value is not truncated (too small)
-        if( (delta & 1) && ( delta > 1 ) )
-            delta++;
-        delta /= 2;
+    m_candidatesHash.Query( aPosition, aDistMax, ids );
 
-        CONNECTED_POINT& item = m_candidates[idx];
+    for( unsigned ii = 0; ii < ids.size(); ii++ )
+        aList.push_back( &m_candidates[ ids[ii] ] );
+}
 
-        int dist = item.GetPoint().x - aPosition.x;
-        if( abs(dist) <= aDistMax )
-        {
-            break;   // A good entry point is found. The list can be scanned from this point.
-        }
 
-        else if( item.GetPoint().x < aPosition.x ) // We should search after this item
-        {
-            idx += delta;
-            if( idx > idxmax )
-                idx = idxmax;
-        }
-        else    // We should search before this item
-        {
-            idx -= delta;
-            if( idx < 0 )
-                idx = 0;
-        }
-    }
+void CONNECTIONS::buildCandidatesHash( std::vector<int>& aSizes )
+{
+    // Use the median search distance as cell size: most of searches explore
+    // at most 4 cells, and only the few large items explore more cells
+    int cellSize = 1;
 
-    /* Now explore the candidate list from the "best" entry point found
-     * (candidate "near" aPosition.x)
-     * We explore the list until abs(candidate->m_Point.x - aPosition.x) > aDistMax
-     * because the list is sorted by X position (and for a given X pos, by Y pos)
-     * Currently a linear search is made because the number of candidates
-     * having the right X position is usually small
-     */
-    // search next candidates in list
-    wxPoint diff;
-    for( int ii = idx; ii <= idxmax; ii++ )
+    if( aSizes.size() )
     {
-        CONNECTED_POINT* item = &m_candidates[ii];
-        diff = item->GetPoint() - aPosition;
-        if( abs(diff.x) > aDistMax )
-            break;    // Exit: the distance is to long, we cannot find other candidates
-        if( abs(diff.y) > aDistMax )
-            continue;    // the y distance is to long, but we can find other candidates
-        // We have here a good candidate: add it
-        aList.push_back( item );
-    }
-    // search previous candidates in list
-    for(  int ii = idx-1; ii >=0; ii-- )
-    {
-        CONNECTED_POINT * item = &m_candidates[ii];
-        diff = item->GetPoint() - aPosition;
-        if( abs(diff.x) > aDistMax )
-            break;
-        if( abs(diff.y) > aDistMax )
-            continue;
-        // We have here a good candidate:add it
-        aList.push_back( item );
+        std::nth_element( aSizes.begin(), aSizes.begin() + aSizes.size() / 2, aSizes.end() );
+        cellSize = 2 * aSizes[ aSizes.size() / 2 ];
     }
+
+    m_candidatesHash.Clear( cellSize );
+
+    for( unsigned ii = 0; ii < m_candidates.size(); ii++ )
+        m_candidatesHash.Add( m_candidates[ii].GetPoint(), ii );
 }
 
 
 void CONNECTIONS::BuildPadsCandidatesList()
 {
+    std::vector<int> sizes;
+
     m_candidates.clear();
     m_candidates.reserve( m_sortedPads.size() );
+    sizes.reserve( m_sortedPads.size() );
     for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
     {
         D_PAD * pad = m_sortedPads[ii];
         CONNECTED_POINT candidate( pad, pad->GetPosition() );
         m_candidates.push_back( candidate );
+        sizes.push_back( pad->GetBoundingRadius() );
     }
+
+    buildCandidatesHash( sizes );
 }
 
 /* sort function used to sort .m_Connected by X the Y values
@@ -280,6 +241,15 @@ void CONNECTIONS::BuildTracksCandidatesList( TRACK * aBegin, TRACK * aEnd)
     // and for increasing Y coordinate when items have the same X coordinate
     // So candidates to the same location are consecutive in list.
     sort( m_candidates.begin(), m_candidates.end(), sortConnectedPointByXthenYCoordinates );
+
+    // Tracks are searched around their ends, at a distance of half their width
+    std::vector<int> sizes;
+    sizes.reserve( m_candidates.size() );
+
+    for( unsigned jj = 0; jj < m_candidates.size(); jj++ )
+        sizes.push_back( m_candidates[jj].GetTrack()->GetWidth() / 2 );
+
+    buildCandidatesHash( sizes );
 }
 
 /* Populates .m_connected with tracks/vias connected to aTrack
@@ -463,83 +433,6 @@ void CONNECTIONS::Build_CurrNet_SubNets_Connections( TRACK* aFirstTrack, TRACK*
 }
 
 
-/**
- * Change a subnet value to a new value, in m_sortedPads pad list
- * After that, 2 cluster (or subnets) are merged into only one.
- * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_PadsSubNets( int aOldSubNet, int aNewSubNet )
-{
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        EXCHG( aOldSubNet, aNewSubNet );
-
-    // Examine connections between intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
-    {
-        D_PAD * curr_pad = m_sortedPads[ii];
-        if( curr_pad->GetSubNet() != aOldSubNet )
-            continue;
-
-        change_count++;
-        curr_pad->SetSubNet( aNewSubNet );
-    }
-
-    return change_count;
-}
-
-/*
- * Change a subnet value to a new value, for tracks and pads which are connected to.
- * The result is merging 2 clusters (or subnets) into only one cluster.
- * Note: the resulting sub net value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
-{
-    TRACK* curr_track;
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        EXCHG( aOldSubNet, aNewSubNet );
-
-    curr_track = (TRACK*)m_firstTrack;
-
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
-    {
-        if( curr_track->GetSubNet() != aOldSubNet )
-        {
-            if( curr_track == m_lastTrack )
-                break;
-
-            continue;
-        }
-
-        change_count++;
-        curr_track->SetSubNet( aNewSubNet );
-
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
-        {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
-            if( pad->GetSubNet() == aOldSubNet )
-            {
-                pad->SetSubNet( curr_track->GetSubNet() );
-            }
-        }
-
-        if( curr_track == m_lastTrack )
-            break;
-    }
-
-    return change_count;
-}
-
-
 /* Test a list of track segments, to create or propagate a sub netcode to pads and
  * segments connected together.
  * The track list must be sorted by nets, and all segments
@@ -554,139 +447,74 @@ int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
  */
 void CONNECTIONS::Propagate_SubNets()
 {
-    int sub_netcode = 1;
+    // Give an index to each item: tracks first, then pads
+    std::vector<BOARD_CONNECTED_ITEM*> items;
+    boost::unordered_map<const BOARD_CONNECTED_ITEM*, int> indexes;
 
-    TRACK* curr_track = (TRACK*)m_firstTrack;
-    if( curr_track )
-        curr_track->SetSubNet( sub_netcode );
+    for( TRACK* track = (TRACK*) m_firstTrack; track != NULL; track = track->Next() )
+    {
+        indexes[track] = items.size();
+        items.push_back( track );
 
-    // Examine connections between tracks and pads
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
+        if( track == m_lastTrack )
+            break;
+    }
+
+    int trackCount = items.size();
+
+    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
+    {
+        indexes[m_sortedPads[ii]] = items.size();
+        items.push_back( m_sortedPads[ii] );
+    }
+
+    // Merge the clusters of connected items
+    CN_DISJOINT_SET clusters( items.size() );
+    boost::unordered_map<const BOARD_CONNECTED_ITEM*, int>::const_iterator it;
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        // First: handling connections to pads
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
+        BOARD_CONNECTED_ITEM* item = items[ii];
+
+        for( unsigned jj = 0; jj < item->m_PadsConnected.size(); jj++ )
         {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
+            it = indexes.find( item->m_PadsConnected[jj] );
 
-            if( curr_track->GetSubNet() )        // the track segment is already a cluster member
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    Merge_SubNets( pad->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    /* The pad is not yet attached to a cluster , so we can add this pad to
-                     * the cluster */
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else                              // the track segment is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // it is connected to a pad in a cluster, merge this track
-                    curr_track->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    /* it is connected to a pad not in a cluster, so we must create a new
-                     * cluster (only with the 2 items: the track and the pad) */
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
+            if( it != indexes.end() )
+                clusters.Union( ii, it->second );
         }
 
-        // Test connections between segments
-        for( unsigned ii = 0; ii < curr_track->m_TracksConnected.size(); ii++ )
+        // Pads connected to tracks are already found from the track side
+        if( (int) ii >= trackCount )
+            continue;
+
+        for( unsigned jj = 0; jj < item->m_TracksConnected.size(); jj++ )
         {
-            BOARD_CONNECTED_ITEM* track = curr_track->m_TracksConnected[ii];
-            if( curr_track->GetSubNet() )   // The current track is already a cluster member
-            {
-                // The other track is already a cluster member, so we can merge the 2 clusters
-                if( track->GetSubNet() )
-                {
-                    Merge_SubNets( track->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    /* The other track is not yet attached to a cluster , so we can add this
-                     * other track to the cluster */
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else        // the current track segment is not yet attached to a cluster
-            {
-                if( track->GetSubNet() )
-                {
-                    // The other track is already a cluster member, so we can add
-                    // the current segment to the cluster
-                    curr_track->SetSubNet( track->GetSubNet() );
-                }
-                else
-                {
-                    /* it is connected to an other segment not in a cluster, so we must
-                     * create a new cluster (only with the 2 track segments) */
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-        }
+            it = indexes.find( item->m_TracksConnected[jj] );
 
-        if( curr_track == m_lastTrack )
-            break;
+            if( it != indexes.end() )
+                clusters.Union( ii, it->second );
+        }
     }
 
-    // Examine connections between intersecting pads, and propagate
-    // sub_netcodes to intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
+    // Number the clusters from 1.  Clusters are numbered in the order of their first item.
+    // A track segment connected to nothing is a cluster by itself, and gets its own subnet,
+    // but a pad which is not connected to an other item is not in a cluster (subnet 0)
+    std::vector<int> clusterSize( items.size(), 0 );
+    std::vector<int> subnets( items.size(), 0 );
+    int sub_netcode = 0;
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+        clusterSize[ clusters.Find( ii ) ]++;
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        D_PAD * curr_pad = m_sortedPads[ii];
-        for( unsigned jj = 0; jj < curr_pad->m_PadsConnected.size(); jj++ )
-        {
-            D_PAD * pad = curr_pad->m_PadsConnected[jj];
-            if( curr_pad->GetSubNet() )   // the current pad is already attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    // Store the initial subnets, which will be modified by Merge_PadsSubNets
-                    int subnet1 = pad->GetSubNet();
-                    int subnet2 = curr_pad->GetSubNet();
-                    // merge subnets of pads only, even those not connected by tracks
-                    Merge_PadsSubNets( subnet1, subnet2 );
-                    // merge subnets of tracks (and pads, which are already merged)
-                    Merge_SubNets( subnet1, subnet2 );
-                }
-                else
-                {
-                    // The pad is not yet attached to a cluster,
-                    // so we can add this pad to the cluster
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
-            else   // the current pad is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // the connected pad is in a cluster,
-                    // so we can add the current pad to the cluster
-                    curr_pad->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    // the connected pad is not in a cluster,
-                    // so we must create a new cluster, with the 2 pads.
-                    sub_netcode++;
-                    curr_pad->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
-        }
+        int root = clusters.Find( ii );
+
+        if( subnets[root] == 0 && ( (int) ii < trackCount || clusterSize[root] > 1 ) )
+            subnets[root] = ++sub_netcode;
+
+        items[ii]->SetSubNet( subnets[root] );
     }
 }
 
@@ -696,26 +524,26 @@ void CONNECTIONS::Propagate_SubNets()
  * TestForActiveLinksInRatsnest must be called after this function
  * to update active/inactive ratsnest items status
  */
-void PCB_BASE_FRAME::TestConnections()
+void TestConnections( BOARD* aPcb )
 {
     // Clear the cluster identifier for all pads
-    for( unsigned i = 0;  i< m_Pcb->GetPadCount();  ++i )
+    for( unsigned i = 0;  i< aPcb->GetPadCount();  ++i )
     {
-        D_PAD* pad = m_Pcb->GetPad(i);
+        D_PAD* pad = aPcb->GetPad(i);
 
         pad->SetZoneSubNet( 0 );
         pad->SetSubNet( 0 );
     }
 
-    m_Pcb->Test_Connections_To_Copper_Areas();
+    aPcb->Test_Connections_To_Copper_Areas();
 
     // Test existing connections net by net
     // note some nets can have no tracks, and pads intersecting
     // so Build_CurrNet_SubNets_Connections must be called for each net
-    CONNECTIONS connections( m_Pcb );
+    CONNECTIONS connections( aPcb );
     int last_net_tested = 0;
     int current_net_code = 0;
-    for( TRACK* track = m_Pcb->m_Track; track; )
+    for( TRACK* track = aPcb->m_Track; track; )
     {
         // At this point, track is the first track of a given net
         current_net_code = track->GetNetCode();
@@ -736,16 +564,22 @@ void PCB_BASE_FRAME::TestConnections()
     }
 
     // Test last nets without tracks, if any
-    int netsCount = m_Pcb->GetNetCount();
+    int netsCount = aPcb->GetNetCount();
     for( int net = last_net_tested+1; net < netsCount; net++ )
         connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
 
-    Merge_SubNets_Connected_By_CopperAreas( m_Pcb );
+    Merge_SubNets_Connected_By_CopperAreas( aPcb );
 
     return;
 }
 
 
+void PCB_BASE_FRAME::TestConnections()
+{
+    ::TestConnections( m_Pcb );
+}
+
+
 void PCB_BASE_FRAME::TestNetConnection( wxDC* aDC, int aNetCode )
 {
     wxString msg;
@@ -825,15 +659,15 @@ void PCB_BASE_FRAME::TestNetConnection( wxDC* aDC, int aNetCode )
  * segments.
  * Pads netcodes are assumed to be up to date.
  */
-void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
+void RecalculateAllTracksNetcode( BOARD* aPcb )
 {
     TRACK*              curr_track;
 
     // Build the net info list
-    GetBoard()->BuildListOfNets();
+    aPcb->BuildListOfNets();
 
     // Reset variables and flags used in computation
-    curr_track = m_Pcb->m_Track;
+    curr_track = aPcb->m_Track;
     for( ; curr_track != NULL; curr_track = curr_track->Next() )
     {
         curr_track->m_TracksConnected.clear();
@@ -846,12 +680,12 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     }
 
     // If no pad, reset pointers and netcode, and do nothing else
-    if( m_Pcb->GetPadCount() == 0 )
+    if( aPcb->GetPadCount() == 0 )
         return;
 
-    CONNECTIONS connections( m_Pcb );
+    CONNECTIONS connections( aPcb );
     connections.BuildPadsList();
-    connections.BuildTracksCandidatesList(m_Pcb->m_Track);
+    connections.BuildTracksCandidatesList(aPcb->m_Track);
 
     // First pass: build connections between track segments and pads.
     connections.SearchTracksConnectedToPads();
@@ -859,7 +693,7 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     /* For tracks connected to at least one pad,
      * set the track net code to the pad netcode
      */
-    curr_track = m_Pcb->m_Track;
+    curr_track = aPcb->m_Track;
     for( ; curr_track != NULL; curr_track = curr_track->Next() )
     {
         if( curr_track->m_PadsConnected.size() )
@@ -867,54 +701,58 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     }
 
     // Pass 2: build connections between track ends
-    for( curr_track = m_Pcb->m_Track; curr_track != NULL; curr_track = curr_track->Next() )
+    for( curr_track = aPcb->m_Track; curr_track != NULL; curr_track = curr_track->Next() )
     {
         connections.SearchConnectedTracks( curr_track );
         connections.GetConnectedTracks( curr_track );
     }
 
-    // Propagate net codes from a segment to other connected segments
-    bool new_pass_request = true;   // set to true if a track has its netcode changed from 0
-                                    // to a known netcode to re-evaluate netcodes
-                                    // of connected items
-    while( new_pass_request )
+    // Propagate net codes from a segment to other connected segments:
+    // each segment having no netcode gets the netcode of the first segment
+    // of its cluster (in list order) having a netcode.  Net codes were reset
+    // above, so only the segments connected to a pad have one, and the segments
+    // of a cluster connected to no pad stay unconnected (net code 0)
+    std::vector<TRACK*> tracks;
+    boost::unordered_map<const TRACK*, int> indexes;
+
+    for( curr_track = aPcb->m_Track; curr_track; curr_track = curr_track->Next() )
     {
-        new_pass_request = false;
+        indexes[curr_track] = tracks.size();
+        tracks.push_back( curr_track );
+    }
 
-        for( curr_track = m_Pcb->m_Track; curr_track; curr_track = curr_track->Next() )
-        {
-            int netcode = curr_track->GetNetCode();
-            if( netcode == 0 )
-            {   // try to find a connected item having a netcode
-                for( unsigned kk = 0; kk < curr_track->m_TracksConnected.size(); kk++ )
-                {
-                    int altnetcode = curr_track->m_TracksConnected[kk]->GetNetCode();
-                    if( altnetcode )
-                    {
-                        new_pass_request = true;
-                        netcode = altnetcode;
-                        curr_track->SetNetCode(netcode);
-                        break;
-                    }
-                }
-            }
-            if( netcode )    // this track has a netcode
-            {   // propagate this netcode to connected tracks having no netcode
-                for( unsigned kk = 0; kk < curr_track->m_TracksConnected.size(); kk++ )
-                {
-                    int altnetcode = curr_track->m_TracksConnected[kk]->GetNetCode();
-                    if( altnetcode == 0 )
-                    {
-                        curr_track->m_TracksConnected[kk]->SetNetCode(netcode);
-                        new_pass_request = true;
-                    }
-                }
-            }
-        }
+    CN_DISJOINT_SET clusters( tracks.size() );
+
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+    {
+        for( unsigned kk = 0; kk < tracks[ii]->m_TracksConnected.size(); kk++ )
+            clusters.Union( ii, indexes[ tracks[ii]->m_TracksConnected[kk] ] );
+    }
+
+    std::vector<int> clusterNetcode( tracks.size(), 0 );
+
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+    {
+        int root = clusters.Find( ii );
+
+        if( clusterNetcode[root] == 0 )
+            clusterNetcode[root] = tracks[ii]->GetNetCode();
+    }
+
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+    {
+        if( tracks[ii]->GetNetCode() == 0 )
+            tracks[ii]->SetNetCode( clusterNetcode[ clusters.Find( ii ) ] );
     }
 
     // Sort the track list by net codes:
-    RebuildTrackChain( m_Pcb );
+    RebuildTrackChain( aPcb );
+}
+
+
+void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
+{
+    ::RecalculateAllTracksNetcode( m_Pcb );
 }
 
 
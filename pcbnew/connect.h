@@ -32,6 +32,7 @@
 
 #include <class_track.h>
 #include <class_board.h>
+#include <connectivity.h>
 
 
 // Helper classes to handle connection points (i.e. candidates) for tracks
@@ -95,6 +96,8 @@ private:
                                                 // to a given track or via
     std::vector <CONNECTED_POINT> m_candidates; // List of points to test
                                                 // (end points of tracks or vias location )
+    CN_POINT_HASH m_candidatesHash;             // Spatial hash of m_candidates
+                                                // (ids are indexes in m_candidates)
     BOARD * m_brd;                              // the master board.
     const TRACK * m_firstTrack;                 // The first track used to build m_Candidates
     const TRACK * m_lastTrack;                  // The last track used to build m_Candidates
@@ -198,8 +201,8 @@ public:
     /**
      * function CollectItemsNearTo
      * Used by SearchTracksConnectedToPads
-     * Fills aList with pads near to aPosition
-     * near means aPosition to pad position <= aDistMax
+     * Fills aList with candidates near to aPosition, using m_candidatesHash
+     * near means aPosition to candidate position <= aDistMax (rectilinear distance)
      * @param aList = list to fill
      * @param aPosition = aPosition to use as reference
      * @param aDistMax = dist max from aPosition to a candidate to select it
@@ -220,6 +223,9 @@ public:
      * For a given net, if all tracks are created, there is only one cluster.
      * but if not all tracks are created, there are more than one cluster,
      * and some ratsnests will be left active.
+     * Clusters are merged in a CN_DISJOINT_SET while connections are explored,
+     * and numbered from 1 afterwards, in the order of the track list then of the pad list.
+     * A pad connected to nothing keeps the subnet 0.
      */
     void Propagate_SubNets();
 
@@ -236,28 +242,46 @@ private:
     int searchEntryPointInCandidatesList( const wxPoint & aPoint);
 
     /**
-     * Function Merge_SubNets
-     * Change a subnet old value to a new value, for tracks and pads which are connected to
-     * tracks from m_firstTrack to m_lastTrack and their connected pads.
-     * and modify the subnet parameter (change the old value to the new value).
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting sub net value is the smallest between aOldSubNet and aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
+     * function buildCandidatesHash
+     * Fills m_candidatesHash with m_candidates
+     * @param aSizes = the search distances expected for these candidates,
+     * used to choose the hash cell size (the list is modified)
      */
-    int Merge_SubNets( int aOldSubNet, int aNewSubNet );
-
-    /**
-     * Function Merge_PadsSubNets
-     * Change a subnet value to a new value, in m_sortedPads pad list
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
-     */
-    int Merge_PadsSubNets( int aOldSubNet, int aNewSubNet );
+    void buildCandidatesHash( std::vector<int>& aSizes );
 };
 
+
+/* Board level connectivity and ratsnest functions.
+ * They do the work of the PCB_BASE_FRAME functions of the same name,
+ * and can be used without a frame (for instance by command line tools).
+ */
+
+/**
+ * Function RecalculateAllTracksNetcode
+ * search connections between tracks and pads and propagate pad net codes to the track
+ * segments of \a aPcb.
+ */
+void RecalculateAllTracksNetcode( BOARD* aPcb );
+
+/**
+ * Function Build_Board_Ratsnest
+ * calculates the full ratsnest of \a aPcb, depending only on pads.
+ */
+void Build_Board_Ratsnest( BOARD* aPcb );
+
+/**
+ * Function TestConnections
+ * tests the connections of all the nets of \a aPcb, and updates the subnets
+ * of pads and tracks.
+ */
+void TestConnections( BOARD* aPcb );
+
+/**
+ * Function TestForActiveLinksInRatsnest
+ * finds the active links of the full ratsnest of \a aPcb.
+ * @param aPcb = the board.
+ * @param aNetCode = net code to test. If 0, test all nets
+ */
+void TestForActiveLinksInRatsnest( BOARD* aPcb, int aNetCode );
+
 #endif      //  ifndef CONNECT_H
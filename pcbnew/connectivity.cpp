@@ -0,0 +1,120 @@
+/**
+ * @file connectivity.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <connectivity.h>
+
+
+CN_POINT_HASH::CN_POINT_HASH( int aCellSize )
+{
+    Clear( aCellSize );
+}
+
+
+void CN_POINT_HASH::Clear( int aCellSize )
+{
+    m_points.clear();
+    m_cells.clear();
+    m_cellSize = std::max( aCellSize, 1 );
+}
+
+
+int CN_POINT_HASH::cellCoord( int aValue ) const
+{
+    // Round towards -infinity, so negative coordinates do not share the cell 0
+    if( aValue >= 0 )
+        return aValue / m_cellSize;
+
+    return -( ( -aValue + m_cellSize - 1 ) / m_cellSize );
+}
+
+
+void CN_POINT_HASH::Add( const wxPoint& aPoint, int aId )
+{
+    POINT point;
+    point.m_pos = aPoint;
+    point.m_id  = aId;
+
+    m_cells[ cellKey( cellCoord( aPoint.x ), cellCoord( aPoint.y ) ) ].push_back( m_points.size() );
+    m_points.push_back( point );
+}
+
+
+void CN_POINT_HASH::Query( const wxPoint& aPosition, int aDistMax,
+                           std::vector<int>& aResult ) const
+{
+    size_t first = aResult.size();
+
+    int xmin = cellCoord( aPosition.x - aDistMax );
+    int xmax = cellCoord( aPosition.x + aDistMax );
+    int ymin = cellCoord( aPosition.y - aDistMax );
+    int ymax = cellCoord( aPosition.y + aDistMax );
+
+    double cellCount = double( xmax - xmin + 1 ) * double( ymax - ymin + 1 );
+
+    if( cellCount > m_points.size() )
+    {
+        // The area covers more cells than there are points: a linear scan is cheaper
+        for( unsigned ii = 0; ii < m_points.size(); ii++ )
+        {
+            const POINT& point = m_points[ii];
+
+            if( std::abs( point.m_pos.x - aPosition.x ) <= aDistMax
+              && std::abs( point.m_pos.y - aPosition.y ) <= aDistMax )
+                aResult.push_back( point.m_id );
+        }
+    }
+    else
+    {
+        for( int cx = xmin; cx <= xmax; cx++ )
+        {
+            for( int cy = ymin; cy <= ymax; cy++ )
+            {
+                CELL_MAP::const_iterator cell = m_cells.find( cellKey( cx, cy ) );
+
+                if( cell == m_cells.end() )
+                    continue;
+
+                const std::vector<int>& indices = cell->second;
+
+                for( unsigned ii = 0; ii < indices.size(); ii++ )
+                {
+                    const POINT& point = m_points[ indices[ii] ];
+
+                    if( std::abs( point.m_pos.x - aPosition.x ) <= aDistMax
+                      && std::abs( point.m_pos.y - aPosition.y ) <= aDistMax )
+                        aResult.push_back( point.m_id );
+                }
+            }
+        }
+    }
+
+    // Results do not depend on the cell layout
+    std::sort( aResult.begin() + first, aResult.end() );
+}
@@ -0,0 +1,195 @@
+/**
+ * @file connectivity.h
+ * @brief Helper classes used to compute clusters of connected items.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/unordered_map.hpp>
+
+#include <wx/gdicmn.h>
+
+
+/**
+ * Class CN_DISJOINT_SET
+ * is a union-find structure over the integers 0..GetCount()-1.
+ * Each set is identified by one of its members (its root).  Merging two sets and
+ * finding the set of an item run in nearly constant time (union by rank and path
+ * halving), so clusters can be merged while connections are discovered, without
+ * renumbering the items already visited.
+ */
+class CN_DISJOINT_SET
+{
+public:
+    CN_DISJOINT_SET( int aCount = 0 )
+    {
+        Reset( aCount );
+    }
+
+    /**
+     * Function Reset
+     * creates \a aCount singletons, and forgets all the previous merges.
+     */
+    void Reset( int aCount )
+    {
+        m_parent.resize( aCount );
+        m_rank.assign( aCount, 0 );
+
+        for( int ii = 0; ii < aCount; ii++ )
+            m_parent[ii] = ii;
+    }
+
+    /**
+     * Function Add
+     * appends a new singleton, allowing a set to grow incrementally.
+     * @return the id of the new item.
+     */
+    int Add()
+    {
+        int id = m_parent.size();
+
+        m_parent.push_back( id );
+        m_rank.push_back( 0 );
+
+        return id;
+    }
+
+    /**
+     * Function GetCount
+     * @return the number of items (not the number of sets).
+     */
+    int GetCount() const { return m_parent.size(); }
+
+    /**
+     * Function Find
+     * @return the root of the set containing \a aItem.
+     */
+    int Find( int aItem )
+    {
+        while( m_parent[aItem] != aItem )
+        {
+            m_parent[aItem] = m_parent[ m_parent[aItem] ];
+            aItem = m_parent[aItem];
+        }
+
+        return aItem;
+    }
+
+    /**
+     * Function Union
+     * merges the sets containing \a aFirst and \a aSecond.
+     * @return true if they were different sets.
+     */
+    bool Union( int aFirst, int aSecond )
+    {
+        aFirst  = Find( aFirst );
+        aSecond = Find( aSecond );
+
+        if( aFirst == aSecond )
+            return false;
+
+        if( m_rank[aFirst] < m_rank[aSecond] )
+            std::swap( aFirst, aSecond );
+
+        m_parent[aSecond] = aFirst;
+
+        if( m_rank[aFirst] == m_rank[aSecond] )
+            m_rank[aFirst]++;
+
+        return true;
+    }
+
+private:
+    std::vector<int> m_parent;
+    std::vector<int> m_rank;
+};
+
+
+/**
+ * Class CN_POINT_HASH
+ * is a spatial hash of points (track ends, via and pad positions), each point
+ * carrying an integer id.  Points are stored in square grid cells, so collecting
+ * the points near a given position only visits a few cells, whatever the size
+ * or the sort order of the point list.
+ */
+class CN_POINT_HASH
+{
+public:
+    CN_POINT_HASH( int aCellSize = 1 );
+
+    /**
+     * Function Clear
+     * removes all the points, and sets the cell size used for the next insertions.
+     * A cell size close to the usual query distance gives the best results.
+     */
+    void Clear( int aCellSize );
+
+    /**
+     * Function Add
+     * inserts \a aPoint, identified by \a aId.
+     */
+    void Add( const wxPoint& aPoint, int aId );
+
+    /**
+     * Function GetCount
+     * @return the number of points in the hash.
+     */
+    int GetCount() const { return m_points.size(); }
+
+    /**
+     * Function Query
+     * collects the ids of the points located at a rectilinear distance <= \a aDistMax
+     * from \a aPosition.
+     * @param aResult = the list to fill (it is not cleared), by increasing id.
+     */
+    void Query( const wxPoint& aPosition, int aDistMax, std::vector<int>& aResult ) const;
+
+private:
+    struct POINT
+    {
+        wxPoint m_pos;
+        int     m_id;
+    };
+
+    typedef boost::unordered_map<unsigned long long, std::vector<int> > CELL_MAP;
+
+    int cellCoord( int aValue ) const;
+
+    unsigned long long cellKey( int aCellX, int aCellY ) const
+    {
+        return ( (unsigned long long) (unsigned) aCellX << 32 ) | (unsigned) aCellY;
+    }
+
+    std::vector<POINT>  m_points;
+    CELL_MAP            m_cells;    // cell key -> indices in m_points
+    int                 m_cellSize;
+};
+
+#endif  // CONNECTIVITY_H
@@ -175,6 +175,41 @@ void DIALOG_DRC_CONTROL::OnStartdrcClick( wxCommandEvent& event )
 }
 
 
+/*!
+ * wxEVT_COMMAND_BUTTON_CLICKED event handler for ID_UPDATEDRC
+ */
+
+void DIALOG_DRC_CONTROL::OnUpdatedrcClick( wxCommandEvent& event )
+{
+    SetDrcParmeters();
+
+    m_tester->SetSettings( true,        // Pad to pad DRC test enabled
+                           true,        // unconnected pdas DRC test enabled
+                           true,        // DRC test for zones enabled
+                           true,        // DRC test for keepout areas enabled
+                           wxEmptyString, false );
+
+    wxBeginBusyCursor();
+
+    // Only the markers of the changed items are replaced, the others are kept.
+    // This falls back to a full DRC when the changes are not known.
+    m_Messages->Clear();
+    wxSafeYield();                          // Allows time slice to refresh the m_Messages window
+    m_tester->m_pcb->m_Status_Pcb = 0;      // Force full connectivity and ratsnest recalculations
+    m_tester->RunIncrementalTests( m_Messages );
+
+#if wxCHECK_VERSION( 2, 8, 0 )
+    m_Notebook->ChangeSelection( 0 );       // display the 1at tab "...Markers ..."
+#else
+    m_Notebook->SetSelection( 0 );          // display the 1at tab "... Markers..."
+#endif
+
+    wxEndBusyCursor();
+
+    RedrawDrawPanel();
+}
+
+
 /*!
  * wxEVT_COMMAND_BUTTON_CLICKED event handler for ID_ERASE_DRC_MARKERS
  */
@@ -182,6 +217,10 @@ void DIALOG_DRC_CONTROL::OnStartdrcClick( wxCommandEvent& event )
 void DIALOG_DRC_CONTROL::OnDeleteAllClick( wxCommandEvent& event )
 {
     DelDRCMarkers();
+
+    // The markers are gone, the next update must be a full DRC
+    m_Parent->GetBoard()->ClearDrcDirty( false );
+
     RedrawDrawPanel();
 }
 
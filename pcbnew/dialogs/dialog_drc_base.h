@@ -37,11 +37,12 @@
 #define ID_CHECKBOX_RPT_FILE 1000
 #define ID_BUTTON_BROWSE_RPT_FILE 1001
 #define ID_STARTDRC 1002
-#define ID_LIST_UNCONNECTED 1003
-#define ID_DELETE_ALL 1004
-#define ID_NOTEBOOK1 1005
-#define ID_CLEARANCE_LIST 1006
-#define ID_UNCONNECTED_LIST 1007
+#define ID_UPDATEDRC 1003
+#define ID_LIST_UNCONNECTED 1004
+#define ID_DELETE_ALL 1005
+#define ID_NOTEBOOK1 1006
+#define ID_CLEARANCE_LIST 1007
+#define ID_UNCONNECTED_LIST 1008
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Class DIALOG_DRC_CONTROL_BASE
@@ -59,6 +60,7 @@ class DIALOG_DRC_CONTROL_BASE : public DIALOG_SHIM
 		wxStaticText* m_staticText6;
 		wxTextCtrl* m_Messages;
 		wxButton* m_buttonRunDRC;
+		wxButton* m_buttonUpdateDRC;
 		wxButton* m_buttonListUnconnected;
 		wxButton* m_DeleteAllButton;
 		wxButton* m_DeleteCurrentMarkerButton;
@@ -74,6 +76,7 @@ class DIALOG_DRC_CONTROL_BASE : public DIALOG_SHIM
 		virtual void OnReportCheckBoxClicked( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnButtonBrowseRptFileClick( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnStartdrcClick( wxCommandEvent& event ) { event.Skip(); }
+		virtual void OnUpdatedrcClick( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnListUnconnectedClick( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnDeleteAllClick( wxCommandEvent& event ) { event.Skip(); }
 		virtual void OnDeleteOneClick( wxCommandEvent& event ) { event.Skip(); }
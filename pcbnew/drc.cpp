@@ -38,13 +38,20 @@
 #include <class_track.h>
 #include <class_pad.h>
 #include <class_zone.h>
+#include <class_marker_pcb.h>
 
 #include <pcbnew.h>
 #include <drc_stuff.h>
+#include <drc_spatial_index.h>
+#include <connect.h>
 
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 
 void DRC::ShowDialog()
 {
@@ -113,6 +120,77 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_ycliplo = 0;
     m_xcliphi = 0;
     m_ycliphi = 0;
+
+    m_spatialIndex = new DRC_SPATIAL_INDEX();
+    m_isWorker = false;
+    m_markersBoard = NULL;
+
+    m_stageStartTime = 0;
+    m_stageStartErrorCount = 0;
+}
+
+
+DRC::DRC( BOARD* aBoard )
+{
+    m_mainWindow = NULL;
+    m_pcb = aBoard;
+    m_ui  = 0;
+
+    m_doPad2PadTest     = true;
+    m_doUnconnectedTest = true;
+    m_doZonesTest       = true;
+    m_doKeepoutTest     = true;
+
+    m_doCreateRptFile = false;
+
+    m_currentMarker = NULL;
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
+
+    m_spatialIndex = new DRC_SPATIAL_INDEX();
+    m_isWorker = false;
+    m_markersBoard = NULL;
+
+    m_stageStartTime = 0;
+    m_stageStartErrorCount = 0;
+}
+
+
+DRC::DRC( const DRC* aMaster )
+{
+    m_mainWindow = aMaster->m_mainWindow;
+    m_pcb = aMaster->m_pcb;
+    m_ui  = 0;
+
+    m_doPad2PadTest     = aMaster->m_doPad2PadTest;
+    m_doUnconnectedTest = aMaster->m_doUnconnectedTest;
+    m_doZonesTest       = aMaster->m_doZonesTest;
+    m_doKeepoutTest     = aMaster->m_doKeepoutTest;
+    m_doCreateRptFile   = false;
+
+    m_currentMarker = NULL;
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
+
+    // The index is owned by the master DRC, and is read only during tests
+    m_spatialIndex = aMaster->m_spatialIndex;
+    m_isWorker = true;
+    m_markersBoard = NULL;
+
+    m_stageStartTime = 0;
+    m_stageStartErrorCount = 0;
 }
 
 
@@ -121,6 +199,9 @@ DRC::~DRC()
     // maybe someday look at pointainer.h  <- google for "pointainer.h"
     for( unsigned i = 0; i<m_unconnected.size();  ++i )
         delete m_unconnected[i];
+
+    if( !m_isWorker )
+        delete m_spatialIndex;
 }
 
 
@@ -165,6 +246,8 @@ int DRC::Drc( ZONE_CONTAINER* aArea, int aCornerIndex )
 
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
+    m_stageStats.clear();
+
     // Ensure ratsnest is up to date:
     if( (m_pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
     {
@@ -174,12 +257,26 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
-        m_mainWindow->Compile_Ratsnest( NULL, true );
+        beginStage( wxT( "ratsnest" ) );
+        compileRatsnest();
+        endStage( m_pcb->GetPadCount() );
     }
 
     // someone should have cleared the two lists before calling this.
+    m_itemMarkers.clear();
+    m_markersBoard = m_pcb;
+    m_pcb->ClearDrcDirty( true );
+
+    // Index the copper items once for all the clearance tests
+    beginStage( wxT( "spatial_index" ) );
+    m_spatialIndex->Build( m_pcb );
+    endStage( m_pcb->GetPadCount() + m_pcb->m_Track.GetCount() );
+
+    beginStage( wxT( "netclasses" ) );
+    bool netclassesOk = testNetClasses();
+    endStage( m_pcb->m_NetClasses.GetCount() + 1 );   // + 1 for the default netclass
 
-    if( !testNetClasses() )
+    if( !netclassesOk )
     {
         // testing the netclasses is a special case because if the netclasses
         // do not pass the BOARD_DESIGN_SETTINGS checks, then every member of a net
@@ -191,6 +288,11 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         // update the m_ui listboxes
         updatePointers();
 
+        // The other tests were not run: there are no results to update incrementally
+        m_markersBoard = NULL;
+        m_pcb->ClearDrcDirty( false );
+
+        m_spatialIndex->Clear();
         return;
     }
 
@@ -203,7 +305,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
+        beginStage( wxT( "pad_clearances" ) );
         testPad2Pad();
+        endStage( m_pcb->GetPadCount() );
     }
 
     // test track and via clearances to other tracks, pads, and vias
@@ -213,7 +317,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testTracks( true );
+    beginStage( wxT( "track_clearances" ) );
+    testTracks( m_mainWindow != NULL );
+    endStage( m_pcb->m_Track.GetCount() );
 
     // Before testing segments and unconnected, refill all zones:
     // this is a good caution, because filled areas can be outdated.
@@ -223,8 +329,14 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    m_mainWindow->Fill_All_Zones( aMessages ? aMessages->GetParent() : m_mainWindow,
-                                  false );
+    beginStage( wxT( "zone_fill" ) );
+
+    if( m_mainWindow )
+        m_mainWindow->Fill_All_Zones( aMessages ? aMessages->GetParent() : m_mainWindow );
+    else
+        fillAllZones();
+
+    endStage( m_pcb->GetAreaCount() );
 
     // test zone clearances to other zones
     if( aMessages )
@@ -233,7 +345,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    beginStage( wxT( "zones" ) );
     testZones();
+    endStage( m_pcb->GetAreaCount() );
 
     // find and gather unconnected pads.
     if( m_doUnconnectedTest )
@@ -244,7 +358,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        beginStage( wxT( "unconnected" ) );
         testUnconnected();
+        endStage( m_pcb->GetRatsnestsCount() );
     }
 
     // find and gather vias, tracks, pads inside keepout areas.
@@ -256,9 +372,14 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        beginStage( wxT( "keepout_areas" ) );
         testKeepoutAreas();
+        endStage( m_pcb->GetAreaCount() );
     }
 
+    // The index is not kept up to date when the board is edited
+    m_spatialIndex->Clear();
+
     // update the m_ui listboxes
     updatePointers();
 
@@ -271,6 +392,236 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 }
 
 
+void DRC::beginStage( const wxString& aName )
+{
+    DRC_STAGE_STATS stage;
+
+    stage.m_Name       = aName;
+    stage.m_ItemCount  = 0;
+    stage.m_ErrorCount = 0;
+    stage.m_Time       = 0;
+
+    m_stageStats.push_back( stage );
+
+    m_stageStartErrorCount = m_pcb->GetMARKERCount() + m_unconnected.size();
+    m_stageStartTime = GetRunningMicroSecs();
+}
+
+
+void DRC::endStage( int aItemCount )
+{
+    DRC_STAGE_STATS& stage = m_stageStats.back();
+
+    stage.m_Time       = GetRunningMicroSecs() - m_stageStartTime;
+    stage.m_ItemCount  = aItemCount;
+    stage.m_ErrorCount = m_pcb->GetMARKERCount() + m_unconnected.size() - m_stageStartErrorCount;
+}
+
+
+void DRC::compileRatsnest()
+{
+    if( m_mainWindow )
+    {
+        m_mainWindow->Compile_Ratsnest( NULL, true );
+        return;
+    }
+
+    // Same as PCB_BASE_FRAME::Compile_Ratsnest(), without display
+    m_pcb->m_Status_Pcb = 0;
+    RecalculateAllTracksNetcode( m_pcb );
+    Build_Board_Ratsnest( m_pcb );
+    TestConnections( m_pcb );
+    TestForActiveLinksInRatsnest( m_pcb, 0 );
+}
+
+
+void DRC::fillAllZones()
+{
+    m_pcb->FillAllZones();
+
+    TestConnections( m_pcb );
+    TestForActiveLinksInRatsnest( m_pcb, 0 );
+}
+
+
+void DRC::RunIncrementalTests( wxTextCtrl* aMessages )
+{
+    updatePointers();
+
+    if( m_markersBoard != m_pcb || !m_pcb->IsDrcDirtyRecorded() )
+    {
+        // No previous results to update, or too many changes since
+        m_pcb->DeleteMARKERs();
+        deleteUnconnected();
+        RunTests( aMessages );
+        return;
+    }
+
+    if( aMessages )
+    {
+        aMessages->AppendText( _( "Changed items...\n" ) );
+        wxSafeYield();
+    }
+
+    m_spatialIndex->Build( m_pcb );
+
+    std::set<TRACK*> tracks;
+    std::set<D_PAD*> pads;
+
+    collectChangedItems( tracks, pads );
+    removeOutdatedMarkers( tracks, pads );
+
+    if( m_doPad2PadTest && !pads.empty() )
+    {
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Pad clearances...\n" ) );
+            wxSafeYield();
+        }
+
+        testPad2Pad( &pads );
+    }
+
+    if( !tracks.empty() )
+    {
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Track clearances...\n" ) );
+            wxSafeYield();
+        }
+
+        testTracks( false, &tracks );
+
+        if( m_doKeepoutTest )
+            testKeepoutAreas( &tracks );
+    }
+
+    if( m_doUnconnectedTest )
+    {
+        if( aMessages )
+        {
+            aMessages->AppendText( _( "Unconnected pads...\n" ) );
+            aMessages->Refresh();
+        }
+
+        deleteUnconnected();
+        testUnconnected();
+    }
+
+    m_spatialIndex->Clear();
+    m_pcb->ClearDrcDirty( true );
+
+    // update the m_ui listboxes
+    updatePointers();
+
+    if( aMessages )
+        aMessages->AppendText( _( "Finished" ) );
+}
+
+
+void DRC::collectChangedItems( std::set<TRACK*>& aTracks, std::set<D_PAD*>& aPads )
+{
+    const std::set<BOARD_ITEM*>& changed = m_pcb->GetDrcDirtyItems();
+
+    // The areas of the changed items before their changes
+    std::vector<EDA_RECT> areas = m_pcb->GetDrcDirtyAreas();
+
+    // and after their changes.  Changed items can have been deleted since they were
+    // recorded, so only the items found on the board are used.
+    for( TRACK* track = m_pcb->m_Track; track; track = track->Next() )
+    {
+        if( changed.count( track ) )
+            areas.push_back( DRC_SPATIAL_INDEX::TrackCopperArea( track ) );
+    }
+
+    for( MODULE* module = m_pcb->m_Modules; module; module = module->Next() )
+    {
+        if( changed.count( module ) == 0 )
+            continue;
+
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            areas.push_back( DRC_SPATIAL_INDEX::PadCopperArea( pad ) );
+    }
+
+    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+    {
+        if( changed.count( m_pcb->GetArea( ii ) ) )
+            areas.push_back( m_pcb->GetArea( ii )->GetBoundingBox() );
+    }
+
+    // Any item closer than the biggest clearance to a changed area can have
+    // a different DRC result
+    std::vector<TRACK*> foundTracks;
+    std::vector<D_PAD*> foundPads;
+
+    for( unsigned ii = 0; ii < areas.size(); ++ii )
+    {
+        EDA_RECT area = areas[ii];
+        area.Inflate( m_spatialIndex->GetMaxClearance() + 1 );
+
+        m_spatialIndex->QueryTracks( area, foundTracks );
+        aTracks.insert( foundTracks.begin(), foundTracks.end() );
+
+        m_spatialIndex->QueryPads( area, foundPads );
+        aPads.insert( foundPads.begin(), foundPads.end() );
+    }
+}
+
+
+void DRC::removeOutdatedMarkers( const std::set<TRACK*>& aTracks, const std::set<D_PAD*>& aPads )
+{
+    // Markers can have been deleted by the user since the last run
+    std::set<MARKER_PCB*> boardMarkers;
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+        boardMarkers.insert( m_pcb->GetMARKER( ii ) );
+
+    // Items which will be tested again, and items still on board.  Keys of
+    // m_itemMarkers can be deleted items, so they are only compared to these lists.
+    std::set<BOARD_ITEM*> retested( aTracks.begin(), aTracks.end() );
+    retested.insert( aPads.begin(), aPads.end() );
+
+    std::set<BOARD_ITEM*> liveItems;
+
+    for( int ii = 0; ii < m_spatialIndex->GetTrackCount(); ++ii )
+        liveItems.insert( m_spatialIndex->GetTrack( ii ) );
+
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+        liveItems.insert( m_pcb->GetPad( ii ) );
+
+    std::multimap<BOARD_ITEM*, MARKER_PCB*>::iterator it = m_itemMarkers.begin();
+
+    while( it != m_itemMarkers.end() )
+    {
+        if( retested.count( it->first ) || liveItems.count( it->first ) == 0 )
+        {
+            MARKER_PCB* marker = it->second;
+
+            if( boardMarkers.count( marker ) )
+            {
+                m_pcb->Remove( marker );
+                delete marker;
+            }
+
+            m_itemMarkers.erase( it++ );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+void DRC::deleteUnconnected()
+{
+    for( unsigned ii = 0; ii < m_unconnected.size(); ++ii )
+        delete m_unconnected[ii];
+
+    m_unconnected.clear();
+}
+
+
 void DRC::ListUnconnectedPads()
 {
     testUnconnected();
@@ -283,7 +634,9 @@ void DRC::ListUnconnectedPads()
 void DRC::updatePointers()
 {
     // update my pointers, m_mainWindow is the only unchangeable one
-    m_pcb = m_mainWindow->GetBoard();
+    // (without main window, the board is given to the constructor)
+    if( m_mainWindow )
+        m_pcb = m_mainWindow->GetBoard();
 
     if( m_ui )  // Use diag list boxes only in DRC dialog
     {
@@ -414,7 +767,7 @@ bool DRC::testNetClasses()
 }
 
 
-void DRC::testPad2Pad()
+void DRC::testPad2Pad( const std::set<D_PAD*>* aPadFilter )
 {
     std::vector<D_PAD*> sortedPads;
 
@@ -435,33 +788,64 @@ void DRC::testPad2Pad()
 
     // Test the pads
     D_PAD** listEnd = &sortedPads[ sortedPads.size() ];
+    int     padCount = sortedPads.size();
 
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
-    {
-        D_PAD* pad = sortedPads[i];
+    // Each pad test is independent and creates at most one marker, stored in the
+    // slot of the pad, so the markers are added in the same order as a serial run.
+    std::vector<MARKER_PCB*> markers( padCount, (MARKER_PCB*) NULL );
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+#ifdef USE_OPENMP
+    #pragma omp parallel
+#endif
+    {
+        DRC worker( this );
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+#ifdef USE_OPENMP
+        #pragma omp for schedule(dynamic, 64)
+#endif
+        for( int i = 0; i < padCount; ++i )
         {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_currentMarker = 0;
+            D_PAD* pad = sortedPads[i];
+
+            if( aPadFilter && aPadFilter->count( pad ) == 0 )
+                continue;
+
+            int    x_limit = max_size + pad->GetClearance() +
+                             pad->GetBoundingRadius() + pad->GetPosition().x;
+
+            if( !worker.doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+            {
+                wxASSERT( worker.m_currentMarker );
+                markers[i] = worker.m_currentMarker;
+                worker.m_currentMarker = 0;
+            }
         }
+    }   // end of parallel section
+
+    for( int i = 0; i < padCount; ++i )
+    {
+        if( markers[i] )
+            addMarker( sortedPads[i], markers[i] );
     }
 }
 
 
-void DRC::testTracks( bool aShowProgressBar )
+void DRC::testTracks( bool aShowProgressBar, const std::set<TRACK*>* aTrackFilter )
 {
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
-    int count = 0;
+
+    // Each segment is tested against the segments following it in list
+    std::vector<TRACK*> refSegms;
+
     for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
-        count++;
+    {
+        if( aTrackFilter == NULL || aTrackFilter->count( segm ) )
+            refSegms.push_back( segm );
+    }
 
+    int count = refSegms.size();
     int deltamax = count/delta;
 
     if( aShowProgressBar && deltamax > 3 )
@@ -472,29 +856,57 @@ void DRC::testTracks( bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    // One marker slot by reference segment, filled by the workers and merged
+    // in list order after the tests, so the result does not depend on the
+    // number of threads.
+    std::vector<MARKER_PCB*> markers( count, (MARKER_PCB*) NULL );
 
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
+    // The progress dialog can be updated only by this thread, and not while the workers
+    // test the tracks (it processes the paint events, which read the board).  So the
+    // tracks are tested in batches, and the progress is shown between the batches.
+    int batchSize = delta;
+
+#ifdef USE_OPENMP
+    batchSize *= omp_get_max_threads();
+#endif
+
+    for( int first = 0; first < count; first += batchSize )
     {
-        if ( ii++ > delta )
+        int last = std::min( first + batchSize, count );
+
+        if( progressDialog && first > 0 )
+        {
+            if( !progressDialog->Update( std::min( first / delta, deltamax ), wxEmptyString ) )
+                break;  // Aborted by user
+        }
+
+#ifdef USE_OPENMP
+        #pragma omp parallel
+#endif
         {
-            ii = 0;
-            count++;
+            DRC worker( this );
 
-            if( progressDialog )
+#ifdef USE_OPENMP
+            #pragma omp for schedule(dynamic, 64)
+#endif
+            for( int jj = first; jj < last; ++jj )
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                TRACK* segm = refSegms[jj];
+
+                if( !worker.doTrackDrc( segm, segm->Next(), true ) )
+                {
+                    wxASSERT( worker.m_currentMarker );
+                    markers[jj] = worker.m_currentMarker;
+                    worker.m_currentMarker = 0;
+                }
             }
-        }
+        }   // end of parallel section
+    }
 
-        if( !doTrackDrc( segm, segm->Next(), true ) )
-        {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_currentMarker = 0;
-        }
+    for( int jj = 0; jj < count; ++jj )
+    {
+        if( markers[jj] )
+            addMarker( refSegms[jj], markers[jj] );
     }
 
     if( progressDialog )
@@ -502,12 +914,26 @@ void DRC::testTracks( bool aShowProgressBar )
 }
 
 
+void DRC::addMarker( BOARD_ITEM* aItem, MARKER_PCB* aMarker )
+{
+    m_pcb->Add( aMarker );
+    m_itemMarkers.insert( std::make_pair( aItem, aMarker ) );
+}
+
+
 void DRC::testUnconnected()
 {
     if( (m_pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
     {
-        wxClientDC dc( m_mainWindow->GetCanvas() );
-        m_mainWindow->Compile_Ratsnest( &dc, true );
+        if( m_mainWindow )
+        {
+            wxClientDC dc( m_mainWindow->GetCanvas() );
+            m_mainWindow->Compile_Ratsnest( &dc, true );
+        }
+        else
+        {
+            compileRatsnest();
+        }
     }
 
     if( m_pcb->GetRatsnestsCount() == 0 )
@@ -563,7 +989,7 @@ void DRC::testZones()
 }
 
 
-void DRC::testKeepoutAreas()
+void DRC::testKeepoutAreas( const std::set<TRACK*>* aTrackFilter )
 {
     // Test keepout areas for vias, tracks and pads inside keepout areas
     for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
@@ -573,8 +999,17 @@ void DRC::testKeepoutAreas()
         if( !area->GetIsKeepout() )
             continue;
 
-        for( TRACK* segm = m_pcb->m_Track; segm != NULL; segm = segm->Next() )
+        // Only tracks and vias inside the area bounding box can be inside the area
+        std::vector<TRACK*> candidates;
+        m_spatialIndex->QueryTracks( area->GetBoundingBox(), candidates );
+
+        for( unsigned jj = 0; jj < candidates.size(); ++jj )
         {
+            TRACK* segm = candidates[jj];
+
+            if( aTrackFilter && aTrackFilter->count( segm ) == 0 )
+                continue;
+
             if( segm->Type() == PCB_TRACE_T )
             {
                 if( ! area->GetDoNotAllowTracks()  )
@@ -588,7 +1023,7 @@ void DRC::testKeepoutAreas()
                 {
                     m_currentMarker = fillMarker( segm, NULL,
                                                   DRCE_TRACK_INSIDE_KEEPOUT, m_currentMarker );
-                    m_pcb->Add( m_currentMarker );
+                    addMarker( segm, m_currentMarker );
                     m_currentMarker = 0;
                 }
             }
@@ -604,7 +1039,7 @@ void DRC::testKeepoutAreas()
                 {
                     m_currentMarker = fillMarker( segm, NULL,
                                                   DRCE_VIA_INSIDE_KEEPOUT, m_currentMarker );
-                    m_pcb->Add( m_currentMarker );
+                    addMarker( segm, m_currentMarker );
                     m_currentMarker = 0;
                 }
             }
@@ -616,13 +1051,25 @@ void DRC::testKeepoutAreas()
 
 bool DRC::doTrackKeepoutDrc( TRACK* aRefSeg )
 {
-    // Test keepout areas for vias, tracks and pads inside keepout areas
-    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+    std::vector<ZONE_CONTAINER*> areas;
+
+    if( m_spatialIndex->IsBuilt() )
     {
-        ZONE_CONTAINER* area = m_pcb->GetArea( ii );
+        m_spatialIndex->QueryKeepouts( DRC_SPATIAL_INDEX::TrackCopperArea( aRefSeg ), areas );
+    }
+    else
+    {
+        for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+        {
+            if( m_pcb->GetArea( ii )->GetIsKeepout() )
+                areas.push_back( m_pcb->GetArea( ii ) );
+        }
+    }
 
-        if( !area->GetIsKeepout() )
-            continue;
+    // Test keepout areas for vias, tracks and pads inside keepout areas
+    for( unsigned ii = 0; ii < areas.size(); ii++ )
+    {
+        ZONE_CONTAINER* area = areas[ii];
 
         if( aRefSeg->Type() == PCB_TRACE_T )
         {
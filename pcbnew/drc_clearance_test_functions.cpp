@@ -37,6 +37,7 @@
 
 #include <pcbnew.h>
 #include <drc_stuff.h>
+#include <drc_spatial_index.h>
 
 #include <class_board.h>
 #include <class_module.h>
@@ -145,6 +146,44 @@ bool trapezoid2pointDRC( wxPoint aTref[4], wxPoint aPcompare, int aDist )
     return true;
 }
 
+void DRC::collectDrcCandidates( TRACK* aRefSeg, TRACK* aStart, bool aCollectPads,
+                                std::vector<D_PAD*>& aPadList, std::vector<TRACK*>& aTrackList )
+{
+    aPadList.clear();
+    aTrackList.clear();
+
+    // aStart can be found in the spatial index only during a full DRC run.
+    // Otherwise (online DRC, aStart not in m_Track) use the lists themselves.
+    int startRank = -1;
+
+    if( m_spatialIndex->IsBuilt() && aStart )
+        startRank = m_spatialIndex->GetTrackRank( aStart );
+
+    if( startRank >= 0 )
+    {
+        // Only items inside the reference segment area inflated by the biggest
+        // clearance can be too close to it.
+        EDA_RECT area = DRC_SPATIAL_INDEX::TrackCopperArea( aRefSeg );
+        area.Inflate( m_spatialIndex->GetMaxClearance() + 1 );
+
+        if( aCollectPads )
+            m_spatialIndex->QueryPads( area, aPadList );
+
+        m_spatialIndex->QueryTracks( area, aTrackList, startRank );
+        return;
+    }
+
+    if( aCollectPads )
+    {
+        for( unsigned ii = 0;  ii < m_pcb->GetPadCount();  ++ii )
+            aPadList.push_back( m_pcb->GetPad( ii ) );
+    }
+
+    for( TRACK* track = aStart; track; track = track->Next() )
+        aTrackList.push_back( track );
+}
+
+
 bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 {
     TRACK*    track;
@@ -269,12 +308,18 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
     dummypad.SetLayerMask( ALL_CU_LAYERS );     // Ensure the hole is on all layers
 
+    // Collect the pads and the track segments to test against aRefSeg
+    std::vector<D_PAD*> padCandidates;
+    std::vector<TRACK*> trackCandidates;
+
+    collectDrcCandidates( aRefSeg, aStart, testPads, padCandidates, trackCandidates );
+
     // Compute the min distance to pads
     if( testPads )
     {
-        for( unsigned ii = 0;  ii<m_pcb->GetPadCount();  ++ii )
+        for( unsigned ii = 0;  ii < padCandidates.size();  ++ii )
         {
-            D_PAD* pad = m_pcb->GetPad( ii );
+            D_PAD* pad = padCandidates[ii];
 
             /* No problem if pads are on an other layer,
              * But if a drill hole exists	(a pad on a single layer can have a hole!)
@@ -336,8 +381,10 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
     // Test the reference segment with other track segments
     wxPoint segStartPoint;
     wxPoint segEndPoint;
-    for( track = aStart; track; track = track->Next() )
+    for( unsigned ii = 0; ii < trackCandidates.size(); ++ii )
     {
+        track = trackCandidates[ii];
+
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
             continue;
@@ -0,0 +1,207 @@
+/**
+ * @file drc_runner.cpp
+ * @brief Runs the design rules check on a board file, without any window.
+ *
+ * Usage: drc_runner [-o report_file] board.kicad_pcb
+ *
+ * The board is loaded, and the same tests as the DRC dialog are run with DRC::RunTests().
+ * A report is written (to the standard output if no report file is given), as a
+ * s-expression giving the time spent and the number of items handled by each test
+ * stage, and the list of the errors and of the unconnected pads found.
+ * A summary of the stages is printed to the standard error.
+ *
+ * The exit code is 0 if the board has no error, 1 if errors or unconnected pads were
+ * found, and 2 if the board cannot be loaded or the report cannot be written.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <fctsys.h>
+#include <wx/init.h>
+#include <common.h>
+#include <richio.h>
+#include <io_mgr.h>
+#include <class_drc_item.h>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+
+#include <pcbnew.h>
+#include <drc_stuff.h>
+#include <standalone_pgm.h>
+
+
+/* Writes a DRC_ITEM as an error entry of the report
+ */
+static void formatDrcItem( OUTPUTFORMATTER* aOut, int aNestLevel, const DRC_ITEM& aItem )
+{
+    aOut->Print( aNestLevel, "(error (code %d) (type %s)\n",
+                 aItem.GetErrorCode(), aOut->Quotew( aItem.GetErrorText() ).c_str() );
+
+    aOut->Print( aNestLevel + 1, "(item (at %.6f %.6f) (text %s))\n",
+                 aItem.GetPointA().x / IU_PER_MM, aItem.GetPointA().y / IU_PER_MM,
+                 aOut->Quotew( aItem.GetTextA() ).c_str() );
+
+    if( aItem.HasSecondItem() )
+    {
+        aOut->Print( aNestLevel + 1, "(item (at %.6f %.6f) (text %s))\n",
+                     aItem.GetPointB().x / IU_PER_MM, aItem.GetPointB().y / IU_PER_MM,
+                     aOut->Quotew( aItem.GetTextB() ).c_str() );
+    }
+
+    aOut->Print( aNestLevel, ")\n" );
+}
+
+
+static void formatReport( OUTPUTFORMATTER* aOut, const wxString& aBoardName,
+                          BOARD* aBoard, const DRC& aDrc )
+{
+    const std::vector<DRC_STAGE_STATS>& stages = aDrc.GetStageStats();
+    const DRC_LIST& unconnected = aDrc.GetUnconnected();
+
+    unsigned totalTime = 0;
+
+    for( unsigned ii = 0; ii < stages.size(); ii++ )
+        totalTime += stages[ii].m_Time;
+
+    aOut->Print( 0, "(drc_report (version 1)\n" );
+    aOut->Print( 1, "(board %s)\n", aOut->Quotew( aBoardName ).c_str() );
+    aOut->Print( 1, "(counts (pads %u) (tracks %d) (zones %d) (nets %u))\n",
+                 aBoard->GetPadCount(), aBoard->m_Track.GetCount(),
+                 aBoard->GetAreaCount(), aBoard->GetNetCount() );
+
+    aOut->Print( 1, "(stages\n" );
+
+    for( unsigned ii = 0; ii < stages.size(); ii++ )
+    {
+        aOut->Print( 2, "(stage %s (items %d) (errors %d) (time_ms %.3f))\n",
+                     TO_UTF8( stages[ii].m_Name ), stages[ii].m_ItemCount,
+                     stages[ii].m_ErrorCount, stages[ii].m_Time / 1000.0 );
+    }
+
+    aOut->Print( 1, ")\n" );
+    aOut->Print( 1, "(time_ms %.3f)\n", totalTime / 1000.0 );
+
+    aOut->Print( 1, "(errors (count %d)\n", aBoard->GetMARKERCount() );
+
+    for( int ii = 0; ii < aBoard->GetMARKERCount(); ii++ )
+        formatDrcItem( aOut, 2, aBoard->GetMARKER( ii )->GetReporter() );
+
+    aOut->Print( 1, ")\n" );
+
+    aOut->Print( 1, "(unconnected (count %u)\n", (unsigned) unconnected.size() );
+
+    for( unsigned ii = 0; ii < unconnected.size(); ii++ )
+        formatDrcItem( aOut, 2, *unconnected[ii] );
+
+    aOut->Print( 1, ")\n" );
+    aOut->Print( 0, ")\n" );
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer;
+
+    const char* reportName = NULL;
+    const char* boardName = NULL;
+    bool        badArgument = false;
+
+    for( int ii = 1; ii < argc && !badArgument; ii++ )
+    {
+        if( strcmp( argv[ii], "-o" ) == 0 && ii + 1 < argc )
+            reportName = argv[++ii];
+        else if( !boardName && argv[ii][0] != '-' )
+            boardName = argv[ii];
+        else
+            badArgument = true;
+    }
+
+    if( !boardName || badArgument )
+    {
+        fprintf( stderr, "usage: %s [-o report_file] board.kicad_pcb\n", argv[0] );
+        return 2;
+    }
+
+    SetLocaleTo_C_standard();
+    InitStandalonePgm();
+
+    wxString fileName = FROM_UTF8( boardName );
+    BOARD*   board;
+
+    try
+    {
+        IO_MGR::PCB_FILE_T fileType = fileName.EndsWith( wxT( ".kicad_pcb" ) ) ?
+                                      IO_MGR::KICAD : IO_MGR::LEGACY;
+
+        board = IO_MGR::Load( fileType, fileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return 2;
+    }
+
+    DRC drc( board );
+    drc.RunTests();
+
+    const std::vector<DRC_STAGE_STATS>& stages = drc.GetStageStats();
+
+    for( unsigned ii = 0; ii < stages.size(); ii++ )
+    {
+        fprintf( stderr, "%-20s items %8d  errors %6d  time %10.3f ms\n",
+                 TO_UTF8( stages[ii].m_Name ), stages[ii].m_ItemCount,
+                 stages[ii].m_ErrorCount, stages[ii].m_Time / 1000.0 );
+    }
+
+    int errorCount = board->GetMARKERCount() + drc.GetUnconnected().size();
+
+    try
+    {
+        if( reportName )
+        {
+            FILE_OUTPUTFORMATTER formatter( FROM_UTF8( reportName ) );
+            formatReport( &formatter, fileName, board, drc );
+        }
+        else
+        {
+            STRING_FORMATTER formatter;
+            formatReport( &formatter, fileName, board, drc );
+            fputs( formatter.GetString().c_str(), stdout );
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        delete board;
+        return 2;
+    }
+
+    delete board;
+
+    return errorCount ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * @file drc_spatial_index.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+#include <pcbnew.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_zone.h>
+#include <class_netclass.h>
+
+#include <drc_spatial_index.h>
+
+
+/* Visitor used to gather the ranks of the items found by a RTree search
+ */
+struct RANK_COLLECTOR
+{
+    std::vector<int>& m_ranks;
+
+    RANK_COLLECTOR( std::vector<int>& aRanks ) : m_ranks( aRanks ) {}
+
+    bool operator()( int aRank )
+    {
+        m_ranks.push_back( aRank );
+        return true;    // continue the search
+    }
+};
+
+
+DRC_SPATIAL_INDEX::DRC_SPATIAL_INDEX()
+{
+    m_trackTree   = new RANK_RTREE();
+    m_padTree     = new RANK_RTREE();
+    m_keepoutTree = new RANK_RTREE();
+
+    m_maxClearance = 0;
+    m_isBuilt = false;
+}
+
+
+DRC_SPATIAL_INDEX::~DRC_SPATIAL_INDEX()
+{
+    delete m_trackTree;
+    delete m_padTree;
+    delete m_keepoutTree;
+}
+
+
+void DRC_SPATIAL_INDEX::Clear()
+{
+    m_trackTree->RemoveAll();
+    m_padTree->RemoveAll();
+    m_keepoutTree->RemoveAll();
+
+    m_tracks.clear();
+    m_pads.clear();
+    m_keepouts.clear();
+    m_trackRanks.clear();
+
+    m_maxClearance = 0;
+    m_isBuilt = false;
+}
+
+
+void DRC_SPATIAL_INDEX::Build( BOARD* aBoard )
+{
+    Clear();
+
+    // The biggest clearance is given by a netclass, or by a local pad or footprint
+    // setting.  Tracks and vias use only netclass clearances.
+    NETCLASSES& netclasses = aBoard->m_NetClasses;
+
+    m_maxClearance = netclasses.GetDefault()->GetClearance();
+
+    for( NETCLASSES::const_iterator nc = netclasses.begin(); nc != netclasses.end(); ++nc )
+        m_maxClearance = std::max( m_maxClearance, nc->second->GetClearance() );
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        int rank = m_tracks.size();
+
+        m_tracks.push_back( track );
+        m_trackRanks[track] = rank;
+        insert( m_trackTree, TrackCopperArea( track ), rank );
+    }
+
+    for( unsigned ii = 0; ii < aBoard->GetPadCount(); ++ii )
+    {
+        D_PAD* pad = aBoard->GetPad( ii );
+
+        m_pads.push_back( pad );
+        m_maxClearance = std::max( m_maxClearance, pad->GetClearance() );
+        insert( m_padTree, PadCopperArea( pad ), ii );
+    }
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* area = aBoard->GetArea( ii );
+
+        if( !area->GetIsKeepout() )
+            continue;
+
+        insert( m_keepoutTree, area->GetBoundingBox(), m_keepouts.size() );
+        m_keepouts.push_back( area );
+    }
+
+    m_isBuilt = true;
+}
+
+
+int DRC_SPATIAL_INDEX::GetTrackRank( const TRACK* aTrack ) const
+{
+    std::map<const TRACK*, int>::const_iterator it = m_trackRanks.find( aTrack );
+
+    if( it == m_trackRanks.end() )
+        return -1;
+
+    return it->second;
+}
+
+
+void DRC_SPATIAL_INDEX::QueryTracks( const EDA_RECT& aArea, std::vector<TRACK*>& aResult,
+                                     int aMinRank ) const
+{
+    std::vector<int> ranks;
+
+    query( m_trackTree, aArea, ranks );
+
+    aResult.clear();
+
+    for( unsigned ii = 0; ii < ranks.size(); ++ii )
+    {
+        if( ranks[ii] >= aMinRank )
+            aResult.push_back( m_tracks[ ranks[ii] ] );
+    }
+}
+
+
+void DRC_SPATIAL_INDEX::QueryPads( const EDA_RECT& aArea, std::vector<D_PAD*>& aResult ) const
+{
+    std::vector<int> ranks;
+
+    query( m_padTree, aArea, ranks );
+
+    aResult.clear();
+
+    for( unsigned ii = 0; ii < ranks.size(); ++ii )
+        aResult.push_back( m_pads[ ranks[ii] ] );
+}
+
+
+void DRC_SPATIAL_INDEX::QueryKeepouts( const EDA_RECT& aArea,
+                                       std::vector<ZONE_CONTAINER*>& aResult ) const
+{
+    std::vector<int> ranks;
+
+    query( m_keepoutTree, aArea, ranks );
+
+    aResult.clear();
+
+    for( unsigned ii = 0; ii < ranks.size(); ++ii )
+        aResult.push_back( m_keepouts[ ranks[ii] ] );
+}
+
+
+EDA_RECT DRC_SPATIAL_INDEX::TrackCopperArea( const TRACK* aTrack )
+{
+    // end of track is round, this is its radius, rounded up
+    int radius = ( aTrack->GetWidth() + 1 ) / 2;
+
+    EDA_RECT area( aTrack->GetStart(), wxSize( 0, 0 ) );
+
+    if( aTrack->Type() != PCB_VIA_T )
+        area.Merge( aTrack->GetEnd() );
+
+    area.Inflate( radius );
+
+    return area;
+}
+
+
+EDA_RECT DRC_SPATIAL_INDEX::PadCopperArea( D_PAD* aPad )
+{
+    // The bounding circle is centered on the shape position, which is not
+    // the pad position (the hole position) when the pad has an offset
+    EDA_RECT area( aPad->ShapePos(), wxSize( 0, 0 ) );
+    area.Inflate( aPad->GetBoundingRadius() );
+
+    const wxSize& drill = aPad->GetDrillSize();
+
+    if( drill.x || drill.y )
+    {
+        EDA_RECT hole( aPad->GetPosition(), wxSize( 0, 0 ) );
+        hole.Inflate( ( std::max( drill.x, drill.y ) + 1 ) / 2 );
+        area.Merge( hole );
+    }
+
+    return area;
+}
+
+
+void DRC_SPATIAL_INDEX::insert( RANK_RTREE* aTree, const EDA_RECT& aArea, int aRank )
+{
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    aTree->Insert( mmin, mmax, aRank );
+}
+
+
+void DRC_SPATIAL_INDEX::query( RANK_RTREE* aTree, const EDA_RECT& aArea,
+                               std::vector<int>& aRanks ) const
+{
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    RANK_COLLECTOR collector( aRanks );
+    aTree->Search( mmin, mmax, collector );
+
+    // Give the candidates in list order, as the linear scans did
+    std::sort( aRanks.begin(), aRanks.end() );
+}
@@ -0,0 +1,165 @@
+/**
+ * @file drc_spatial_index.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_SPATIAL_INDEX_H
+#define DRC_SPATIAL_INDEX_H
+
+#include <vector>
+#include <map>
+
+#include <geometry/rtree.h>
+
+class EDA_RECT;
+class BOARD;
+class TRACK;
+class D_PAD;
+class ZONE_CONTAINER;
+
+
+/**
+ * Class DRC_SPATIAL_INDEX
+ * holds R-trees of the copper items of a BOARD (tracks, vias, pads) and of its
+ * keepout areas, so the DRC can restrict each clearance test to the neighbours
+ * found inside the inflated bounding box of the item under test.
+ *
+ * Items are stored by their rank in the board lists (m_Track order for tracks,
+ * BOARD::GetPad() order for pads, BOARD::GetArea() order for zones) and every query
+ * returns them sorted by this rank, so the index visits candidates in the same
+ * order as the former linear scans did, and creates exactly the same markers.
+ *
+ * The index is a snapshot: it must be rebuilt (or updated) when the board changes.
+ */
+class DRC_SPATIAL_INDEX
+{
+public:
+    DRC_SPATIAL_INDEX();
+    ~DRC_SPATIAL_INDEX();
+
+    /**
+     * Function Build
+     * (re)creates the index from the current content of \a aBoard.
+     */
+    void Build( BOARD* aBoard );
+
+    /**
+     * Function Clear
+     * removes all the items from the index.
+     */
+    void Clear();
+
+    /**
+     * Function IsBuilt
+     * @return true if Build() was called since the last Clear().
+     */
+    bool IsBuilt() const { return m_isBuilt; }
+
+    /**
+     * Function GetMaxClearance
+     * @return the biggest clearance value found in the board netclasses and items
+     * when the index was built.  Inflating an item bounding box by this value
+     * gives the area where all the items which can conflict with it are located.
+     */
+    int GetMaxClearance() const { return m_maxClearance; }
+
+    /**
+     * Function GetTrackCount
+     * @return the number of tracks and vias in the index.
+     */
+    int GetTrackCount() const { return (int) m_tracks.size(); }
+
+    /**
+     * Function GetTrack
+     * @return the track of rank \a aRank in the board track list.
+     */
+    TRACK* GetTrack( int aRank ) const { return m_tracks[aRank]; }
+
+    /**
+     * Function GetTrackRank
+     * @return the rank of \a aTrack in the board track list, or -1 if not indexed.
+     */
+    int GetTrackRank( const TRACK* aTrack ) const;
+
+    /**
+     * Function QueryTracks
+     * collects the tracks and vias whose copper area intersects \a aArea.
+     * @param aArea = the area to search.
+     * @param aResult = the list to fill, sorted by track rank.
+     * @param aMinRank = the tracks of rank < aMinRank are skipped.
+     */
+    void QueryTracks( const EDA_RECT& aArea, std::vector<TRACK*>& aResult,
+                      int aMinRank = 0 ) const;
+
+    /**
+     * Function QueryPads
+     * collects the pads whose copper area or hole intersects \a aArea.
+     * @param aArea = the area to search.
+     * @param aResult = the list to fill, sorted by pad rank.
+     */
+    void QueryPads( const EDA_RECT& aArea, std::vector<D_PAD*>& aResult ) const;
+
+    /**
+     * Function QueryKeepouts
+     * collects the keepout areas whose bounding box intersects \a aArea.
+     * @param aArea = the area to search.
+     * @param aResult = the list to fill, sorted by zone rank.
+     */
+    void QueryKeepouts( const EDA_RECT& aArea, std::vector<ZONE_CONTAINER*>& aResult ) const;
+
+    /**
+     * Function TrackCopperArea
+     * @return the area actually covered by the copper of \a aTrack (a track segment
+     * with its rounded ends, or a via).
+     */
+    static EDA_RECT TrackCopperArea( const TRACK* aTrack );
+
+    /**
+     * Function PadCopperArea
+     * @return the area covered by the copper shape and the hole of \a aPad.
+     */
+    static EDA_RECT PadCopperArea( D_PAD* aPad );
+
+private:
+    typedef RTree<int, int, 2, float> RANK_RTREE;
+
+    void insert( RANK_RTREE* aTree, const EDA_RECT& aArea, int aRank );
+    void query( RANK_RTREE* aTree, const EDA_RECT& aArea, std::vector<int>& aRanks ) const;
+
+    RANK_RTREE*                     m_trackTree;
+    RANK_RTREE*                     m_padTree;
+    RANK_RTREE*                     m_keepoutTree;
+
+    std::vector<TRACK*>             m_tracks;
+    std::vector<D_PAD*>             m_pads;
+    std::vector<ZONE_CONTAINER*>    m_keepouts;
+
+    std::map<const TRACK*, int>     m_trackRanks;
+
+    int                             m_maxClearance;
+    bool                            m_isBuilt;
+};
+
+#endif  // DRC_SPATIAL_INDEX_H
@@ -31,6 +31,8 @@
 
 
 #include <vector>
+#include <set>
+#include <map>
 
 #define OK_DRC  0
 #define BAD_DRC 1
@@ -88,6 +90,7 @@ class TRACK;
 class MARKER_PCB;
 class DRC_ITEM;
 class NETCLASS;
+class DRC_SPATIAL_INDEX;
 
 
 /**
@@ -137,6 +140,20 @@ public:
 typedef std::vector<DRC_ITEM*> DRC_LIST;
 
 
+/**
+ * Struct DRC_STAGE_STATS
+ * holds the results of one of the stages (netclasses, pads, tracks, zones fill...)
+ * of DRC::RunTests(), to report the time spent in each stage.
+ */
+struct DRC_STAGE_STATS
+{
+    wxString    m_Name;         ///< short untranslated stage name, like "track_clearances"
+    int         m_ItemCount;    ///< number of items handled by the stage
+    int         m_ErrorCount;   ///< number of markers and unconnected items found by the stage
+    unsigned    m_Time;         ///< wall clock time of the stage, in microseconds
+};
+
+
 /**
  * Class DRC
  * is the Design Rule Checker, and performs all the DRC tests.  The output of
@@ -190,12 +207,39 @@ private:
     int                 m_xcliphi;
     int                 m_ycliphi;
 
-    PCB_EDIT_FRAME*     m_mainWindow;
+    PCB_EDIT_FRAME*     m_mainWindow;   ///< NULL if the DRC works on a board without frame
     BOARD*              m_pcb;
     DIALOG_DRC_CONTROL* m_ui;
 
     DRC_LIST            m_unconnected;  ///< list of unconnected pads, as DRC_ITEMs
 
+    DRC_SPATIAL_INDEX*  m_spatialIndex; ///< R-trees of the board items, valid during RunTests()
+
+    bool                m_isWorker;     ///< true for the instances created by the parallel tests
+
+    /// The markers created by the item tests of the last run, by reference item.
+    /// Used by RunIncrementalTests() to replace only the markers of rechecked items.
+    std::multimap<BOARD_ITEM*, MARKER_PCB*> m_itemMarkers;
+
+    /// The board m_itemMarkers refers to, or NULL if no full DRC was run
+    BOARD*              m_markersBoard;
+
+    /// The stages of the last RunTests() call
+    std::vector<DRC_STAGE_STATS> m_stageStats;
+
+    unsigned            m_stageStartTime;           ///< start time of the current stage
+    int                 m_stageStartErrorCount;     ///< error count when the stage started
+
+
+    /**
+     * Constructor used by the parallel tests to create a worker: a DRC instance
+     * sharing the board and the spatial index of aMaster, but having its own
+     * test state (reference segment data, current marker), so several workers
+     * can run doTrackDrc() or doPadToPadsDrc() at the same time.
+     * @param aMaster The DRC instance which runs the tests.
+     */
+    explicit DRC( const DRC* aMaster );
+
 
     /**
      * Function updatePointers
@@ -271,18 +315,102 @@ private:
      * @param aShowProgressBar = true to show a progrsse bar
      * (Note: it is shown only if there are many tracks)
      */
-    void testTracks( bool aShowProgressBar );
+    void testTracks( bool aShowProgressBar, const std::set<TRACK*>* aTrackFilter = NULL );
 
-    void testPad2Pad();
+    /**
+     * Function testPad2Pad
+     * performs the pad to pad clearance tests.
+     * @param aPadFilter = if not NULL, only the pads of this set are tested
+     * (against all the other pads).
+     */
+    void testPad2Pad( const std::set<D_PAD*>* aPadFilter = NULL );
+
+    /**
+     * Function addMarker
+     * adds to the board a marker found when testing aItem, and remembers it
+     * as one of the markers of aItem.
+     */
+    void addMarker( BOARD_ITEM* aItem, MARKER_PCB* aMarker );
 
     void testUnconnected();
 
     void testZones();
 
-    void testKeepoutAreas();
+    /**
+     * Function testKeepoutAreas
+     * tests the vias and tracks inside keepout areas.
+     * @param aTrackFilter = if not NULL, only the tracks of this set are tested.
+     */
+    void testKeepoutAreas( const std::set<TRACK*>* aTrackFilter = NULL );
+
+    /**
+     * Function collectChangedItems
+     * finds the tracks and pads which must be tested again by an incremental DRC:
+     * the ones close (closer than the biggest clearance) to the areas of the items
+     * changed since the last run.  m_spatialIndex must be built.
+     * @param aTracks The set of tracks to fill.
+     * @param aPads The set of pads to fill.
+     */
+    void collectChangedItems( std::set<TRACK*>& aTracks, std::set<D_PAD*>& aPads );
+
+    /**
+     * Function removeOutdatedMarkers
+     * deletes the markers of the items of aTracks and aPads, and the ones
+     * of the items no longer on the board.
+     */
+    void removeOutdatedMarkers( const std::set<TRACK*>& aTracks, const std::set<D_PAD*>& aPads );
+
+    /**
+     * Function deleteUnconnected
+     * clears the list of unconnected pads.
+     */
+    void deleteUnconnected();
+
+    /**
+     * Function compileRatsnest
+     * builds the full ratsnest and finds its active links, using the main
+     * window if any, or else the board level functions.
+     */
+    void compileRatsnest();
+
+    /**
+     * Function fillAllZones
+     * refills the zones of a board which has no main window with
+     * BOARD::FillAllZones(), and updates the ratsnest.
+     */
+    void fillAllZones();
+
+    /**
+     * Function beginStage
+     * starts measuring a stage of RunTests().
+     * @param aName The stage name.
+     */
+    void beginStage( const wxString& aName );
+
+    /**
+     * Function endStage
+     * appends the results of the current stage to m_stageStats.
+     * @param aItemCount The number of items handled by the stage.
+     */
+    void endStage( int aItemCount );
 
     //-----<single "item" tests>-----------------------------------------
 
+    /**
+     * Function collectDrcCandidates
+     * builds the lists of pads and track segments which must be tested against aRefSeg.
+     * When m_spatialIndex is built and aStart belongs to it, only the items found near
+     * aRefSeg are collected, otherwise all the board pads and the whole list starting
+     * at aStart are collected.  In both cases items are given in board list order.
+     * @param aRefSeg The segment to test
+     * @param aStart The head of the list of tracks to test against
+     * @param aCollectPads true if pads are needed
+     * @param aPadList The pad list to fill
+     * @param aTrackList The track list to fill
+     */
+    void collectDrcCandidates( TRACK* aRefSeg, TRACK* aStart, bool aCollectPads,
+                               std::vector<D_PAD*>& aPadList, std::vector<TRACK*>& aTrackList );
+
     bool doNetClass( NETCLASS* aNetClass, wxString& msg );
 
     /**
@@ -387,6 +515,14 @@ private:
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Constructor used to run the tests on a board without any window,
+     * for instance from a command line tool.  Only RunTests() and the
+     * functions reporting its results can be used.
+     * @param aBoard The board to test.
+     */
+    explicit DRC( BOARD* aBoard );
+
     ~DRC();
 
     /**
@@ -478,6 +614,20 @@ public:
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
 
+    /**
+     * Function RunIncrementalTests
+     * updates the results of the last RunTests() call after the board was edited:
+     * the pad, track and keepout tests are run again only for the items close to
+     * the ones changed since (see BOARD::SetDrcDirty()), and only their markers
+     * are replaced.  The list of unconnected pads is rebuilt.  The netclass and
+     * zone outline tests are not run again, they need a full DRC.
+     * If there is no previous run for the current board, or if the board does not
+     * know all the changes since (see BOARD::IsDrcDirtyRecorded()), all the markers
+     * are deleted and the full DRC is run.
+     * @param aMessages = a wxTextControl where to display some activity messages. Can be NULL
+     */
+    void RunIncrementalTests( wxTextCtrl* aMessages = NULL );
+
     /**
      * Function ListUnconnectedPad
      * gathers a list of all the unconnected pads and shows them in the
@@ -493,6 +643,25 @@ public:
         return m_currentMarker;
     }
 
+    /**
+     * Function GetUnconnected
+     * @return the list of unconnected pads found by the last run.
+     */
+    const DRC_LIST& GetUnconnected() const
+    {
+        return m_unconnected;
+    }
+
+    /**
+     * Function GetStageStats
+     * @return the time spent and the items handled by each stage of the last
+     * RunTests() call, in run order.
+     */
+    const std::vector<DRC_STAGE_STATS>& GetStageStats() const
+    {
+        return m_stageStats;
+    }
+
 };
 
 
@@ -417,6 +417,9 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         loadedBoard->BuildListOfNets();
         loadedBoard->SynchronizeNetsAndNetClasses();
 
+        // The previous DRC results, if any, are not about this board
+        loadedBoard->ClearDrcDirty( false );
+
         SetStatusText( wxEmptyString );
         BestZoom();
 
@@ -0,0 +1,434 @@
+/**
+ * @file fp_library_index.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <memory>
+#include <stdlib.h>
+
+#include <fctsys.h>
+#include <kicad_string.h>
+#include <dsnlexer.h>
+#include <wildcards_and_files_ext.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+
+#include <class_module.h>
+#include <pcb_parser.h>
+#include <fp_library_index.h>
+
+
+#define INDEX_VERSION       2
+
+/// Directory of the index files, in the user data directory.
+#define INDEX_DIRECTORY     wxT( "fp-index" )
+
+/// A directory or file modified less than this number of seconds before it is indexed
+/// may still change within the same second of modification time.  Its time is not trusted.
+#define RACY_TIME           2
+
+
+/* Returns the modification time of a file or directory, 0 if it cannot be read
+ */
+static long long modificationTime( const wxFileName& aFileName )
+{
+    wxDateTime  time = aFileName.GetModificationTime();
+
+    return time.IsValid() ? time.GetTicks() : 0;
+}
+
+
+FP_LIBRARY_INDEX::FP_LIBRARY_INDEX( const wxString& aLibraryPath ) :
+    m_dirTime( 0 )
+{
+    // Native separators, as FP_CACHE
+    wxFileName  path;
+
+    path.AssignDir( aLibraryPath );
+    m_libraryPath = path.GetPath();
+}
+
+
+wxString FP_LIBRARY_INDEX::GetIndexFileName( const wxString& aLibraryPath )
+{
+    wxFileName  path;
+
+    path.AssignDir( aLibraryPath );
+
+    // The file is named by a FNV-1a hash of the library path.  The path is also in
+    // the file, so two libraries with the same hash only miss their index.
+    std::string         utf8 = TO_UTF8( path.GetPath() );
+    unsigned long long  hash = 14695981039346656037ULL;
+
+    for( unsigned ii = 0; ii < utf8.size(); ++ii )
+    {
+        hash ^= (unsigned char) utf8[ii];
+        hash *= 1099511628211ULL;
+    }
+
+    wxFileName  fn;
+
+    fn.AssignDir( wxStandardPaths::Get().GetUserDataDir() );
+    fn.AppendDir( INDEX_DIRECTORY );
+    fn.SetName( wxString::Format( wxT( "%08X%08X" ),
+                                  (unsigned) ( hash >> 32 ), (unsigned) ( hash & 0xFFFFFFFF ) ) );
+    fn.SetExt( wxT( "idx" ) );
+
+    return fn.GetFullPath();
+}
+
+
+bool FP_LIBRARY_INDEX::IsPath( const wxString& aLibraryPath ) const
+{
+    wxFileName  path;
+
+    path.AssignDir( aLibraryPath );
+
+    return path.GetPath() == m_libraryPath;
+}
+
+
+const FP_LIBRARY_INDEX::ENTRY* FP_LIBRARY_INDEX::Find( const wxString& aFootprintName ) const
+{
+    ENTRIES::const_iterator it = m_entries.find( TO_UTF8( aFootprintName ) );
+
+    return it != m_entries.end() ? &it->second : NULL;
+}
+
+
+void FP_LIBRARY_INDEX::Update( PCB_PARSER* aParser ) throw( IO_ERROR, PARSE_ERROR )
+{
+    wxFileName  libPath;
+
+    libPath.AssignDir( m_libraryPath );
+
+    if( !libPath.DirExists() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Footprint library path '%s' does not exist" ),
+                                          GetChars( m_libraryPath ) ) );
+    }
+
+    long long dirTime = modificationTime( libPath );
+
+    // The index in memory, then the index file, may be current.  Saving a footprint
+    // over its file does not change the directory time, so the files are checked too.
+    if( m_dirTime && m_dirTime == dirTime && filesUnchanged() )
+        return;
+
+    if( m_entries.empty() && read() && m_dirTime && m_dirTime == dirTime && filesUnchanged() )
+        return;
+
+    wxDir dir( m_libraryPath );
+
+    if( !dir.IsOpened() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Footprint library path '%s' does not exist" ),
+                                          GetChars( m_libraryPath ) ) );
+    }
+
+    // List the footprint files again, and parse only the new and modified ones.
+    ENTRIES     previous;
+    bool        changed = false;
+
+    previous.swap( m_entries );
+
+    wxString    fpFileName;
+    wxString    wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
+
+    if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
+    {
+        do
+        {
+            wxFileName  fullPath( m_libraryPath, fpFileName );
+            std::string name = TO_UTF8( fullPath.GetName() );
+            long long   time = modificationTime( fullPath );
+            long long   size = fullPath.GetSize().GetValue();
+
+            ENTRIES::iterator it = previous.find( name );
+
+            if( it != previous.end() && it->second.m_time == time && it->second.m_size == size )
+            {
+                m_entries[name] = it->second;
+                continue;
+            }
+
+            MAPPED_FILE_LINE_READER reader( fullPath.GetFullPath() );
+
+            aParser->SetLineReader( &reader );
+
+            std::auto_ptr<MODULE> module( (MODULE*) aParser->Parse() );
+
+            // The footprint name is the file name without the extension.
+            module->SetFPID( fullPath.GetName() );
+
+            ENTRY& entry = m_entries[name];
+
+            // A time which is not trusted is not recorded: the file is parsed again
+            // by the next Update().
+            if( time > wxDateTime::Now().GetTicks() - RACY_TIME )
+                time = 0;
+
+            entry.m_time = time;
+            entry.m_size = size;
+            entry.m_header.SetFrom( module.get() );
+
+            changed = true;
+
+        } while( dir.GetNext( &fpFileName ) );
+    }
+
+    if( m_entries.size() != previous.size() )
+        changed = true;
+
+    if( !changed && m_dirTime == dirTime )
+        return;
+
+    m_dirTime = dirTime;
+
+    // A footprint file written in the same second as the last one would not change
+    // the directory time: such a time is not recorded, and the next Update() lists
+    // the directory again.
+    if( dirTime > wxDateTime::Now().GetTicks() - RACY_TIME )
+        m_dirTime = 0;
+
+    write();
+}
+
+
+bool FP_LIBRARY_INDEX::filesUnchanged() const
+{
+    for( ENTRIES::const_iterator it = m_entries.begin();  it != m_entries.end();  ++it )
+    {
+        const ENTRY&    entry = it->second;
+        wxFileName      fullPath( m_libraryPath, FROM_UTF8( it->first.c_str() ),
+                                  KiCadFootprintFileExtension );
+
+        if( !entry.m_time || modificationTime( fullPath ) != entry.m_time )
+            return false;
+
+        if( (long long) fullPath.GetSize().GetValue() != entry.m_size )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool FP_LIBRARY_INDEX::read()
+{
+    static const KEYWORD empty_keywords[1] = {};
+
+    wxString    fileName = GetIndexFileName( m_libraryPath );
+
+    if( !wxFileExists( fileName ) )
+        return false;
+
+    FILE*       fp = wxFopen( fileName, wxT( "rt" ) );
+
+    if( !fp )
+        return false;
+
+    ENTRIES     entries;
+    long long   dirTime = 0;
+    bool        pathOk = false;
+
+    try
+    {
+        DSNLEXER    lexer( empty_keywords, 0, fp, fileName );   // closes fp
+
+        lexer.NeedLEFT();
+        lexer.NeedSYMBOL();
+
+        if( strcmp( lexer.CurText(), "fp_lib_index" ) )
+            return false;
+
+        for( int tok = lexer.NextTok();  tok != DSN_RIGHT;  tok = lexer.NextTok() )
+        {
+            if( tok != DSN_LEFT )
+                lexer.Expecting( DSN_LEFT );
+
+            lexer.NeedSYMBOL();
+
+            std::string key = lexer.CurText();
+
+            if( key == "version" )
+            {
+                lexer.NeedNUMBER( "version" );
+
+                if( atoi( lexer.CurText() ) != INDEX_VERSION )
+                    return false;
+            }
+            else if( key == "path" )
+            {
+                lexer.NeedSYMBOLorNUMBER();
+                pathOk = lexer.FromUTF8() == m_libraryPath;
+            }
+            else if( key == "dir_time" )
+            {
+                lexer.NeedNUMBER( "dir_time" );
+                dirTime = strtoll( lexer.CurText(), NULL, 10 );
+            }
+            else if( key == "footprint" )
+            {
+                lexer.NeedSYMBOLorNUMBER();
+
+                ENTRY& entry = entries[lexer.CurText()];
+
+                entry.m_time = 0;
+                entry.m_size = 0;
+                entry.m_header.m_name = lexer.FromUTF8();
+
+                for( tok = lexer.NextTok();  tok != DSN_RIGHT;  tok = lexer.NextTok() )
+                {
+                    if( tok != DSN_LEFT )
+                        lexer.Expecting( DSN_LEFT );
+
+                    lexer.NeedSYMBOL();
+                    key = lexer.CurText();
+
+                    if( key == "time" )
+                    {
+                        lexer.NeedNUMBER( "time" );
+                        entry.m_time = strtoll( lexer.CurText(), NULL, 10 );
+                    }
+                    else if( key == "size" )
+                    {
+                        lexer.NeedNUMBER( "size" );
+                        entry.m_size = strtoll( lexer.CurText(), NULL, 10 );
+                    }
+                    else if( key == "pads" )
+                    {
+                        lexer.NeedNUMBER( "pads" );
+                        entry.m_header.m_padCount = atoi( lexer.CurText() );
+                    }
+                    else if( key == "bbox" )
+                    {
+                        int coord[4];
+
+                        for( int ii = 0; ii < 4; ++ii )
+                        {
+                            lexer.NeedNUMBER( "bbox" );
+                            coord[ii] = atoi( lexer.CurText() );
+                        }
+
+                        entry.m_header.m_boundingBox = EDA_RECT( wxPoint( coord[0], coord[1] ),
+                                                                 wxSize( coord[2], coord[3] ) );
+                    }
+                    else if( key == "layers" )
+                    {
+                        lexer.NeedSYMBOLorNUMBER();
+                        entry.m_header.m_layers = strtoul( lexer.CurText(), NULL, 16 );
+                    }
+                    else if( key == "descr" )
+                    {
+                        lexer.NeedSYMBOLorNUMBER();
+                        entry.m_header.m_description = lexer.FromUTF8();
+                    }
+                    else if( key == "tags" )
+                    {
+                        lexer.NeedSYMBOLorNUMBER();
+                        entry.m_header.m_keywords = lexer.FromUTF8();
+                    }
+                    else
+                    {
+                        lexer.Unexpected( key.c_str() );
+                    }
+
+                    lexer.NeedRIGHT();
+                }
+
+                continue;
+            }
+            else
+            {
+                lexer.Unexpected( key.c_str() );
+            }
+
+            lexer.NeedRIGHT();
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    if( !pathOk )
+        return false;
+
+    m_entries.swap( entries );
+    m_dirTime = dirTime;
+
+    return true;
+}
+
+
+void FP_LIBRARY_INDEX::write() const
+{
+    wxFileName  fn( GetIndexFileName( m_libraryPath ) );
+
+    if( !fn.DirExists() && !fn.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return;
+
+    wxString    tempFileName = fn.CreateTempFileName( fn.GetPath() );
+
+    if( tempFileName.IsEmpty() )
+        return;
+
+    try
+    {
+        FILE_OUTPUTFORMATTER    out( tempFileName );
+
+        out.Print( 0, "(fp_lib_index (version %d)\n", INDEX_VERSION );
+        out.Print( 1, "(path %s)\n", out.Quotew( m_libraryPath ).c_str() );
+        out.Print( 1, "(dir_time %lld)\n", m_dirTime );
+
+        for( ENTRIES::const_iterator it = m_entries.begin();  it != m_entries.end();  ++it )
+        {
+            const ENTRY&            entry  = it->second;
+            const FOOTPRINT_HEADER& header = entry.m_header;
+            const EDA_RECT&         bbox   = header.m_boundingBox;
+
+            out.Print( 1, "(footprint %s (time %lld) (size %lld) (pads %d)\n",
+                       out.Quotes( it->first ).c_str(), entry.m_time, entry.m_size,
+                       header.m_padCount );
+            out.Print( 2, "(bbox %d %d %d %d) (layers %08X)\n",
+                       bbox.GetX(), bbox.GetY(), bbox.GetWidth(), bbox.GetHeight(),
+                       (unsigned) header.m_layers );
+            out.Print( 2, "(descr %s)\n", out.Quotew( header.m_description ).c_str() );
+            out.Print( 2, "(tags %s))\n", out.Quotew( header.m_keywords ).c_str() );
+        }
+
+        out.Print( 0, ")\n" );
+    }
+    catch( const IO_ERROR& )
+    {
+        wxRemoveFile( tempFileName );
+        return;
+    }
+
+    if( !wxRenameFile( tempFileName, fn.GetFullPath(), true ) )
+        wxRemoveFile( tempFileName );
+}
@@ -0,0 +1,129 @@
+/**
+ * @file fp_library_index.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FP_LIBRARY_INDEX_H
+#define FP_LIBRARY_INDEX_H
+
+#include <map>
+#include <string>
+
+#include <io_mgr.h>
+
+class PCB_PARSER;
+
+
+/**
+ * Class FP_LIBRARY_INDEX
+ * is the index of a .pretty footprint library directory: the file time and size,
+ * and the FOOTPRINT_HEADER of each footprint.  This is what the footprint choosers
+ * need from all the libraries, and reading it is much faster than parsing every
+ * footprint file.
+ *
+ * The index is kept in a file of the user data directory, one per library, since
+ * the library directories are often read only.  It is used as long as the library
+ * directory has the modification time it had when the index was written, which
+ * changes when a footprint is added or removed, and each footprint file has the time
+ * and size of its entry, which change when the footprint is saved.  Otherwise the
+ * directory is listed again and only the footprint files of another time or size
+ * are parsed.
+ */
+class FP_LIBRARY_INDEX
+{
+public:
+    struct ENTRY
+    {
+        long long           m_time;     ///< modification time of the footprint file
+        long long           m_size;     ///< size of the footprint file
+        FOOTPRINT_HEADER    m_header;
+    };
+
+    /// The entries by UTF8 footprint name, in the order of the footprint cache.
+    typedef std::map< std::string, ENTRY >  ENTRIES;
+
+    FP_LIBRARY_INDEX( const wxString& aLibraryPath );
+
+    /**
+     * Function GetIndexFileName
+     * @return the name of the index file of the library at @a aLibraryPath.
+     */
+    static wxString GetIndexFileName( const wxString& aLibraryPath );
+
+    /**
+     * Function IsPath
+     * @return true if this is the index of the library at @a aLibraryPath.
+     */
+    bool IsPath( const wxString& aLibraryPath ) const;
+
+    /**
+     * Function Update
+     * makes the index match the library directory, reading the index file or parsing
+     * the new and modified footprint files with @a aParser, then writes the index file
+     * if it changed.  Nothing is done if neither the directory nor the footprint files
+     * changed since the last call.
+     *
+     * @throw IO_ERROR if the library directory cannot be read, or PARSE_ERROR if a
+     *  footprint file is not valid.
+     */
+    void Update( PCB_PARSER* aParser ) throw( IO_ERROR, PARSE_ERROR );
+
+    const ENTRIES& GetEntries() const   { return m_entries; }
+
+    /**
+     * Function Find
+     * @return the entry of footprint @a aFootprintName, or NULL if there is none.
+     */
+    const ENTRY* Find( const wxString& aFootprintName ) const;
+
+private:
+    /**
+     * Function read
+     * reads the index file into m_entries and m_dirTime.
+     * @return false if there is no valid index file of this library.
+     */
+    bool read();
+
+    /**
+     * Function write
+     * writes the index file.  Errors are not reported: there is no index file then.
+     */
+    void write() const;
+
+    /**
+     * Function filesUnchanged
+     * @return true if each footprint file of m_entries still has the time and size of
+     *  its entry.  The files of the directory are not listed: this is enough only when
+     *  the directory time is m_dirTime.
+     */
+    bool filesUnchanged() const;
+
+    wxString    m_libraryPath;
+    long long   m_dirTime;          ///< time of the directory m_entries matches, 0 if unknown
+    ENTRIES     m_entries;
+};
+
+
+#endif  // FP_LIBRARY_INDEX_H
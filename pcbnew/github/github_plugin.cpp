@@ -247,6 +247,13 @@ MODULE* GITHUB_PLUGIN::FootprintLoad( const wxString& aLibraryPath,
 }
 
 
+bool GITHUB_PLUGIN::FootprintLoadHeader( const wxString& aLibraryPath,
+        const wxString& aFootprintName, FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties )
+{
+    return PLUGIN::FootprintLoadHeader( aLibraryPath, aFootprintName, aHeader, aProperties );
+}
+
+
 bool GITHUB_PLUGIN::IsFootprintLibWritable( const wxString& aLibraryPath )
 {
     if( m_pretty_dir.size() )
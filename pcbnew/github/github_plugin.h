@@ -173,6 +173,11 @@ public:
     MODULE* FootprintLoad( const wxString& aLibraryPath,
             const wxString& aFootprintName, const PROPERTIES* aProperties );
 
+    // Since I derive from PCB_IO, I have to implement this, else I'd inherit his index of
+    // a local directory.  I get the info by loading the footprint, as any PLUGIN.
+    bool FootprintLoadHeader( const wxString& aLibraryPath, const wxString& aFootprintName,
+            FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties = NULL );
+
     void FootprintSave( const wxString& aLibraryPath, const MODULE* aFootprint,
             const PROPERTIES* aProperties = NULL );
 
@@ -27,12 +27,43 @@
 
 #include <richio.h>
 #include <map>
+#include <base_struct.h>          // EDA_RECT
+#include <layers_id_colors_and_visibility.h>
 
 
 class BOARD;
 class PLUGIN;
 class MODULE;
 
+/**
+ * Struct FOOTPRINT_HEADER
+ * is what the footprint choosers show and filter about a footprint, without the
+ * pads, drawings and 3D models of the footprint itself.  A PLUGIN can return it
+ * much more cheaply than a MODULE, and keeping it takes much less memory.
+ */
+struct FOOTPRINT_HEADER
+{
+    wxString    m_name;             ///< footprint name, without library nickname
+    wxString    m_description;
+    wxString    m_keywords;
+    int         m_padCount;         ///< number of pads, without the NPTH pads
+    EDA_RECT    m_boundingBox;      ///< area of the pads and drawings, as MODULE::GetFootprintRect()
+    LAYER_MSK   m_layers;           ///< layers of the footprint, its pads and its drawings
+
+    FOOTPRINT_HEADER() :
+        m_padCount( 0 ),
+        m_layers( NO_LAYERS )
+    {
+    }
+
+    /**
+     * Function SetFrom
+     * fills the header from the whole footprint @a aModule.
+     */
+    void SetFrom( const MODULE* aModule );
+};
+
+
 /**
  * Class PROPERTIES
  * is a name/value tuple with unique names and optional values.  The names
@@ -326,6 +357,32 @@ public:
     virtual MODULE* FootprintLoad( const wxString& aLibraryPath, const wxString& aFootprintName,
             const PROPERTIES* aProperties = NULL );
 
+    /**
+     * Function FootprintLoadHeader
+     * reads the FOOTPRINT_HEADER of footprint @a aFootprintName in the @a aLibraryPath,
+     * which is what the footprint choosers show and filter.  The default implementation
+     * loads the whole footprint; a plugin which keeps an index of its libraries can
+     * answer without loading it.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *   or URL containing several footprints.
+     *
+     * @param aFootprintName is the name of the footprint.
+     *
+     * @param aHeader receives the header of the footprint.
+     *
+     * @param aProperties is an associative array that can be used to tell the
+     *  loader implementation to do something special.  The caller continues to own
+     *  this object (plugin may not delete it), and plugins should expect it to be
+     *  optionally NULL.
+     *
+     * @return bool - true if the footprint was found, else false.
+     *
+     * @throw   IO_ERROR if the library cannot be found or read.
+     */
+    virtual bool FootprintLoadHeader( const wxString& aLibraryPath, const wxString& aFootprintName,
+            FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties = NULL );
+
     /**
      * Function FootprintSave
      * will write @a aModule to an existing library located at @a aLibraryPath.
@@ -45,6 +45,8 @@
 #include <zones.h>
 #include <kicad_plugin.h>
 #include <pcb_parser.h>
+#include <pcb_binary_cache.h>
+#include <fp_library_index.h>
 
 #include <wx/dir.h>
 #include <wx/filename.h>
@@ -61,6 +63,99 @@
 static const wxString traceFootprintLibrary( wxT( "KicadFootprintLib" ) );
 
 
+/**
+ * Class FORMAT_LINE
+ * builds output text in a fixed size buffer, for the items a board holds by the
+ * thousands (tracks, vias and zone corners).  Numbers are converted without
+ * temporary strings, and the text goes to the OUTPUTFORMATTER in large writes.
+ * Flush() must be called once the text is complete.
+ */
+class FORMAT_LINE
+{
+public:
+    FORMAT_LINE( OUTPUTFORMATTER* aOut, int aNestLevel = 0 ) :
+        m_out( aOut ),
+        m_len( 0 )
+    {
+        Indent( aNestLevel );
+    }
+
+    FORMAT_LINE& Indent( int aNestLevel )
+    {
+        for( int ii = 0; ii < aNestLevel; ++ii )
+            Text( "  ", 2 );        // as OUTPUTFORMATTER::Print()
+
+        return *this;
+    }
+
+    FORMAT_LINE& Text( const char* aText, int aLength )
+    {
+        if( m_len + aLength > (int) sizeof( m_buffer ) )
+        {
+            Flush();
+
+            if( aLength > (int) sizeof( m_buffer ) )
+            {
+                m_out->PrintRaw( aText, aLength );
+                return *this;
+            }
+        }
+
+        memcpy( m_buffer + m_len, aText, aLength );
+        m_len += aLength;
+        return *this;
+    }
+
+    FORMAT_LINE& Text( const char* aText )          { return Text( aText, strlen( aText ) ); }
+    FORMAT_LINE& Text( const std::string& aText )   { return Text( aText.data(), aText.size() ); }
+
+    FORMAT_LINE& IU( int aValue )
+    {
+        reserve( FORMAT_IU_MAX_LEN );
+        m_len += BOARD_ITEM::FormatInternalUnits( aValue, m_buffer + m_len );
+        return *this;
+    }
+
+    FORMAT_LINE& IU( const wxPoint& aPoint )
+    {
+        IU( aPoint.x );
+        Text( " ", 1 );
+        return IU( aPoint.y );
+    }
+
+    FORMAT_LINE& Int( int aValue )
+    {
+        reserve( 16 );
+        m_len += sprintf( m_buffer + m_len, "%d", aValue );
+        return *this;
+    }
+
+    FORMAT_LINE& Hex( unsigned long aValue )
+    {
+        reserve( 24 );
+        m_len += sprintf( m_buffer + m_len, "%lX", aValue );
+        return *this;
+    }
+
+    void Flush() throw( IO_ERROR )
+    {
+        m_out->PrintRaw( m_buffer, m_len );
+        m_len = 0;
+    }
+
+private:
+    void reserve( int aLength )
+    {
+        if( m_len + aLength > (int) sizeof( m_buffer ) )
+            Flush();
+    }
+
+    OUTPUTFORMATTER*    m_out;
+    char                m_buffer[4096];
+    int                 m_len;
+};
+
+
 /**
  * Class FP_CACHE_ITEM
  * is helper class for creating a footprint library cache.
@@ -69,13 +164,16 @@ static const wxString traceFootprintLibrary( wxT( "KicadFootprintLib" ) );
  * that contain a single module per file.  This class is a helper only for the
  * footprint portion of the PLUGIN API, and only for the #PCB_IO plugin.  It is
  * private to this implementation file so it is not placed into a header.
+ *
+ * The footprint file is parsed only when the footprint is needed: see
+ * FP_CACHE::GetModule().
  */
 class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     bool                    m_writable;  ///< Writability status of the footprint file.
     wxDateTime              m_mod_time;  ///< The last file modified time stamp.
-    std::auto_ptr<MODULE>   m_module;
+    std::auto_ptr<MODULE>   m_module;    ///< NULL until the footprint file is parsed.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -87,6 +185,7 @@ public:
     bool        IsModified() const;
 
     MODULE*     GetModule() const { return m_module.get(); }
+    void        SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
     void        UpdateModificationTime() { m_mod_time = m_file_name.GetModificationTime(); }
 };
 
@@ -145,8 +244,19 @@ public:
     /// save the entire legacy library to m_lib_name;
     void Save();
 
+    /**
+     * Function Load
+     * lists the footprint files of the library.  They are not parsed here.
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * @return the footprint of cache item @a aItem, after parsing its file if this
+     *  was not done yet.
+     */
+    MODULE* GetModule( FP_CACHE_ITEM* aItem );
+
     void Remove( const wxString& aFootprintName );
 
     wxDateTime GetLibModificationTime() const;
@@ -212,6 +322,10 @@ void FP_CACHE::Save()
     {
         wxFileName fn = it->second->GetFileName();
 
+        // A footprint which was never parsed is the content of its file.
+        if( !it->second->GetModule() )
+            continue;
+
         if( fn.FileExists() && !it->second->IsModified() )
             continue;
 
@@ -271,16 +385,9 @@ void FP_CACHE::Load()
             // prepend the libpath into fullPath
             wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
 
-            FILE_LINE_READER    reader( fullPath.GetFullPath() );
-
-            m_owner->m_parser->SetLineReader( &reader );
-
+            // The footprint is parsed by GetModule(), when it is needed.
             std::string name = TO_UTF8( fullPath.GetName() );
-            MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-
-            // The footprint name is the file name without the extension.
-            footprint->SetFPID( fullPath.GetName() );
-            m_modules.insert( name, new FP_CACHE_ITEM( footprint, fullPath ) );
+            m_modules.insert( name, new FP_CACHE_ITEM( NULL, fullPath ) );
 
         } while( dir.GetNext( &fpFileName ) );
 
@@ -292,6 +399,30 @@ void FP_CACHE::Load()
 }
 
 
+MODULE* FP_CACHE::GetModule( FP_CACHE_ITEM* aItem )
+{
+    if( !aItem->GetModule() )
+    {
+        wxFileName fullPath = aItem->GetFileName();
+
+        // The footprint is as new as the file content parsed now.
+        aItem->UpdateModificationTime();
+
+        MAPPED_FILE_LINE_READER reader( fullPath.GetFullPath() );
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+        // The footprint name is the file name without the extension.
+        footprint->SetFPID( fullPath.GetName() );
+        aItem->SetModule( footprint );
+    }
+
+    return aItem->GetModule();
+}
+
+
 void FP_CACHE::Remove( const wxString& aFootprintName )
 {
 
@@ -546,6 +677,11 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
 
     m_out->Print( aNestLevel, ")\n\n" );
 
+    m_quotedLayerNames.clear();
+
+    for( LAYER_NUM layer = FIRST_LAYER; layer < NB_LAYERS; ++layer )
+        m_quotedLayerNames.push_back( m_out->Quotew( aBoard->GetLayerName( layer ) ) );
+
     // Setup
     m_out->Print( aNestLevel, "(setup\n" );
 
@@ -681,11 +817,7 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     }
 
     // Save the modules.
-    for( MODULE* module = aBoard->m_Modules;  module;  module = (MODULE*) module->Next() )
-    {
-        Format( module, aNestLevel );
-        m_out->Print( 0, "\n" );
-    }
+    formatModules( aBoard, aNestLevel );
 
     // Save the graphical items on the board (not owned by a module)
     for( BOARD_ITEM* item = aBoard->m_Drawings;  item;  item = item->Next() )
@@ -709,6 +841,81 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     // Save the polygon (which are the newer technology) zones.
     for( int i=0;  i < aBoard->GetAreaCount();  ++i )
         Format( aBoard->GetArea( i ), aNestLevel );
+
+    m_quotedLayerNames.clear();
+}
+
+
+void PCB_IO::formatModules( BOARD* aBoard, int aNestLevel ) const
+    throw( IO_ERROR )
+{
+    std::vector<MODULE*> modules;
+
+    for( MODULE* module = aBoard->m_Modules;  module;  module = (MODULE*) module->Next() )
+        modules.push_back( module );
+
+    std::vector<std::string> texts( modules.size() );
+
+    // The first error in the module order, as if they were formatted one by one.
+    int         errorIndex = -1;
+    IO_ERROR    error;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel
+#endif /* USE_OPENMP */
+    {
+        // Each thread formats into its own string, with its own PCB_IO.
+        PCB_IO              io( m_ctl );
+        STRING_FORMATTER    sf;
+
+        io.m_board = m_board;
+        *io.m_mapping = *m_mapping;
+        io.SetOutputFormatter( &sf );
+
+#ifdef USE_OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+        for( int ii = 0; ii < (int) modules.size(); ++ii )
+        {
+            try
+            {
+                io.Format( modules[ii], aNestLevel );
+                sf.Print( 0, "\n" );
+                texts[ii] = sf.GetString();
+            }
+            catch( const IO_ERROR& ioe )
+            {
+#ifdef USE_OPENMP
+                #pragma omp critical
+#endif /* USE_OPENMP */
+                {
+                    if( errorIndex < 0 || ii < errorIndex )
+                    {
+                        errorIndex = ii;
+                        error = ioe;
+                    }
+                }
+            }
+
+            sf.Clear();
+        }
+    }
+
+    if( errorIndex >= 0 )
+    {
+        // Output what the modules before the bad one would have given.
+        for( int ii = 0; ii < errorIndex; ++ii )
+            m_out->PrintRaw( texts[ii].data(), texts[ii].size() );
+
+        throw error;
+    }
+
+    for( unsigned ii = 0; ii < texts.size(); ++ii )
+    {
+        m_out->PrintRaw( texts[ii].data(), texts[ii].size() );
+
+        std::string().swap( texts[ii] );    // free it now, a large board has a lot of text
+    }
 }
 
 
@@ -1338,6 +1545,8 @@ void PCB_IO::format( TEXTE_MODULE* aText, int aNestLevel ) const
 void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
     throw( IO_ERROR )
 {
+    FORMAT_LINE line( m_out, aNestLevel );
+
     if( aTrack->Type() == PCB_VIA_T )
     {
         LAYER_NUM layer1, layer2;
@@ -1348,7 +1557,7 @@ void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
         wxCHECK_RET( board != 0, wxT( "Via " ) + via->GetSelectMenuText() +
                      wxT( " has no parent." ) );
 
-        m_out->Print( aNestLevel, "(via" );
+        line.Text( "(via" );
 
         via->LayerPair( &layer1, &layer2 );
 
@@ -1358,46 +1567,57 @@ void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
             break;
 
         case VIA_BLIND_BURIED:
-            m_out->Print( 0, " blind" );
+            line.Text( " blind" );
             break;
 
         case VIA_MICROVIA:
-            m_out->Print( 0, " micro" );
+            line.Text( " micro" );
             break;
 
         default:
             THROW_IO_ERROR( wxString::Format( _( "unknown via type %d"  ), aTrack->GetShape() ) );
         }
 
-        m_out->Print( 0, " (at %s) (size %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
+        line.Text( " (at " ).IU( aTrack->GetStart() )
+            .Text( ") (size " ).IU( aTrack->GetWidth() ).Text( ")" );
 
         if( aTrack->GetDrill() != UNDEFINED_DRILL_DIAMETER )
-            m_out->Print( 0, " (drill %s)", FMT_IU( aTrack->GetDrill() ).c_str() );
+            line.Text( " (drill " ).IU( aTrack->GetDrill() ).Text( ")" );
 
-        m_out->Print( 0, " (layers %s %s)",
-                      m_out->Quotew( m_board->GetLayerName( layer1 ) ).c_str(),
-                      m_out->Quotew( m_board->GetLayerName( layer2 ) ).c_str() );
+        line.Text( " (layers " ).Text( quotedLayerName( m_board, layer1 ) )
+            .Text( " " ).Text( quotedLayerName( m_board, layer2 ) ).Text( ")" );
     }
     else
     {
-        m_out->Print( aNestLevel, "(segment (start %s) (end %s) (width %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(), FMT_IU( aTrack->GetEnd() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
+        line.Text( "(segment (start " ).IU( aTrack->GetStart() )
+            .Text( ") (end " ).IU( aTrack->GetEnd() )
+            .Text( ") (width " ).IU( aTrack->GetWidth() ).Text( ")" );
 
-        m_out->Print( 0, " (layer %s)", m_out->Quotew( aTrack->GetLayerName() ).c_str() );
+        line.Text( " (layer " ).Text( quotedLayerName( aTrack->GetBoard(), aTrack->GetLayer() ) ).Text( ")" );
     }
 
-    m_out->Print( 0, " (net %d)", m_mapping->Translate( aTrack->GetNetCode() ) );
+    line.Text( " (net " ).Int( m_mapping->Translate( aTrack->GetNetCode() ) ).Text( ")" );
 
     if( aTrack->GetTimeStamp() != 0 )
-        m_out->Print( 0, " (tstamp %lX)", aTrack->GetTimeStamp() );
+        line.Text( " (tstamp " ).Hex( (unsigned long) aTrack->GetTimeStamp() ).Text( ")" );
 
     if( aTrack->GetStatus() != 0 )
-        m_out->Print( 0, " (status %X)", aTrack->GetStatus() );
+        line.Text( " (status " ).Hex( (unsigned) aTrack->GetStatus() ).Text( ")" );
 
-    m_out->Print( 0, ")\n" );
+    line.Text( ")\n" );
+    line.Flush();
+}
+
+
+std::string PCB_IO::quotedLayerName( const BOARD* aBoard, LAYER_NUM aLayer ) const
+{
+    if( aLayer >= 0 && aLayer < (int) m_quotedLayerNames.size() )
+        return m_quotedLayerNames[aLayer];
+
+    if( aBoard )
+        return m_out->Quotew( aBoard->GetLayerName( aLayer ) );
+
+    return m_out->Quotew( BOARD::GetStandardLayerName( aLayer ) );
 }
 
 
@@ -1507,24 +1727,35 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
                           FMT_IU( aZone->GetCornerRadius() ).c_str() );
     }
 
+    // The fingerprint of the data used to calculate the filled areas, which
+    // allows to skip the zone on next refill if nothing was changed.
+    unsigned long long fingerprint = aZone->GetFillFingerprint();
+
+    if( fingerprint )
+        m_out->Print( 0, " (fingerprint %08X%08X)",
+                      (unsigned) ( fingerprint >> 32 ), (unsigned) ( fingerprint & 0xFFFFFFFF ) );
+
     m_out->Print( 0, ")\n" );
 
     const CPOLYGONS_LIST& cv = aZone->Outline()->m_CornersList;
     int newLine = 0;
 
+    // Zones may have many thousands of corners: they are written with a FORMAT_LINE.
+    FORMAT_LINE line( m_out );
+
     if( cv.GetCornersCount() )
     {
-        m_out->Print( aNestLevel+1, "(polygon\n");
-        m_out->Print( aNestLevel+2, "(pts\n" );
+        line.Indent( aNestLevel+1 ).Text( "(polygon\n" );
+        line.Indent( aNestLevel+2 ).Text( "(pts\n" );
 
         for( unsigned it = 0; it < cv.GetCornersCount(); ++it )
         {
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
+                line.Indent( aNestLevel+3 ).Text( "(xy " );
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
+                line.Text( " (xy " );
+
+            line.IU( cv.GetX( it ) ).Text( " " ).IU( cv.GetY( it ) ).Text( ")" );
 
             if( newLine < 4 )
             {
@@ -1533,27 +1764,27 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
             else
             {
                 newLine = 0;
-                m_out->Print( 0, "\n" );
+                line.Text( "\n" );
             }
 
             if( cv.IsEndContour( it ) )
             {
                 if( newLine != 0 )
-                    m_out->Print( 0, "\n" );
+                    line.Text( "\n" );
 
-                m_out->Print( aNestLevel+2, ")\n" );
+                line.Indent( aNestLevel+2 ).Text( ")\n" );
 
                 if( it+1 != cv.GetCornersCount() )
                 {
                     newLine = 0;
-                    m_out->Print( aNestLevel+1, ")\n" );
-                    m_out->Print( aNestLevel+1, "(polygon\n" );
-                    m_out->Print( aNestLevel+2, "(pts" );
+                    line.Indent( aNestLevel+1 ).Text( ")\n" );
+                    line.Indent( aNestLevel+1 ).Text( "(polygon\n" );
+                    line.Indent( aNestLevel+2 ).Text( "(pts" );
                 }
             }
         }
 
-        m_out->Print( aNestLevel+1, ")\n" );
+        line.Indent( aNestLevel+1 ).Text( ")\n" );
     }
 
     // Save the PolysList
@@ -1562,17 +1793,17 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
     if( fv.GetCornersCount() )
     {
-        m_out->Print( aNestLevel+1, "(filled_polygon\n" );
-        m_out->Print( aNestLevel+2, "(pts\n" );
+        line.Indent( aNestLevel+1 ).Text( "(filled_polygon\n" );
+        line.Indent( aNestLevel+2 ).Text( "(pts\n" );
 
         for( unsigned it = 0; it < fv.GetCornersCount();  ++it )
         {
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( fv.GetX( it ) ).c_str(), FMT_IU( fv.GetY( it ) ).c_str() );
+                line.Indent( aNestLevel+3 ).Text( "(xy " );
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( fv.GetX( it ) ).c_str(), FMT_IU( fv.GetY( it ) ).c_str() );
+                line.Text( " (xy " );
+
+            line.IU( fv.GetX( it ) ).Text( " " ).IU( fv.GetY( it ) ).Text( ")" );
 
             if( newLine < 4 )
             {
@@ -1581,27 +1812,27 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
             else
             {
                 newLine = 0;
-                m_out->Print( 0, "\n" );
+                line.Text( "\n" );
             }
 
             if( fv.IsEndContour( it ) )
             {
                 if( newLine != 0 )
-                    m_out->Print( 0, "\n" );
+                    line.Text( "\n" );
 
-                m_out->Print( aNestLevel+2, ")\n" );
+                line.Indent( aNestLevel+2 ).Text( ")\n" );
 
                 if( it+1 != fv.GetCornersCount() )
                 {
                     newLine = 0;
-                    m_out->Print( aNestLevel+1, ")\n" );
-                    m_out->Print( aNestLevel+1, "(filled_polygon\n" );
-                    m_out->Print( aNestLevel+2, "(pts\n" );
+                    line.Indent( aNestLevel+1 ).Text( ")\n" );
+                    line.Indent( aNestLevel+1 ).Text( "(filled_polygon\n" );
+                    line.Indent( aNestLevel+2 ).Text( "(pts\n" );
                 }
             }
         }
 
-        m_out->Print( aNestLevel+1, ")\n" );
+        line.Indent( aNestLevel+1 ).Text( ")\n" );
     }
 
     // Save the filling segments list
@@ -1609,24 +1840,25 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
     if( segs.size() )
     {
-        m_out->Print( aNestLevel+1, "(fill_segments\n" );
+        line.Indent( aNestLevel+1 ).Text( "(fill_segments\n" );
 
         for( std::vector< SEGMENT >::const_iterator it = segs.begin();  it != segs.end();  ++it )
         {
-            m_out->Print( aNestLevel+2, "(pts (xy %s) (xy %s))\n",
-                          FMT_IU( it->m_Start ).c_str(),
-                          FMT_IU( it->m_End ).c_str() );
+            line.Indent( aNestLevel+2 ).Text( "(pts (xy " ).IU( it->m_Start )
+                .Text( ") (xy " ).IU( it->m_End ).Text( "))\n" );
         }
 
-        m_out->Print( aNestLevel+1, ")\n" );
+        line.Indent( aNestLevel+1 ).Text( ")\n" );
     }
 
-    m_out->Print( aNestLevel, ")\n" );
+    line.Indent( aNestLevel ).Text( ")\n" );
+    line.Flush();
 }
 
 
 PCB_IO::PCB_IO( int aControlFlags ) :
     m_cache( 0 ),
+    m_index( 0 ),
     m_ctl( aControlFlags ),
     m_parser( new PCB_PARSER() ),
     m_mapping( new NETINFO_MAPPING() )
@@ -1639,6 +1871,7 @@ PCB_IO::PCB_IO( int aControlFlags ) :
 PCB_IO::~PCB_IO()
 {
     delete m_cache;
+    delete m_index;
     delete m_parser;
     delete m_mapping;
 }
@@ -1646,16 +1879,43 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
+    // The tracks, vias and zones of a large board are read from its binary cache,
+    // when it matches the board file.
+    PCB_BINARY_CACHE binaryCache( aFileName );
+    bool             cacheUsable = !aAppendToMe && binaryCache.IsWorthCaching();
+    bool             useCache = cacheUsable && binaryCache.Read();
+
     m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
+    m_parser->SetSkipTracksAndZones( useCache );
 
     BOARD* board = dynamic_cast<BOARD*>( m_parser->Parse() );
     wxASSERT( board );
 
+    if( useCache && !binaryCache.AddItems( board ) )
+    {
+        // Should not happen, as the cache was written for this very file: parse again
+        delete board;
+
+        MAPPED_FILE_LINE_READER retryReader( aFileName );
+
+        m_parser->SetLineReader( &retryReader );
+        m_parser->SetBoard( NULL );
+        m_parser->SetSkipTracksAndZones( false );
+
+        board = dynamic_cast<BOARD*>( m_parser->Parse() );
+        wxASSERT( board );
+
+        useCache = false;
+    }
+
+    if( cacheUsable && !useCache )
+        binaryCache.Write( board );
+
     // Give the filename to the board if it's new
     if( !aAppendToMe )
         board->SetFileName( aFileName );
@@ -1667,6 +1927,7 @@ BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPER
 void PCB_IO::init( const PROPERTIES* aProperties )
 {
     m_board = NULL;
+    m_quotedLayerNames.clear();
     m_props = aProperties;
 }
 
@@ -1683,6 +1944,18 @@ void PCB_IO::cacheLib( const wxString& aLibraryPath, const wxString& aFootprintN
 }
 
 
+void PCB_IO::indexLib( const wxString& aLibraryPath )
+{
+    if( !m_index || !m_index->IsPath( aLibraryPath ) )
+    {
+        delete m_index;
+        m_index = new FP_LIBRARY_INDEX( aLibraryPath );
+    }
+
+    m_index->Update( m_parser );
+}
+
+
 wxArrayString PCB_IO::FootprintEnumerate( const wxString&   aLibraryPath,
                                           const PROPERTIES* aProperties )
 {
@@ -1698,13 +1971,14 @@ wxArrayString PCB_IO::FootprintEnumerate( const wxString&   aLibraryPath,
 
     init( aProperties );
 
-#if 1                         // Set to 0 to only read directory contents, not load cache.
-    cacheLib( aLibraryPath );
-
-    const MODULE_MAP& mods = m_cache->GetModules();
+#if 1                         // Set to 0 to only read directory contents, not use the index.
+    // The index gives the same names, in the same order, as the cache, without
+    // parsing the footprint files which were already indexed.
+    indexLib( aLibraryPath );
 
+    const FP_LIBRARY_INDEX::ENTRIES& entries = m_index->GetEntries();
 
-    for( MODULE_CITER it = mods.begin();  it != mods.end();  ++it )
+    for( FP_LIBRARY_INDEX::ENTRIES::const_iterator it = entries.begin();  it != entries.end();  ++it )
     {
         ret.Add( FROM_UTF8( it->first.c_str() ) );
     }
@@ -1735,17 +2009,37 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 
     cacheLib( aLibraryPath, aFootprintName );
 
-    const MODULE_MAP& mods = m_cache->GetModules();
+    MODULE_MAP& mods = m_cache->GetModules();
 
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE_ITER it = mods.find( TO_UTF8( aFootprintName ) );
 
     if( it == mods.end() )
     {
         return NULL;
     }
 
-    // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second->GetModule() );
+    // copy constructor to clone the MODULE, which is parsed only the first time
+    return new MODULE( *m_cache->GetModule( it->second ) );
+}
+
+
+bool PCB_IO::FootprintLoadHeader( const wxString& aLibraryPath, const wxString& aFootprintName,
+                                  FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    init( aProperties );
+
+    indexLib( aLibraryPath );
+
+    const FP_LIBRARY_INDEX::ENTRY* entry = m_index->Find( aFootprintName );
+
+    if( !entry )
+        return false;
+
+    *aHeader = entry->m_header;
+
+    return true;
 }
 
 
@@ -26,17 +26,20 @@
 
 #include <io_mgr.h>
 #include <string>
+#include <vector>
 #include <layers_id_colors_and_visibility.h>
 
 class BOARD;
 class BOARD_ITEM;
 class FP_CACHE;
+class FP_LIBRARY_INDEX;
 class PCB_PARSER;
 class NETINFO_MAPPING;
 
 
 /// Current s-expression file format version.  2 was the last legacy format version.
-#define SEXPR_BOARD_FILE_VERSION    3
+/// 4 adds the (fingerprint ...) of the filled zones.
+#define SEXPR_BOARD_FILE_VERSION    4
 
 
 #define CTL_STD_LAYER_NAMES         (1 << 0)    ///< Use English Standard layer names
@@ -110,6 +113,9 @@ public:
     MODULE* FootprintLoad( const wxString& aLibraryPath, const wxString& aFootprintName,
                            const PROPERTIES* aProperties = NULL );
 
+    bool FootprintLoadHeader( const wxString& aLibraryPath, const wxString& aFootprintName,
+                              FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties = NULL );
+
     void FootprintSave( const wxString& aLibraryPath, const MODULE* aFootprint,
                         const PROPERTIES* aProperties = NULL );
 
@@ -160,6 +166,7 @@ protected:
     const
     PROPERTIES*     m_props;        ///< passed via Save() or Load(), no ownership, may be NULL.
     FP_CACHE*       m_cache;        ///< Footprint library cache.
+    FP_LIBRARY_INDEX* m_index;      ///< Footprint library index, for the enumeration.
 
     LINE_READER*    m_reader;       ///< no ownership here.
     wxString        m_filename;     ///< for saves only, name is in m_reader for loads
@@ -173,9 +180,17 @@ protected:
     NETINFO_MAPPING*    m_mapping;  ///< mapping for net codes, so only not empty net codes
                                     ///< are stored with consecutive integers as net codes
 
+    /// the quoted layer names of the board being formatted, indexed by layer number,
+    /// so the tracks do not convert them again and again.  Empty outside format( BOARD* ).
+    mutable std::vector<std::string>    m_quotedLayerNames;
+
     /// we only cache one footprint library, this determines which one.
     void cacheLib( const wxString& aLibraryPath, const wxString& aFootprintName = wxEmptyString );
 
+    /// bring the index of the library at aLibraryPath up to date, without loading the
+    /// footprints which did not change.
+    void indexLib( const wxString& aLibraryPath );
+
     void init( const PROPERTIES* aProperties );
 
 private:
@@ -212,8 +227,23 @@ private:
     void format( ZONE_CONTAINER* aZone, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
+    /**
+     * Function formatModules
+     * formats the modules of @a aBoard in parallel, each one in its own string, then
+     * outputs the strings in the order of the module list.
+     */
+    void formatModules( BOARD* aBoard, int aNestLevel = 0 ) const
+        throw( IO_ERROR );
+
     void formatLayer( const BOARD_ITEM* aItem ) const;
 
+    /**
+     * Function quotedLayerName
+     * @return the quoted name of layer @a aLayer, from m_quotedLayerNames if it is
+     *  filled, else from @a aBoard, which may be NULL.
+     */
+    std::string quotedLayerName( const BOARD* aBoard, LAYER_NUM aLayer ) const;
+
     void formatLayers( LAYER_MSK aLayerMask, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 };
@@ -92,17 +92,8 @@ NETLIST_READER* NETLIST_READER::GetNetlistReader( NETLIST*        aNetlist,
 {
     wxASSERT( aNetlist != NULL );
 
-    FILE* file = wxFopen( aNetlistFileName, wxT( "rt" ) );
-
-    if( file == NULL )
-    {
-        wxString msg;
-        msg.Printf( _( "Cannot open file %s for reading." ), GetChars( aNetlistFileName ) );
-        THROW_IO_ERROR( msg );
-    }
-
-    FILE_LINE_READER* reader = new FILE_LINE_READER( file, aNetlistFileName );
-    std::auto_ptr< FILE_LINE_READER > r( reader );
+    MAPPED_FILE_LINE_READER* reader = new MAPPED_FILE_LINE_READER( aNetlistFileName );
+    std::auto_ptr< MAPPED_FILE_LINE_READER > r( reader );
 
     NETLIST_FILE_T type = GuessNetlistFileType( reader );
     reader->Rewind();
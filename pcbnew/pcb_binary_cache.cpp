@@ -0,0 +1,552 @@
+/**
+ * @file pcb_binary_cache.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstring>
+#include <vector>
+
+#include <fctsys.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+#include <pcb_binary_cache.h>
+
+
+#define CACHE_MAGIC                 "KiPcbBin"
+#define CACHE_VERSION               1
+#define CACHE_BYTE_ORDER_MARK       0x01020304
+
+/// Smaller board files are parsed fast enough without a cache
+#define CACHE_MIN_BOARD_FILE_SIZE   ( 4 * 1024 * 1024 )
+
+/// The size of the blocks of the board file read to compute its hash
+#define HASH_BLOCK_SIZE             ( 1024 * 1024 )
+
+
+struct CACHE_HEADER
+{
+    char                magic[8];
+    unsigned            version;
+    unsigned            byteOrder;
+    unsigned long long  fileSize;           ///< of the board file
+    long long           fileTime;           ///< modification time of the board file
+    unsigned long long  fileHash;           ///< hash of the board file content
+};
+
+
+/**
+ * Class CACHE_WRITER
+ * appends values to a string, with the memory layout of their type.
+ */
+class CACHE_WRITER
+{
+public:
+    CACHE_WRITER( std::string& aOutput ) :
+        m_output( aOutput )
+    {
+    }
+
+    template<class T>
+    void Put( const T& aValue )
+    {
+        m_output.append( (const char*) &aValue, sizeof( aValue ) );
+    }
+
+    void PutPoint( const wxPoint& aPoint )
+    {
+        Put<int>( aPoint.x );
+        Put<int>( aPoint.y );
+    }
+
+private:
+    std::string& m_output;
+};
+
+
+/**
+ * Class CACHE_READER
+ * reads the values written by a CACHE_WRITER.  Reading past the end of the data
+ * returns zeros, and IsOk() is then false.
+ */
+class CACHE_READER
+{
+public:
+    CACHE_READER( const std::string& aInput ) :
+        m_cur( aInput.data() ),
+        m_end( aInput.data() + aInput.size() ),
+        m_ok( true )
+    {
+    }
+
+    template<class T>
+    T Get()
+    {
+        T value = T();
+
+        if( (size_t) ( m_end - m_cur ) < sizeof( value ) )
+        {
+            m_ok  = false;
+            m_cur = m_end;
+        }
+        else
+        {
+            memcpy( &value, m_cur, sizeof( value ) );
+            m_cur += sizeof( value );
+        }
+
+        return value;
+    }
+
+    wxPoint GetPoint()
+    {
+        int x = Get<int>();
+        return wxPoint( x, Get<int>() );
+    }
+
+    /**
+     * Function GetCount
+     * reads an item count, checking the remaining data can hold it.
+     * @param aItemSize is the size of the smallest item.
+     */
+    unsigned GetCount( size_t aItemSize )
+    {
+        unsigned count = Get<unsigned>();
+
+        if( (size_t) ( m_end - m_cur ) / aItemSize < count )
+        {
+            m_ok  = false;
+            count = 0;
+        }
+
+        return count;
+    }
+
+    bool IsOk() const       { return m_ok; }
+    bool AtEnd() const      { return m_cur == m_end; }
+
+private:
+    const char* m_cur;
+    const char* m_end;
+    bool        m_ok;
+};
+
+
+static void writeTrack( CACHE_WRITER& aWriter, const TRACK* aTrack )
+{
+    bool isVia = aTrack->Type() == PCB_VIA_T;
+
+    aWriter.Put<unsigned char>( isVia );
+    aWriter.Put<int>( aTrack->GetLayer() );
+    aWriter.Put<int>( aTrack->GetNetCode() );
+    aWriter.PutPoint( aTrack->GetStart() );
+    aWriter.PutPoint( aTrack->GetEnd() );
+    aWriter.Put<int>( aTrack->GetWidth() );
+    aWriter.Put<long long>( aTrack->GetTimeStamp() );
+    aWriter.Put<unsigned>( aTrack->GetStatus() );
+
+    if( isVia )
+    {
+        aWriter.Put<int>( aTrack->GetShape() );
+        aWriter.Put<int>( aTrack->GetDrill() );
+    }
+}
+
+
+static TRACK* readTrack( CACHE_READER& aReader, BOARD* aBoard )
+{
+    bool    isVia = aReader.Get<unsigned char>() != 0;
+    TRACK*  track = isVia ? new SEGVIA( aBoard ) : new TRACK( aBoard );
+
+    // For vias, the layer holds the layer pair
+    track->SetLayer( aReader.Get<int>() );
+    track->SetNetCode( aReader.Get<int>() );
+    track->SetStart( aReader.GetPoint() );
+    track->SetEnd( aReader.GetPoint() );
+    track->SetWidth( aReader.Get<int>() );
+    track->SetTimeStamp( (time_t) aReader.Get<long long>() );
+    track->SetStatus( aReader.Get<unsigned>() );
+
+    if( isVia )
+    {
+        track->SetShape( aReader.Get<int>() );
+        track->SetDrill( aReader.Get<int>() );
+    }
+
+    return track;
+}
+
+
+static void writeZone( CACHE_WRITER& aWriter, const ZONE_CONTAINER* aZone )
+{
+    aWriter.Put<int>( aZone->GetLayer() );
+    aWriter.Put<int>( aZone->GetNetCode() );
+    aWriter.Put<long long>( aZone->GetTimeStamp() );
+    aWriter.Put<unsigned>( aZone->GetPriority() );
+    aWriter.Put<int>( aZone->GetPadConnection() );
+    aWriter.Put<int>( aZone->GetZoneClearance() );
+    aWriter.Put<int>( aZone->GetMinThickness() );
+    aWriter.Put<unsigned char>( aZone->IsFilled() );
+    aWriter.Put<int>( aZone->GetFillMode() );
+    aWriter.Put<int>( aZone->GetArcSegmentCount() );
+    aWriter.Put<int>( aZone->GetThermalReliefGap() );
+    aWriter.Put<int>( aZone->GetThermalReliefCopperBridge() );
+    aWriter.Put<int>( aZone->GetCornerSmoothingType() );
+    aWriter.Put<unsigned>( aZone->GetCornerRadius() );
+    aWriter.Put<unsigned long long>( aZone->GetFillFingerprint() );
+    aWriter.Put<unsigned char>( aZone->GetIsKeepout() );
+    aWriter.Put<unsigned char>( aZone->GetDoNotAllowCopperPour() );
+    aWriter.Put<unsigned char>( aZone->GetDoNotAllowVias() );
+    aWriter.Put<unsigned char>( aZone->GetDoNotAllowTracks() );
+    aWriter.Put<int>( aZone->Outline()->GetHatchStyle() );
+    aWriter.Put<int>( aZone->Outline()->GetHatchPitch() );
+
+    const CPolyLine* outline = aZone->Outline();
+
+    aWriter.Put<unsigned>( outline->GetCornersCount() );
+
+    for( int ii = 0; ii < outline->GetCornersCount(); ++ii )
+    {
+        aWriter.PutPoint( outline->GetPos( ii ) );
+        aWriter.Put<unsigned char>( outline->IsEndContour( ii ) );
+    }
+
+    const CPOLYGONS_LIST& filledPolys = aZone->GetFilledPolysList();
+
+    aWriter.Put<unsigned>( filledPolys.GetCornersCount() );
+
+    for( unsigned ii = 0; ii < filledPolys.GetCornersCount(); ++ii )
+    {
+        aWriter.PutPoint( filledPolys.GetPos( ii ) );
+        aWriter.Put<unsigned char>( filledPolys.IsEndContour( ii ) );
+    }
+
+    const std::vector<SEGMENT>& segments = aZone->FillSegments();
+
+    aWriter.Put<unsigned>( segments.size() );
+
+    for( unsigned ii = 0; ii < segments.size(); ++ii )
+    {
+        aWriter.PutPoint( segments[ii].m_Start );
+        aWriter.PutPoint( segments[ii].m_End );
+    }
+}
+
+
+static ZONE_CONTAINER* readZone( CACHE_READER& aReader, BOARD* aBoard )
+{
+    ZONE_CONTAINER* zone = new ZONE_CONTAINER( aBoard );
+
+    // The layer is used by AddPolygon()
+    zone->SetLayer( aReader.Get<int>() );
+    zone->SetNetCode( aReader.Get<int>() );
+    zone->SetTimeStamp( (time_t) aReader.Get<long long>() );
+    zone->SetPriority( aReader.Get<unsigned>() );
+    zone->SetPadConnection( (ZoneConnection) aReader.Get<int>() );
+    zone->SetZoneClearance( aReader.Get<int>() );
+    zone->SetMinThickness( aReader.Get<int>() );
+    zone->SetIsFilled( aReader.Get<unsigned char>() != 0 );
+    zone->SetFillMode( aReader.Get<int>() );
+    zone->SetArcSegmentCount( aReader.Get<int>() );
+    zone->SetThermalReliefGap( aReader.Get<int>() );
+    zone->SetThermalReliefCopperBridge( aReader.Get<int>() );
+    zone->SetCornerSmoothingType( aReader.Get<int>() );
+    zone->SetCornerRadius( aReader.Get<unsigned>() );
+    zone->SetFillFingerprint( aReader.Get<unsigned long long>() );
+    zone->SetIsKeepout( aReader.Get<unsigned char>() != 0 );
+    zone->SetDoNotAllowCopperPour( aReader.Get<unsigned char>() != 0 );
+    zone->SetDoNotAllowVias( aReader.Get<unsigned char>() != 0 );
+    zone->SetDoNotAllowTracks( aReader.Get<unsigned char>() != 0 );
+
+    int hatchStyle = aReader.Get<int>();
+    int hatchPitch = aReader.Get<int>();
+
+    // A corner is 2 ints and a flag
+    const size_t cornerSize = 2 * sizeof( int ) + 1;
+
+    std::vector<wxPoint> contour;
+    unsigned count = aReader.GetCount( cornerSize );
+
+    for( unsigned ii = 0; ii < count; ++ii )
+    {
+        contour.push_back( aReader.GetPoint() );
+
+        if( aReader.Get<unsigned char>() || ii == count - 1 )
+        {
+            zone->AddPolygon( contour );
+            contour.clear();
+        }
+    }
+
+    // As after parsing the board file
+    if( zone->GetNumCorners() > 2 )
+        zone->Outline()->SetHatch( hatchStyle, hatchPitch, true );
+
+    CPOLYGONS_LIST filledPolys;
+
+    count = aReader.GetCount( cornerSize );
+    filledPolys.reserve( count );
+
+    for( unsigned ii = 0; ii < count; ++ii )
+    {
+        wxPoint pos = aReader.GetPoint();
+        bool    endContour = aReader.Get<unsigned char>() != 0;
+
+        filledPolys.Append( CPolyPt( pos.x, pos.y, endContour ) );
+    }
+
+    if( filledPolys.GetCornersCount() )
+        zone->AddFilledPolysList( filledPolys );
+
+    std::vector<SEGMENT> segments;
+
+    count = aReader.GetCount( 4 * sizeof( int ) );
+    segments.reserve( count );
+
+    for( unsigned ii = 0; ii < count; ++ii )
+    {
+        wxPoint start = aReader.GetPoint();
+        segments.push_back( SEGMENT( start, aReader.GetPoint() ) );
+    }
+
+    if( !segments.empty() )
+        zone->AddFillSegments( segments );
+
+    return zone;
+}
+
+
+PCB_BINARY_CACHE::PCB_BINARY_CACHE( const wxString& aBoardFileName ) :
+    m_boardFileName( aBoardFileName ),
+    m_stampValid( false ),
+    m_fileSize( 0 ),
+    m_fileTime( 0 ),
+    m_fileHash( 0 )
+{
+}
+
+
+wxString PCB_BINARY_CACHE::GetCacheFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + wxT( "-cache" );
+}
+
+
+bool PCB_BINARY_CACHE::readBoardFileStamp()
+{
+    wxFileName  fn( m_boardFileName );
+    wxDateTime  modTime = fn.GetModificationTime();
+    wxULongLong size = fn.GetSize();
+
+    if( !modTime.IsValid() || size == wxInvalidSize )
+        return false;
+
+    FILE* fp = wxFopen( m_boardFileName, wxT( "rb" ) );
+
+    if( !fp )
+        return false;
+
+    // 64 bit FNV-1a, on words rather than bytes
+    const unsigned long long prime = 0x100000001b3ULL;
+    unsigned long long       hash  = 0xcbf29ce484222325ULL;
+
+    std::vector<char> block( HASH_BLOCK_SIZE );
+    size_t            length;
+
+    while( ( length = fread( &block[0], 1, block.size(), fp ) ) > 0 )
+    {
+        size_t ii = 0;
+
+        for( ; ii + sizeof( hash ) <= length; ii += sizeof( hash ) )
+        {
+            unsigned long long word;
+            memcpy( &word, &block[ii], sizeof( word ) );
+            hash = ( hash ^ word ) * prime;
+        }
+
+        for( ; ii < length; ++ii )
+            hash = ( hash ^ (unsigned char) block[ii] ) * prime;
+    }
+
+    bool ok = !ferror( fp );
+
+    fclose( fp );
+
+    m_fileSize   = size.GetValue();
+    m_fileTime   = modTime.GetTicks();
+    m_fileHash   = hash;
+    m_stampValid = ok;
+
+    return ok;
+}
+
+
+bool PCB_BINARY_CACHE::IsWorthCaching() const
+{
+    wxFileName fn( m_boardFileName );
+
+    wxULongLong size = fn.GetSize();
+
+    return size != wxInvalidSize && size.GetValue() >= CACHE_MIN_BOARD_FILE_SIZE;
+}
+
+
+bool PCB_BINARY_CACHE::Read()
+{
+    m_data.clear();
+
+    wxString cacheFileName = GetCacheFileName( m_boardFileName );
+
+    if( !wxFileExists( cacheFileName ) || !readBoardFileStamp() )
+        return false;
+
+    FILE* fp = wxFopen( cacheFileName, wxT( "rb" ) );
+
+    if( !fp )
+        return false;
+
+    CACHE_HEADER header;
+    bool         ok = fread( &header, sizeof( header ), 1, fp ) == 1;
+
+    ok = ok && memcmp( header.magic, CACHE_MAGIC, sizeof( header.magic ) ) == 0
+            && header.version   == CACHE_VERSION
+            && header.byteOrder == CACHE_BYTE_ORDER_MARK
+            && header.fileSize  == m_fileSize
+            && header.fileTime  == m_fileTime
+            && header.fileHash  == m_fileHash;
+
+    if( ok )
+    {
+        char   buffer[64 * 1024];
+        size_t length;
+
+        while( ( length = fread( buffer, 1, sizeof( buffer ), fp ) ) > 0 )
+            m_data.append( buffer, length );
+
+        ok = !ferror( fp );
+    }
+
+    fclose( fp );
+
+    if( !ok )
+        m_data.clear();
+
+    return ok;
+}
+
+
+bool PCB_BINARY_CACHE::AddItems( BOARD* aBoard ) const
+{
+    CACHE_READER    reader( m_data );
+
+    std::vector<TRACK*>             tracks;
+    std::vector<ZONE_CONTAINER*>    zones;
+
+    unsigned count = reader.GetCount( 1 );
+
+    for( unsigned ii = 0; ii < count && reader.IsOk(); ++ii )
+        tracks.push_back( readTrack( reader, aBoard ) );
+
+    count = reader.GetCount( 1 );
+
+    for( unsigned ii = 0; ii < count && reader.IsOk(); ++ii )
+        zones.push_back( readZone( reader, aBoard ) );
+
+    if( !reader.IsOk() || !reader.AtEnd() )
+    {
+        for( unsigned ii = 0; ii < tracks.size(); ++ii )
+            delete tracks[ii];
+
+        for( unsigned ii = 0; ii < zones.size(); ++ii )
+            delete zones[ii];
+
+        return false;
+    }
+
+    // BOARD::Add() inserts a track before the first track of the same or a higher net.
+    // Adding the tracks of the saved list from the last one gives back the same list,
+    // each insertion being at the start of the list.
+    for( int ii = tracks.size() - 1; ii >= 0; --ii )
+        aBoard->Add( tracks[ii], ADD_APPEND );
+
+    for( unsigned ii = 0; ii < zones.size(); ++ii )
+        aBoard->Add( zones[ii], ADD_APPEND );
+
+    return true;
+}
+
+
+bool PCB_BINARY_CACHE::Write( const BOARD* aBoard )
+{
+    if( !m_stampValid && !readBoardFileStamp() )
+        return false;
+
+    CACHE_HEADER header;
+
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, CACHE_MAGIC, sizeof( header.magic ) );
+    header.version   = CACHE_VERSION;
+    header.byteOrder = CACHE_BYTE_ORDER_MARK;
+    header.fileSize  = m_fileSize;
+    header.fileTime  = m_fileTime;
+    header.fileHash  = m_fileHash;
+
+    std::string  data( (const char*) &header, sizeof( header ) );
+    CACHE_WRITER writer( data );
+
+    writer.Put<unsigned>( aBoard->m_Track.GetCount() );
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+        writeTrack( writer, track );
+
+    writer.Put<unsigned>( aBoard->GetAreaCount() );
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ++ii )
+        writeZone( writer, aBoard->GetArea( ii ) );
+
+    // Written in a temporary file, so a partial cache is never used
+    wxString cacheFileName = GetCacheFileName( m_boardFileName );
+    wxString tempFileName  = cacheFileName + wxT( ".tmp" );
+
+    FILE* fp = wxFopen( tempFileName, wxT( "wb" ) );
+
+    if( !fp )
+        return false;
+
+    bool ok = fwrite( data.data(), 1, data.size(), fp ) == data.size();
+
+    ok = ( fclose( fp ) == 0 ) && ok;
+
+    if( ok )
+        ok = wxRenameFile( tempFileName, cacheFileName, true );
+
+    if( !ok )
+        wxRemoveFile( tempFileName );
+
+    return ok;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file pcb_binary_cache.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PCB_BINARY_CACHE_H
+#define PCB_BINARY_CACHE_H
+
+#include <string>
+
+#include <wx/string.h>
+
+class BOARD;
+
+
+/**
+ * Class PCB_BINARY_CACHE
+ * handles the binary sidecar file of a board file, "<board>.kicad_pcb-cache", which
+ * holds the tracks, vias and zones (with their filled areas) of the board.  They are
+ * most of the text of a large board, and the slowest part to parse.
+ *
+ * The board file stays the reference: the cache is used only if it was written for a
+ * board file of the same size, modification time and content hash.  The layout is
+ * the memory layout of the machine which wrote it; it starts with a version number
+ * and a byte order mark, and a cache written by another version or on another kind
+ * of machine is ignored.
+ */
+class PCB_BINARY_CACHE
+{
+public:
+    /**
+     * Constructor PCB_BINARY_CACHE
+     * @param aBoardFileName is the full path of the board file.
+     */
+    PCB_BINARY_CACHE( const wxString& aBoardFileName );
+
+    /**
+     * Function GetCacheFileName
+     * @return the name of the cache file of board file @a aBoardFileName.
+     */
+    static wxString GetCacheFileName( const wxString& aBoardFileName );
+
+    /**
+     * Function IsWorthCaching
+     * @return true if the board file is large enough for a cache to save time.
+     */
+    bool IsWorthCaching() const;
+
+    /**
+     * Function Read
+     * reads the cache file, and checks it matches the current board file.
+     * @return true if the cache can be used to load the board.
+     */
+    bool Read();
+
+    /**
+     * Function AddItems
+     * creates the tracks, vias and zones read by Read() and adds them to @a aBoard,
+     * which must hold the nets of the board file.  The board lists get the order they
+     * would have after parsing the board file.
+     * @return false if the cache content is not valid: nothing is added then.
+     */
+    bool AddItems( BOARD* aBoard ) const;
+
+    /**
+     * Function Write
+     * writes the cache of @a aBoard, which was just loaded from the board file.
+     * Errors are not reported: there is no cache then.
+     * @return true if the cache file was written.
+     */
+    bool Write( const BOARD* aBoard );
+
+private:
+    /**
+     * Function readBoardFileStamp
+     * reads the size and modification time of the board file and computes the hash
+     * of its content.
+     */
+    bool readBoardFileStamp();
+
+    wxString            m_boardFileName;
+    bool                m_stampValid;           ///< true when the 3 values below are read
+    unsigned long long  m_fileSize;
+    long long           m_fileTime;
+    unsigned long long  m_fileHash;
+
+    std::string         m_data;                 ///< cache content, after the header
+};
+
+
+#endif  // PCB_BINARY_CACHE_H
@@ -50,6 +50,28 @@ PCB_RENDER_SETTINGS::PCB_RENDER_SETTINGS()
         m_sketchModeSelect[i] = false;
     }
 
+    // Texts cannot be read below a few pixels, and holes or silkscreen
+    // smaller than a pixel are not seen at all
+    for( unsigned int i = 0; i < TOTAL_LAYER_COUNT; ++i )
+    {
+        m_minimumSize[i] = 0.0;
+    }
+
+    for( LAYER_NUM layer = FIRST_COPPER_LAYER; layer <= LAST_COPPER_LAYER; ++layer )
+        m_minimumSize[GetNetnameLayer( layer )] = 3.0;
+
+    m_minimumSize[NETNAMES_GAL_LAYER( PADS_NETNAMES_VISIBLE )]      = 3.0;
+    m_minimumSize[NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE )]    = 3.0;
+    m_minimumSize[NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE )]    = 3.0;
+    m_minimumSize[ITEM_GAL_LAYER( MOD_TEXT_FR_VISIBLE )]            = 3.0;
+    m_minimumSize[ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE )]            = 3.0;
+    m_minimumSize[ITEM_GAL_LAYER( MOD_REFERENCES_VISIBLE )]         = 3.0;
+    m_minimumSize[ITEM_GAL_LAYER( MOD_VALUES_VISIBLE )]             = 3.0;
+    m_minimumSize[ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE )]             = 1.0;
+    m_minimumSize[ITEM_GAL_LAYER( PADS_HOLES_VISIBLE )]             = 1.0;
+    m_minimumSize[SILKSCREEN_N_FRONT]                               = 1.0;
+    m_minimumSize[SILKSCREEN_N_BACK]                                = 1.0;
+
     update();
 }
 
@@ -203,6 +225,16 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    // Settings are shared, only the GAL differs
+    PCB_PAINTER* painter = new PCB_PAINTER( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
 bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 {
     // the "cast" applied in here clarifies which overloaded draw() is called
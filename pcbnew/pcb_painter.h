@@ -98,6 +98,28 @@ public:
      */
     const COLOR4D& GetLayerColor( int aLayer ) const;
 
+    /**
+     * Function GetMinimumSize
+     * Returns the size below which the items of a layer are not drawn (level of details).
+     * @param aLayer is the layer number.
+     * @return the size on the screen, in pixels.
+     */
+    double GetMinimumSize( int aLayer ) const
+    {
+        return m_minimumSize[aLayer];
+    }
+
+    /**
+     * Function SetMinimumSize
+     * Sets the size below which the items of a layer are not drawn (level of details).
+     * @param aLayer is the layer number.
+     * @param aPixels is the size on the screen, 0 to always draw the items.
+     */
+    void SetMinimumSize( int aLayer, double aPixels )
+    {
+        m_minimumSize[aLayer] = aPixels;
+    }
+
 protected:
     ///> @copydoc RENDER_SETTINGS::Update()
     void update();
@@ -117,6 +139,9 @@ protected:
     ///> Flag determining if items on a given layer should be drawn as an outline or a full item
     bool    m_sketchModeSelect[TOTAL_LAYER_COUNT];
 
+    ///> Sizes on the screen (in pixels) below which the items of a layer are not drawn
+    double  m_minimumSize[TOTAL_LAYER_COUNT];
+
     ///> Flag determining if pad numbers should be visible
     bool    m_padNumbers;
 
@@ -146,6 +171,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM*, int );
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const;
+
     /// @copydoc PAINTER::ApplySettings()
     virtual void ApplySettings( RENDER_SETTINGS* aSettings )
     {
@@ -28,6 +28,7 @@
  */
 
 #include <errno.h>
+#include <ctype.h>
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
@@ -52,6 +53,102 @@
 #include <pcb_parser.h>
 
 
+/// The size of the text of the sections parsed together by a worker thread
+#define SECTION_CHUNK_SIZE      ( 64 * 1024 )
+
+
+/**
+ * Struct SECTION_CHUNK
+ * holds the text of consecutive top level sections, the lines between them kept
+ * empty and the text before them on their first line replaced by blanks.  Line
+ * numbers and byte offsets are the same as in the file.
+ */
+struct PCB_PARSER::SECTION_CHUNK
+{
+    std::string     text;
+    int             firstLine;      ///< line number of the first line of text
+    int             line;           ///< line number of the end of text
+    int             column;         ///< byte offset of the end of text in its line
+    unsigned        count;          ///< number of sections in text
+
+    std::vector<BOARD_ITEM*>    items;      ///< the parsed items, in file order
+    wxArrayString               messages;
+    PARSE_ERROR*                parseError;
+    IO_ERROR*                   ioError;
+
+    SECTION_CHUNK() :
+        firstLine( 0 ),
+        line( 0 ),
+        column( 0 ),
+        count( 0 ),
+        parseError( NULL ),
+        ioError( NULL )
+    {
+    }
+
+    ~SECTION_CHUNK()
+    {
+        for( unsigned ii = 0; ii < items.size(); ++ii )
+            delete items[ii];
+
+        delete parseError;
+        delete ioError;
+    }
+
+    /**
+     * Function Append
+     * adds the text [@a aText, @a aEnd) read at @a aColumn of line @a aLine.
+     */
+    void Append( int aLine, int aColumn, const char* aText, const char* aEnd )
+    {
+        if( text.empty() )
+        {
+            firstLine = line = aLine;
+            column = 0;
+        }
+
+        if( aLine > line )
+        {
+            text.append( aLine - line, '\n' );
+            line = aLine;
+            column = 0;
+        }
+
+        if( aColumn > column )
+            text.append( aColumn - column, ' ' );
+
+        text.append( aText, aEnd );
+        column = aColumn + ( aEnd - aText );
+
+        for( const char* cp = aText; cp < aEnd; ++cp )
+        {
+            if( *cp == '\n' )
+            {
+                ++line;
+                column = aEnd - cp - 1;
+            }
+        }
+    }
+};
+
+
+/**
+ * Class SECTION_LINE_READER
+ * reads the text of a SECTION_CHUNK, which it takes, numbering the lines from the
+ * first line of the chunk.
+ */
+class SECTION_LINE_READER : public STRING_LINE_READER
+{
+public:
+    SECTION_LINE_READER( std::string& aText, const wxString& aSource, int aFirstLine ) :
+        STRING_LINE_READER( std::string(), aSource )
+    {
+        lines.swap( aText );
+        lineNum = aFirstLine - 1;
+    }
+};
+
+
 void PCB_PARSER::init()
 {
     m_layerIndices.clear();
@@ -79,11 +176,18 @@ void PCB_PARSER::init()
 
 double PCB_PARSER::parseDouble() throw( IO_ERROR )
 {
+    const std::string& text = CurStr();
+    double fval;
+
+    // Fast and locale independent path for the numbers KiCad writes
+    if( ParseDecimalDouble( text.data(), text.data() + text.size(), &fval ) )
+        return fval;
+
     char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = strtod( CurText(), &tmp );
 
     if( errno )
     {
@@ -107,6 +211,24 @@ double PCB_PARSER::parseDouble() throw( IO_ERROR )
 }
 
 
+int PCB_PARSER::parseBoardUnits() throw( IO_ERROR )
+{
+    const std::string& text = CurStr();
+    int value;
+
+    // The formatter writes mm with up to 6 decimals, so board units in nm are read
+    // back exactly from the digits
+    if( IU_PER_MM == 1e6
+      && ParseMillimetresToNanometres( text.data(), text.data() + text.size(), &value ) )
+        return value;
+
+    // Other formats (exponents, out of range values) go through the double.
+    // Use here KiROUND, not KIROUND (see comments about them) when having a
+    // function as argument, because it will be called twice with KIROUND
+    return KiROUND( parseDouble() * IU_PER_MM );
+}
+
+
 bool PCB_PARSER::parseBool() throw( PARSE_ERROR )
 {
     T token = NextTok();
@@ -366,7 +488,8 @@ BOARD_ITEM* PCB_PARSER::Parse() throw( IO_ERROR, PARSE_ERROR )
 
 BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
+    T               token;
+    SECTION_CHUNKS  chunks;
 
     parseHeader();
 
@@ -375,6 +498,9 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
         if( token != T_LEFT )
             Expecting( T_LEFT );
 
+        int leftLine   = CurLineNumber();
+        int leftOffset = curOffset;
+
         token = NextTok();
 
         switch( token )
@@ -423,20 +549,22 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
             m_board->Add( parseDIMENSION(), ADD_APPEND );
             break;
 
-        case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
-
         case T_segment:
-            m_board->Add( parseTRACK(), ADD_APPEND );
-            break;
-
         case T_via:
-            m_board->Add( parseSEGVIA(), ADD_APPEND );
-            break;
-
         case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
+            if( m_skipTracksAndZones )
+            {
+                captureSection( NULL, leftLine, leftOffset );
+                break;
+            }
+
+            // Fall through
+        case T_module:
+            // Most of the file: parsed later in worker threads
+            if( chunks.empty() || chunks.back().text.size() >= SECTION_CHUNK_SIZE )
+                chunks.push_back( new SECTION_CHUNK() );
+
+            captureSection( &chunks.back(), leftLine, leftOffset );
             break;
 
         case T_target:
@@ -450,10 +578,183 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
         }
     }
 
+    // The deferred items go in other lists than the items added above, so adding them
+    // now keeps the order of every board list.
+    parseSectionChunks( chunks );
+
     return m_board;
 }
 
 
+void PCB_PARSER::captureSection( SECTION_CHUNK* aChunk, int aLeftLine, int aLeftOffset )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    int         firstLine = CurLineNumber();
+    int         firstOffset = curOffset;
+
+    const char* left = "(";
+
+    if( aChunk )
+    {
+        aChunk->Append( aLeftLine, aLeftOffset, left, left + 1 );
+        aChunk->Append( firstLine, curOffset, CurText(), CurText() + CurStr().size() );
+    }
+
+    const char* cur = next;
+    int         depth = 1;
+
+    for(;;)
+    {
+        const char* head = cur;
+        bool        atSeparator = true;
+
+        while( cur < limit )
+        {
+            char cc = *cur++;
+
+            if( cc == '"' && atSeparator )
+            {
+                // Parentheses are not counted in quoted strings, which end on their line
+                while( cur < limit && *cur != '"' )
+                {
+                    if( *cur == '\\' && cur + 1 < limit )
+                        ++cur;
+
+                    ++cur;
+                }
+
+                if( cur < limit )
+                    ++cur;
+
+                atSeparator = false;
+                continue;
+            }
+
+            if( cc == ')' && --depth == 0 )
+                break;
+
+            if( cc == '(' )
+                ++depth;
+
+            atSeparator = isspace( (unsigned char) cc ) || cc == '(' || cc == ')';
+        }
+
+        if( aChunk )
+            aChunk->Append( CurLineNumber(), head - start, head, cur );
+
+        if( depth == 0 )
+            break;
+
+        if( readLine() == 0 )
+        {
+            THROW_PARSE_ERROR( _( "missing ')' at the end of the section" ), CurSource(),
+                               CurLine(), firstLine, firstOffset + 1 );
+        }
+
+        cur = start;
+
+        // The lexer skips comment lines, do the same
+        const char* cp = start;
+
+        while( cp < limit && isspace( (unsigned char) *cp ) )
+            ++cp;
+
+        if( cp < limit && *cp == '#' )
+            cur = limit;
+    }
+
+    if( aChunk )
+        aChunk->count++;
+
+    next = cur;
+}
+
+
+void PCB_PARSER::parseSectionChunk( SECTION_CHUNK& aChunk, const wxString& aSource ) const
+{
+    SECTION_LINE_READER reader( aChunk.text, aSource, aChunk.firstLine );
+    PCB_PARSER          parser( &reader );
+
+    parser.m_board        = m_board;
+    parser.m_layerIndices = m_layerIndices;
+    parser.m_layerMasks   = m_layerMasks;
+
+    try
+    {
+        for( unsigned ii = 0; ii < aChunk.count; ++ii )
+        {
+            if( parser.NextTok() != T_LEFT )
+                parser.Expecting( T_LEFT );
+
+            switch( parser.NextTok() )
+            {
+            case T_module:
+                aChunk.items.push_back( parser.parseMODULE() );
+                break;
+
+            case T_segment:
+                aChunk.items.push_back( parser.parseTRACK() );
+                break;
+
+            case T_via:
+                aChunk.items.push_back( parser.parseSEGVIA() );
+                break;
+
+            case T_zone:
+                aChunk.items.push_back( parser.parseZONE_CONTAINER() );
+                break;
+
+            default:
+                parser.Expecting( "module, segment, via or zone" );
+            }
+        }
+    }
+    catch( const PARSE_ERROR& pe )
+    {
+        aChunk.parseError = new PARSE_ERROR( pe );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aChunk.ioError = new IO_ERROR( ioe );
+    }
+
+    aChunk.messages = parser.m_messages;
+}
+
+
+void PCB_PARSER::parseSectionChunks( SECTION_CHUNKS& aChunks ) throw( IO_ERROR, PARSE_ERROR )
+{
+    const wxString& source = CurSource();
+    int             count = aChunks.size();
+
+    // The items are created for m_board, which is only read until they are added
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int ii = 0; ii < count; ++ii )
+        parseSectionChunk( aChunks[ii], source );
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        SECTION_CHUNK& chunk = aChunks[ii];
+
+        for( unsigned jj = 0; jj < chunk.items.size(); ++jj )
+            m_board->Add( chunk.items[jj], ADD_APPEND );
+
+        chunk.items.clear();
+
+        for( unsigned jj = 0; jj < chunk.messages.GetCount(); ++jj )
+            DisplayError( NULL, chunk.messages[jj] );
+
+        if( chunk.parseError )
+            throw *chunk.parseError;
+
+        if( chunk.ioError )
+            throw *chunk.ioError;
+    }
+}
+
+
 void PCB_PARSER::parseHeader() throw( IO_ERROR, PARSE_ERROR )
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -2429,7 +2730,7 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
                 wxString msg;
                 msg.Printf( _( "There is a zone that belongs to a not existing net"
                                "(%s), you should verify it." ), GetChars( FromUTF8() ) );
-                DisplayError( NULL, msg );
+                m_messages.Add( msg );      // shown from the main thread
                 zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
             }
             NeedRIGHT();
@@ -2569,9 +2870,27 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
                     NeedRIGHT();
                     break;
 
+                case T_fingerprint:
+                    {
+                        // 64 bits hexadecimal value, too big for parseHex()
+                        unsigned long long fingerprint = 0;
+
+                        NextTok();
+
+                        for( const char* cp = CurText();  isxdigit( *cp );  ++cp )
+                        {
+                            int digit = isdigit( *cp ) ? *cp - '0' : tolower( *cp ) - 'a' + 10;
+                            fingerprint = ( fingerprint << 4 ) | digit;
+                        }
+
+                        zone->SetFillFingerprint( fingerprint );
+                        NeedRIGHT();
+                    }
+                    break;
+
                 default:
                     Expecting( "mode, arc_segments, thermal_gap, thermal_bridge_width, "
-                               "smoothing, or radius" );
+                               "smoothing, radius, or fingerprint" );
                 }
             }
             break;
@@ -33,6 +33,9 @@
 #include <hashtables.h>
 #include <layers_id_colors_and_visibility.h>    // LAYER_NUM
 #include <common.h>                             // KiROUND
+#include <decimal_parser.h>
+
+#include <boost/ptr_container/ptr_vector.hpp>
 
 using namespace PCB_KEYS_T;
 
@@ -67,6 +70,13 @@ class PCB_PARSER : public PCB_LEXER
     BOARD*          m_board;
     LAYER_NUM_MAP   m_layerIndices;     ///< map layer name to it's index
     LAYER_MSK_MAP   m_layerMasks;       ///< map layer names to their masks
+    wxArrayString   m_messages;         ///< warnings to show once the board is loaded
+    bool            m_skipTracksAndZones;   ///< they are read from the board cache
+
+    /// The text of consecutive module, segment, via and zone sections, parsed in a
+    /// worker thread once the rest of the board is read.  Defined in pcb_parser.cpp.
+    struct SECTION_CHUNK;
+    typedef boost::ptr_vector< SECTION_CHUNK > SECTION_CHUNKS;
 
 
     /**
@@ -106,6 +116,37 @@ class PCB_PARSER : public PCB_LEXER
     PCB_TARGET*     parsePCB_TARGET() throw( IO_ERROR, PARSE_ERROR );
     BOARD*          parseBOARD() throw( IO_ERROR, PARSE_ERROR );
 
+    /**
+     * Function captureSection
+     * copies the text of the section whose keyword is the current token, up to its
+     * closing parenthesis, at the end of @a aChunk and moves the lexer after it.
+     * The text keeps its line numbers and byte offsets, so errors found when it is
+     * parsed are reported at their place in the file.
+     *
+     * @param aChunk is the chunk to append the section to, or NULL to skip the section.
+     * @param aLeftLine is the line number of the opening parenthesis of the section.
+     * @param aLeftOffset is the zero based byte offset of this parenthesis in its line.
+     */
+    void captureSection( SECTION_CHUNK* aChunk, int aLeftLine, int aLeftOffset )
+        throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function parseSectionChunk
+     * parses the sections of @a aChunk with a new parser sharing the board and the
+     * layer maps of this one.  It is called from worker threads, so errors are kept
+     * in @a aChunk instead of being thrown.
+     */
+    void parseSectionChunk( SECTION_CHUNK& aChunk, const wxString& aSource ) const;
+
+    /**
+     * Function parseSectionChunks
+     * parses @a aChunks concurrently, then adds the items to the board in file order.
+     *
+     * @throw IO_ERROR or PARSE_ERROR, the first error found in file order, after the
+     *  items read before it are added to the board.
+     */
+    void parseSectionChunks( SECTION_CHUNKS& aChunks ) throw( IO_ERROR, PARSE_ERROR );
+
 
     /**
      * Function lookUpLayer
@@ -169,7 +210,9 @@ class PCB_PARSER : public PCB_LEXER
     /**
      * Function parseDouble
      * parses the current token as an ASCII numeric string with possible leading
-     * whitespace into a double precision floating point number.
+     * whitespace into a double precision floating point number.  The plain decimal
+     * numbers written by KiCad are converted without strtod(), independently of
+     * the locale.
      *
      * @throw IO_ERROR if an error occurs attempting to convert the current token.
      * @return The result of the parsed token.
@@ -187,23 +230,21 @@ class PCB_PARSER : public PCB_LEXER
         return parseDouble( GetTokenText( aToken ) );
     }
 
-    inline int parseBoardUnits() throw( IO_ERROR )
-    {
-        // There should be no major rounding issues here, since the values in
-        // the file are in mm and get converted to nano-meters.
-        // See test program tools/test-nm-biu-to-ascii-mm-round-tripping.cpp
-        // to confirm or experiment.  Use a similar strategy in both places, here
-        // and in the test program. Make that program with:
-        // $ make test-nm-biu-to-ascii-mm-round-tripping
-        return KiROUND( parseDouble() * IU_PER_MM );
-    }
+    /**
+     * Function parseBoardUnits
+     * parses the current token, a number of mm, into board units.
+     * The fixed point values written by PCB_IO are converted on their decimal digits,
+     * which gives back exactly the value that was written.
+     * See test program tools/test-nm-biu-to-ascii-mm-round-tripping.cpp
+     * to confirm or experiment.  Make that program with:
+     * $ make test-nm-biu-to-ascii-mm-round-tripping
+     */
+    int parseBoardUnits() throw( IO_ERROR );
 
     inline int parseBoardUnits( const char* aExpected ) throw( PARSE_ERROR )
     {
-        // Use here KiROUND, not KIROUND (see comments about them)
-        // when having a function as argument, because it will be called twice
-        // with KIROUND
-        return KiROUND( parseDouble( aExpected ) * IU_PER_MM );
+        NeedNUMBER( aExpected );
+        return parseBoardUnits();
     }
 
     inline int parseBoardUnits( T aToken ) throw( PARSE_ERROR )
@@ -213,6 +254,12 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseInt() throw( PARSE_ERROR )
     {
+        const std::string& text = CurStr();
+        int value;
+
+        if( ParseDecimalInt( text.data(), text.data() + text.size(), &value ) )
+            return value;
+
         return (int)strtol( CurText(), NULL, 10 );
     }
 
@@ -235,7 +282,8 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_skipTracksAndZones( false )
     {
         init();
     }
@@ -261,6 +309,16 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetSkipTracksAndZones
+     * tells the parser to skip the segment, via and zone sections of the boards it
+     * parses, when they are read from a PCB_BINARY_CACHE instead.
+     */
+    void SetSkipTracksAndZones( bool aSkip )
+    {
+        m_skipTracksAndZones = aSkip;
+    }
+
     BOARD_ITEM* Parse() throw( IO_ERROR, PARSE_ERROR );
 };
 
@@ -515,55 +515,10 @@ void PCB_EDIT_FRAME::ViewReloadBoard( const BOARD* aBoard ) const
     view->Clear();
 
     // All of PCB drawing elements should be added to the VIEW
-    // in order to be displayed
-
-    // Load zones
-    for( int i = 0; i < aBoard->GetAreaCount(); ++i )
-    {
-        view->Add( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
-    }
-
-    // Load drawings
-    for( BOARD_ITEM* drawing = aBoard->m_Drawings; drawing; drawing = drawing->Next() )
-    {
-        view->Add( drawing );
-    }
-
-    // Load tracks
-    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
-    {
-        view->Add( track );
-    }
-
-    // Load modules and its additional elements
-    for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
-    {
-        // Load module's pads
-        for( D_PAD* pad = module->Pads().GetFirst(); pad; pad = pad->Next() )
-        {
-            view->Add( pad );
-        }
-
-        // Load module's drawing (mostly silkscreen)
-        for( BOARD_ITEM* drawing = module->GraphicalItems().GetFirst(); drawing;
-             drawing = drawing->Next() )
-        {
-            view->Add( drawing );
-        }
-
-        // Load module's texts (name and value)
-        view->Add( &module->Reference() );
-        view->Add( &module->Value() );
-
-        // Add the module itself
-        view->Add( module );
-    }
-
-    // Segzones (equivalent of ZONE_CONTAINER for legacy boards)
-    for( SEGZONE* zone = aBoard->m_Zone; zone; zone = zone->Next() )
-    {
-        view->Add( zone );
-    }
+    // in order to be displayed.  They are added at once, so the view can bulk load
+    // its R-trees instead of inserting the items one by one
+    std::vector<KIGFX::VIEW_ITEM*> items;
+    aBoard->GetViewItems( items );
 
     KIGFX::WORKSHEET_VIEWITEM* worksheet = aBoard->GetWorksheetViewItem();
     worksheet->SetSheetName( std::string( GetScreenDesc().mb_str() ) );
@@ -576,8 +531,10 @@ void PCB_EDIT_FRAME::ViewReloadBoard( const BOARD* aBoard ) const
         worksheet->SetSheetCount( screen->m_NumberOfScreens );
     }
 
-    view->Add( worksheet );
-    view->Add( aBoard->GetRatsnestViewItem() );
+    items.push_back( worksheet );
+    items.push_back( aBoard->GetRatsnestViewItem() );
+
+    view->Add( items );
 
     // Limit panning to the size of worksheet frame
     view->SetPanBoundary( aBoard->GetWorksheetViewItem()->ViewBBox() );
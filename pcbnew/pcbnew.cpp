@@ -60,6 +60,7 @@
 #include <fp_lib_table.h>
 #include <module_editor_frame.h>
 #include <modview_frame.h>
+#include <zone_fill_engine.h>
 
 
 // Colors for layers and items
@@ -79,6 +80,7 @@ LAYER_NUM   g_Route_Layer_BOTTOM;
 int         g_MaxLinksShowed;
 int         g_MagneticPadOption   = capture_cursor_in_track_tool;
 int         g_MagneticTrackOption = capture_cursor_in_track_tool;
+int         g_ZoneFillEngine = ZONE_FILL_ENGINE_BOOST;
 
 wxPoint     g_Offset_Module;     /* Distance to offset module trace when moving. */
 
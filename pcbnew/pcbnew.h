@@ -67,6 +67,8 @@ extern bool        g_TwoSegmentTrackBuild;
 extern int         g_MagneticPadOption;
 extern int         g_MagneticTrackOption;
 
+extern int         g_ZoneFillEngine;        // a ZONE_FILL_ENGINE value
+
 extern wxPoint     g_Offset_Module;         /* Offset trace when moving footprint. */
 
 enum MagneticPadOptionValues {
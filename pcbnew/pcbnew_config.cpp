@@ -54,6 +54,7 @@
 #include <pcbnew_config.h>
 #include <module_editor_frame.h>
 #include <modview_frame.h>
+#include <zone_fill_engine.h>
 
 #include <invoke_pcb_dialog.h>
 #include <dialog_mask_clearance.h>
@@ -470,6 +471,10 @@ PARAM_CFG_ARRAY& PCB_EDIT_FRAME::GetConfigurationSettings()
                                                     &g_TwoSegmentTrackBuild, true ) );
     m_configSettings.push_back( new PARAM_CFG_BOOL( true, wxT( "SegmPcb45Only" )
                                                     , &g_Segments_45_Only, true ) );
+    m_configSettings.push_back( new PARAM_CFG_INT( true, wxT( "ZoneFillEngine" ),
+                                                   &g_ZoneFillEngine, ZONE_FILL_ENGINE_BOOST,
+                                                   ZONE_FILL_ENGINE_BOOST,
+                                                   ZONE_FILL_ENGINE_COUNT - 1 ) );
     return m_configSettings;
 }
 
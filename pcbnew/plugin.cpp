@@ -22,7 +22,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <memory>
+
 #include <io_mgr.h>
+#include <class_module.h>
+#include <class_pad.h>
 
 #define FMT_UNIMPLEMENTED   _( "Plugin '%s' does not implement the '%s' function." )
 
@@ -73,6 +77,38 @@ MODULE* PLUGIN::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 }
 
 
+void FOOTPRINT_HEADER::SetFrom( const MODULE* aModule )
+{
+    m_name        = aModule->GetFPID().GetFootprintName();
+    m_description = aModule->GetDescription();
+    m_keywords    = aModule->GetKeywords();
+    m_padCount    = aModule->GetPadCount( MODULE::DO_NOT_INCLUDE_NPTH );
+    m_boundingBox = aModule->GetFootprintRect();
+    m_layers      = GetLayerMask( aModule->GetLayer() );
+
+    for( const D_PAD* pad = aModule->Pads();  pad;  pad = pad->Next() )
+        m_layers |= pad->GetLayerMask();
+
+    for( const BOARD_ITEM* item = aModule->GraphicalItems();  item;  item = item->Next() )
+        m_layers |= GetLayerMask( item->GetLayer() );
+}
+
+
+bool PLUGIN::FootprintLoadHeader( const wxString& aLibraryPath, const wxString& aFootprintName,
+                                  FOOTPRINT_HEADER* aHeader, const PROPERTIES* aProperties )
+{
+    // Plugins without an index of their libraries get the header from the whole footprint.
+    std::auto_ptr<MODULE> module( FootprintLoad( aLibraryPath, aFootprintName, aProperties ) );
+
+    if( !module.get() )
+        return false;
+
+    aHeader->SetFrom( module.get() );
+
+    return true;
+}
+
+
 void PLUGIN::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootprint, const PROPERTIES* aProperties )
 {
     // not pure virtual so that plugins only have to implement subset of the PLUGIN interface.
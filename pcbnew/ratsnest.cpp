@@ -16,6 +16,7 @@
 #include <class_track.h>
 
 #include <pcbnew.h>
+#include <connect.h>
 
 #include <minimun_spanning_tree.h>
 
@@ -200,29 +201,29 @@ static bool sortByNetcode( const D_PAD* const & ref, const D_PAD* const & item )
  *      nb_links = link count for the board (logical connection count)
  *      (there are n-1 links in a net which counting n active pads) .
  */
-void PCB_BASE_FRAME::Build_Board_Ratsnest()
+void Build_Board_Ratsnest( BOARD* aPcb )
 {
     D_PAD* pad;
     int    noconn;
 
-    m_Pcb->SetUnconnectedNetCount( 0 );
+    aPcb->SetUnconnectedNetCount( 0 );
 
-    m_Pcb->m_FullRatsnest.clear();
+    aPcb->m_FullRatsnest.clear();
 
-    if( m_Pcb->GetPadCount() == 0 )
+    if( aPcb->GetPadCount() == 0 )
         return;
 
     // Created pad list and the net_codes if needed
-    if( (m_Pcb->m_Status_Pcb & NET_CODES_OK) == 0 )
-        m_Pcb->BuildListOfNets();
+    if( (aPcb->m_Status_Pcb & NET_CODES_OK) == 0 )
+        aPcb->BuildListOfNets();
 
-    for( unsigned ii = 0; ii<m_Pcb->GetPadCount(); ++ii )
+    for( unsigned ii = 0; ii<aPcb->GetPadCount(); ++ii )
     {
-        pad = m_Pcb->GetPad( ii );
+        pad = aPcb->GetPad( ii );
         pad->SetSubRatsnest( 0 );
     }
 
-    if( m_Pcb->GetNodesCount() == 0 )
+    if( aPcb->GetNodesCount() == 0 )
         return;                       // No useful connections.
 
     // Ratsnest computation
@@ -230,9 +231,9 @@ void PCB_BASE_FRAME::Build_Board_Ratsnest()
                                         // (net_code = 0 -> no connect)
     noconn = 0;
     MIN_SPAN_TREE_PADS min_spanning_tree;
-    for( ; current_net_code < m_Pcb->GetNetCount(); current_net_code++ )
+    for( ; current_net_code < aPcb->GetNetCount(); current_net_code++ )
     {
-        NETINFO_ITEM* net = m_Pcb->FindNet( current_net_code );
+        NETINFO_ITEM* net = aPcb->FindNet( current_net_code );
 
         if( net == NULL )       //Should not occur
         {
@@ -240,26 +241,32 @@ void PCB_BASE_FRAME::Build_Board_Ratsnest()
             return;
         }
 
-        net->m_RatsnestStartIdx = m_Pcb->GetRatsnestsCount();
+        net->m_RatsnestStartIdx = aPcb->GetRatsnestsCount();
 
         min_spanning_tree.MSP_Init( &net->m_PadInNetList );
         min_spanning_tree.BuildTree();
-        min_spanning_tree.AddTreeToRatsnest( m_Pcb->m_FullRatsnest );
-        net->m_RatsnestEndIdx = m_Pcb->GetRatsnestsCount();
+        min_spanning_tree.AddTreeToRatsnest( aPcb->m_FullRatsnest );
+        net->m_RatsnestEndIdx = aPcb->GetRatsnestsCount();
     }
 
-    m_Pcb->SetUnconnectedNetCount( noconn );
-    m_Pcb->m_Status_Pcb |= LISTE_RATSNEST_ITEM_OK;
+    aPcb->SetUnconnectedNetCount( noconn );
+    aPcb->m_Status_Pcb |= LISTE_RATSNEST_ITEM_OK;
 
     // Update the ratsnest display option (visible/invisible) flag
-    for( unsigned ii = 0; ii < m_Pcb->GetRatsnestsCount(); ii++ )
+    for( unsigned ii = 0; ii < aPcb->GetRatsnestsCount(); ii++ )
     {
-        if( !GetBoard()->IsElementVisible(RATSNEST_VISIBLE) )  // Clear VISIBLE flag
-            m_Pcb->m_FullRatsnest[ii].m_Status &= ~CH_VISIBLE;
+        if( !aPcb->IsElementVisible(RATSNEST_VISIBLE) )  // Clear VISIBLE flag
+            aPcb->m_FullRatsnest[ii].m_Status &= ~CH_VISIBLE;
     }
 }
 
 
+void PCB_BASE_FRAME::Build_Board_Ratsnest()
+{
+    ::Build_Board_Ratsnest( m_Pcb );
+}
+
+
 /**
  *  function DrawGeneralRatsnest
  *  Only ratsnest items with the status bit CH_VISIBLE set are displayed
@@ -436,21 +443,21 @@ static void tst_links_between_pads( int &      aCurrSubRatsnestId,
  * This is usually fast because the ratsnest is not built here: it is just explored
  * to see what link must be activated
  */
-void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
+void TestForActiveLinksInRatsnest( BOARD* aPcb, int aNetCode )
 {
     RATSNEST_ITEM* rats;
     D_PAD*         pad;
     NETINFO_ITEM*  net;
 
-    if( m_Pcb->GetPadCount() == 0 )
+    if( aPcb->GetPadCount() == 0 )
         return;
 
-    if( (m_Pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
-        Build_Board_Ratsnest();
+    if( (aPcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
+        Build_Board_Ratsnest( aPcb );
 
-    for( int net_code = 1; net_code < (int) m_Pcb->GetNetCount(); net_code++ )
+    for( int net_code = 1; net_code < (int) aPcb->GetNetCount(); net_code++ )
     {
-        net = m_Pcb->FindNet( net_code );
+        net = aPcb->FindNet( net_code );
 
         wxCHECK_RET( net != NULL,
                      wxString::Format( wxT( "Net code %d not found!" ), net_code ) );
@@ -470,11 +477,11 @@ void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
 
         for( unsigned ii = net->m_RatsnestStartIdx; ii < net->m_RatsnestEndIdx; ii++ )
         {
-            m_Pcb->m_FullRatsnest[ii].m_Status &= ~CH_ACTIF;
+            aPcb->m_FullRatsnest[ii].m_Status &= ~CH_ACTIF;
         }
 
         // First pass - activate links for not connected pads
-        rats = &m_Pcb->m_FullRatsnest[0];
+        rats = &aPcb->m_FullRatsnest[0];
         tst_links_between_pads( subratsnest,
                                 rats + net->m_RatsnestStartIdx,
                                 rats + net->m_RatsnestEndIdx );
@@ -482,21 +489,27 @@ void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
         // Second pass activate links between blocks (Iteration)
         while( subratsnest > 1 )
         {
-            subratsnest = tst_links_between_blocks( net, m_Pcb->m_FullRatsnest );
+            subratsnest = tst_links_between_blocks( net, aPcb->m_FullRatsnest );
         }
     }
 
-    m_Pcb->SetUnconnectedNetCount( 0 );
+    aPcb->SetUnconnectedNetCount( 0 );
 
     unsigned cnt = 0;
 
-    for( unsigned ii = 0; ii < m_Pcb->GetRatsnestsCount(); ii++ )
+    for( unsigned ii = 0; ii < aPcb->GetRatsnestsCount(); ii++ )
     {
-        if( m_Pcb->m_FullRatsnest[ii].IsActive() )
+        if( aPcb->m_FullRatsnest[ii].IsActive() )
             cnt++;
     }
 
-    m_Pcb->SetUnconnectedNetCount( cnt );
+    aPcb->SetUnconnectedNetCount( cnt );
+}
+
+
+void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
+{
+    ::TestForActiveLinksInRatsnest( m_Pcb, aNetCode );
 }
 
 
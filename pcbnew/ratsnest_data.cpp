@@ -59,13 +59,6 @@ uint64_t getDistance( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode2 )
 }
 
 
-bool sortDistance( const RN_NODE_PTR& aOrigin, const RN_NODE_PTR& aNode1,
-                   const RN_NODE_PTR& aNode2 )
-{
-    return getDistance( aOrigin, aNode1 ) < getDistance( aOrigin, aNode2 );
-}
-
-
 bool sortWeight( const RN_EDGE_PTR& aEdge1, const RN_EDGE_PTR& aEdge2 )
 {
     return aEdge1->getWeight() < aEdge2->getWeight();
@@ -90,6 +83,17 @@ bool operator!=( const RN_NODE_PTR& aFirst, const RN_NODE_PTR& aSecond )
 }
 
 
+///> Nets with less nodes are always recomputed from scratch.
+static const unsigned int RN_INCREMENTAL_MIN_NODES = 64;
+
+///> A net is recomputed from scratch if more than 1/RN_INCREMENTAL_MAX_CHANGES of its nodes
+///> have changed.
+static const unsigned int RN_INCREMENTAL_MAX_CHANGES = 8;
+
+///> Number of closest neighbours a changed node may be linked to by incremental updates.
+static const int RN_INCREMENTAL_NEIGHBOURS = 8;
+
+
 bool isEdgeConnectingNode( const RN_EDGE_PTR& aEdge, const RN_NODE_PTR& aNode )
 {
     return aEdge->getSourceNode() == aNode || aEdge->getTargetNode() == aNode;
@@ -97,7 +101,8 @@ bool isEdgeConnectingNode( const RN_EDGE_PTR& aEdge, const RN_NODE_PTR& aNode )
 
 
 std::vector<RN_EDGE_PTR>* kruskalMST( RN_LINKS::RN_EDGE_LIST& aEdges,
-                                      const std::vector<RN_NODE_PTR>& aNodes )
+                                      const std::vector<RN_NODE_PTR>& aNodes,
+                                      bool* aSpanning = NULL )
 {
     unsigned int nodeNumber = aNodes.size();
     unsigned int mstExpectedSize = nodeNumber - 1;
@@ -160,6 +165,10 @@ std::vector<RN_EDGE_PTR>* kruskalMST( RN_LINKS::RN_EDGE_LIST& aEdges,
         aEdges.erase( aEdges.begin() );
     }
 
+    // All nodes are connected only if no edge was missing
+    if( aSpanning )
+        *aSpanning = ( mstSize == mstExpectedSize );
+
     // Probably we have discarded some of edges, so reduce the size
     mst->resize( mstSize );
 
@@ -211,6 +220,236 @@ void RN_NET::validateEdge( RN_EDGE_PTR& aEdge )
 }
 
 
+RN_NODE_GRID::RN_NODE_GRID() :
+    m_cellSize( 1 ), m_count( 0 ), m_countAtRebuild( 0 ),
+    m_xmin( 0 ), m_ymin( 0 ), m_xmax( 0 ), m_ymax( 0 )
+{
+}
+
+
+int RN_NODE_GRID::cellCoord( int aValue ) const
+{
+    if( aValue >= 0 )
+        return aValue / m_cellSize;
+
+    return -( ( -(int64_t) aValue + m_cellSize - 1 ) / m_cellSize );
+}
+
+
+double RN_NODE_GRID::cellsInBounds() const
+{
+    return ( (double) cellCoord( m_xmax ) - cellCoord( m_xmin ) + 1 ) *
+           ( (double) cellCoord( m_ymax ) - cellCoord( m_ymin ) + 1 );
+}
+
+
+void RN_NODE_GRID::Add( const RN_NODE_PTR& aNode )
+{
+    if( m_count == 0 )
+    {
+        m_xmin = m_xmax = aNode->GetX();
+        m_ymin = m_ymax = aNode->GetY();
+    }
+    else
+    {
+        m_xmin = std::min( m_xmin, aNode->GetX() );
+        m_xmax = std::max( m_xmax, aNode->GetX() );
+        m_ymin = std::min( m_ymin, aNode->GetY() );
+        m_ymax = std::max( m_ymax, aNode->GetY() );
+    }
+
+    m_cells[cellKey( cellCoord( aNode->GetX() ), cellCoord( aNode->GetY() ) )].push_back( aNode );
+    ++m_count;
+
+    // Too many nodes for the cell size, or too many (mostly empty) cells for the nodes
+    if( m_count > 2 * m_countAtRebuild + 8 || cellsInBounds() > 4.0 * m_count + 16 )
+        rebuild();
+}
+
+
+void RN_NODE_GRID::Remove( const RN_NODE_PTR& aNode )
+{
+    RN_CELL_MAP::iterator cell = m_cells.find( cellKey( cellCoord( aNode->GetX() ),
+                                                        cellCoord( aNode->GetY() ) ) );
+
+    if( cell == m_cells.end() )
+        return;
+
+    std::vector<RN_NODE_PTR>& nodes = cell->second;
+
+    for( unsigned int i = 0; i < nodes.size(); ++i )
+    {
+        if( nodes[i] == aNode )
+        {
+            nodes[i] = nodes.back();
+            nodes.pop_back();
+            --m_count;
+            break;
+        }
+    }
+
+    if( nodes.empty() )
+        m_cells.erase( cell );
+
+    // Cells became too big for the remaining nodes
+    if( m_count < m_countAtRebuild / 4 )
+        rebuild();
+}
+
+
+void RN_NODE_GRID::Clear()
+{
+    m_cells.clear();
+    m_count = 0;
+    m_countAtRebuild = 0;
+    m_cellSize = 1;
+}
+
+
+void RN_NODE_GRID::rebuild()
+{
+    std::vector<RN_NODE_PTR> nodes;
+    nodes.reserve( m_count );
+
+    BOOST_FOREACH( const std::vector<RN_NODE_PTR>& cellNodes, m_cells | boost::adaptors::map_values )
+        nodes.insert( nodes.end(), cellNodes.begin(), cellNodes.end() );
+
+    m_cells.clear();
+    m_count = nodes.size();
+    m_countAtRebuild = m_count;
+
+    if( nodes.empty() )
+        return;
+
+    m_xmin = m_xmax = nodes[0]->GetX();
+    m_ymin = m_ymax = nodes[0]->GetY();
+
+    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
+    {
+        m_xmin = std::min( m_xmin, node->GetX() );
+        m_xmax = std::max( m_xmax, node->GetX() );
+        m_ymin = std::min( m_ymin, node->GetY() );
+        m_ymax = std::max( m_ymax, node->GetY() );
+    }
+
+    // About one node per cell. The second term limits the number of cells
+    // when nodes are (almost) aligned.
+    double width  = (double) m_xmax - m_xmin;
+    double height = (double) m_ymax - m_ymin;
+    double size = std::max( sqrt( width * height / m_count ),
+                            std::max( width, height ) / m_count );
+
+    m_cellSize = (int) std::min( std::max( size, 1.0 ),
+                                 (double) std::numeric_limits<int>::max() / 2 );
+
+    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
+        m_cells[cellKey( cellCoord( node->GetX() ), cellCoord( node->GetY() ) )].push_back( node );
+}
+
+
+///> Helper structure for RN_NODE_GRID::FindClosest(): keeps the farthest candidate
+///> on the top of the heap.
+struct RN_CANDIDATE_COMPARE
+{
+    bool operator()( const std::pair<uint64_t, RN_NODE_PTR>& aFirst,
+                     const std::pair<uint64_t, RN_NODE_PTR>& aSecond ) const
+    {
+        return aFirst.first < aSecond.first;
+    }
+};
+
+
+void RN_NODE_GRID::FindClosest( const RN_NODE_PTR& aNode, const RN_NODE_FILTER& aFilter,
+                                int aNumber, std::list<RN_NODE_PTR>& aResult ) const
+{
+    typedef std::pair<uint64_t, RN_NODE_PTR> CANDIDATE;
+
+    if( m_count == 0 )
+        return;
+
+    unsigned int maxCount = aNumber > 0 ? aNumber : m_count;
+
+    // Heap of the best candidates found so far
+    std::vector<CANDIDATE> candidates;
+    RN_CANDIDATE_COMPARE compare;
+
+    const int x = aNode->GetX();
+    const int y = aNode->GetY();
+    const int ox = cellCoord( x );
+    const int oy = cellCoord( y );
+
+    const int xmin = cellCoord( m_xmin ), xmax = cellCoord( m_xmax );
+    const int ymin = cellCoord( m_ymin ), ymax = cellCoord( m_ymax );
+
+    // The last ring of cells that contains nodes
+    int64_t maxRing = std::max( std::max( (int64_t) ox - xmin, (int64_t) xmax - ox ),
+                                std::max( (int64_t) oy - ymin, (int64_t) ymax - oy ) );
+
+    // Visit rings of cells around the searched position, until the nodes that are not visited
+    // yet cannot be closer than the ones already found
+    for( int64_t ring = 0; ring <= maxRing; ++ring )
+    {
+        int64_t top = std::max( (int64_t) ymin, oy - ring );
+        int64_t bottom = std::min( (int64_t) ymax, oy + ring );
+
+        for( int64_t cy = top; cy <= bottom; ++cy )
+        {
+            bool fullRow = ( cy == oy - ring || cy == oy + ring );
+            int64_t step = fullRow ? 1 : 2 * ring;
+            int64_t cx = ox - ring;
+
+            if( fullRow )
+                cx = std::max( (int64_t) xmin, cx );
+
+            for( ; cx <= std::min( (int64_t) xmax, ox + ring ); cx += step )
+            {
+                if( cx < xmin )
+                    continue;
+
+                RN_CELL_MAP::const_iterator cell = m_cells.find( cellKey( cx, cy ) );
+
+                if( cell == m_cells.end() )
+                    continue;
+
+                BOOST_FOREACH( const RN_NODE_PTR& node, cell->second )
+                {
+                    if( node == aNode || !aFilter( node ) )
+                        continue;
+
+                    int64_t dx = (int64_t) node->GetX() - x;
+                    int64_t dy = (int64_t) node->GetY() - y;
+                    uint64_t distance = dx * dx + dy * dy;
+
+                    if( candidates.size() < maxCount )
+                    {
+                        candidates.push_back( CANDIDATE( distance, node ) );
+                        std::push_heap( candidates.begin(), candidates.end(), compare );
+                    }
+                    else if( distance < candidates.front().first )
+                    {
+                        std::pop_heap( candidates.begin(), candidates.end(), compare );
+                        candidates.back() = CANDIDATE( distance, node );
+                        std::push_heap( candidates.begin(), candidates.end(), compare );
+                    }
+                }
+            }
+        }
+
+        // Nodes outside the visited rings are at least that far
+        double minDistance = (double) ring * m_cellSize;
+
+        if( candidates.size() == maxCount
+                && (double) candidates.front().first <= minDistance * minDistance )
+            break;
+    }
+
+    std::sort_heap( candidates.begin(), candidates.end(), compare );
+
+    BOOST_FOREACH( const CANDIDATE& candidate, candidates )
+        aResult.push_back( candidate.second );
+}
+
+
 const RN_NODE_PTR& RN_LINKS::AddNode( int aX, int aY )
 {
     RN_NODE_SET::iterator node;
@@ -219,6 +458,9 @@ const RN_NODE_PTR& RN_LINKS::AddNode( int aX, int aY )
     boost::tie( node, wasNewElement ) = m_nodes.emplace( boost::make_shared<RN_NODE>( aX, aY ) );
     (*node)->IncRefCount(); // TODO use the shared_ptr use_count
 
+    if( wasNewElement )
+        m_grid.Add( *node );
+
     return *node;
 }
 
@@ -229,6 +471,7 @@ bool RN_LINKS::RemoveNode( const RN_NODE_PTR& aNode )
 
     if( aNode->GetRefCount() == 0 )
     {
+        m_grid.Remove( aNode );
         m_nodes.erase( aNode );
 
         return true;
@@ -296,8 +539,83 @@ void RN_NET::compute()
 }
 
 
+bool RN_NET::computeIncremental()
+{
+    const RN_LINKS::RN_NODE_SET& boardNodes = m_links.GetNodes();
+    const RN_LINKS::RN_EDGE_LIST& boardEdges = m_links.GetConnections();
+
+    // Small nets are computed from scratch quickly, and when many nodes have changed,
+    // the previous spanning tree is not worth repairing
+    if( !m_rnEdges || boardNodes.size() < RN_INCREMENTAL_MIN_NODES
+            || m_changedNodes.size() * RN_INCREMENTAL_MAX_CHANGES > boardNodes.size() )
+        return false;
+
+    std::vector<RN_NODE_PTR> nodes( boardNodes.begin(), boardNodes.end() );
+
+    // Spanning tree candidates: the existing connections..
+    RN_LINKS::RN_EDGE_LIST candidates( boardEdges.begin(), boardEdges.end() );
+
+    // ..the previous spanning tree, without edges to removed nodes (nodes may have been
+    // replaced by new ones at the same position, so edges are rebuilt with the current nodes)..
+    BOOST_FOREACH( const RN_EDGE_PTR& edge, m_mstEdges )
+    {
+        RN_LINKS::RN_NODE_SET::const_iterator source = boardNodes.find( edge->getSourceNode() );
+        RN_LINKS::RN_NODE_SET::const_iterator target = boardNodes.find( edge->getTargetNode() );
+
+        if( source == boardNodes.end() || target == boardNodes.end() )
+            continue;
+
+        candidates.push_back( boost::make_shared<RN_EDGE_MST>( *source, *target,
+                                                               getDistance( *source, *target ) ) );
+    }
+
+    // ..and connections from the changed nodes to their closest neighbours
+    BOOST_FOREACH( const RN_NODE_PTR& changed, m_changedNodes )
+    {
+        RN_LINKS::RN_NODE_SET::const_iterator node = boardNodes.find( changed );
+
+        if( node == boardNodes.end() )
+            continue;
+
+        std::list<RN_NODE_PTR> closest;
+        m_links.GetNodeGrid().FindClosest( *node, RN_NODE_FILTER(),
+                                           RN_INCREMENTAL_NEIGHBOURS, closest );
+
+        BOOST_FOREACH( const RN_NODE_PTR& neighbour, closest )
+        {
+            candidates.push_back( boost::make_shared<RN_EDGE_MST>( *node, neighbour,
+                                                          getDistance( *node, neighbour ) ) );
+        }
+    }
+
+    // Connections lost by removed items may have split the net in parts that are not
+    // linked by any candidate: then a full update is required
+    bool spanning;
+    std::vector<RN_EDGE_PTR>* mst = kruskalMST( candidates, nodes, &spanning );
+
+    if( !spanning )
+    {
+        delete mst;
+        return false;
+    }
+
+    m_rnEdges.reset( mst );
+
+    return true;
+}
+
+
 void RN_NET::clearNode( const RN_NODE_PTR& aNode )
 {
+    // The nodes previously linked to the removed one have to be linked again
+    BOOST_FOREACH( const RN_EDGE_PTR& edge, m_mstEdges )
+    {
+        if( edge->getSourceNode() == aNode )
+            addChangedNode( edge->getTargetNode() );
+        else if( edge->getTargetNode() == aNode )
+            addChangedNode( edge->getSourceNode() );
+    }
+
     if( !m_rnEdges )
         return;
 
@@ -375,7 +693,12 @@ void RN_NET::Update()
     // Add edges resulting from nodes being connected by zones
     processZones();
 
-    compute();
+    if( !m_incremental || !computeIncremental() )
+        compute();
+
+    // Keep the spanning tree for the next incremental update
+    m_mstEdges = *m_rnEdges;
+    m_changedNodes.clear();
 
     BOOST_FOREACH( RN_EDGE_PTR& edge, *m_rnEdges )
         validateEdge( edge );
@@ -388,6 +711,7 @@ void RN_NET::AddItem( const D_PAD* aPad )
 {
     RN_NODE_PTR nodePtr = m_links.AddNode( aPad->GetPosition().x, aPad->GetPosition().y );
     m_pads[aPad] = nodePtr;
+    addChangedNode( nodePtr );
 
     m_dirty = true;
 }
@@ -396,6 +720,7 @@ void RN_NET::AddItem( const D_PAD* aPad )
 void RN_NET::AddItem( const SEGVIA* aVia )
 {
     m_vias[aVia] = m_links.AddNode( aVia->GetPosition().x, aVia->GetPosition().y );
+    addChangedNode( m_vias[aVia] );
 
     m_dirty = true;
 }
@@ -407,6 +732,8 @@ void RN_NET::AddItem( const TRACK* aTrack )
     RN_NODE_PTR end = m_links.AddNode( aTrack->GetEnd().x, aTrack->GetEnd().y );
 
     m_tracks[aTrack] = m_links.AddConnection( start, end );
+    addChangedNode( start );
+    addChangedNode( end );
 
     m_dirty = true;
 }
@@ -446,6 +773,7 @@ void RN_NET::AddItem( const ZONE_CONTAINER* aZone )
             // at the end), so we skip it
             m_zonePolygons[aZone].push_back( RN_POLY( &polyPoints[idxStart], &point, aZone,
                                              m_links, BOX2I( origin, end - origin ) ) );
+            addChangedNode( m_zonePolygons[aZone].back().GetNode() );
 
             idxStart = i + 1;
 
@@ -511,6 +839,8 @@ void RN_NET::RemoveItem( const TRACK* aTrack )
         RN_NODE_PTR aBegin = edge->getSourceNode();
         RN_NODE_PTR aEnd = edge->getTargetNode();
         m_links.RemoveConnection( edge );
+        addChangedNode( aBegin );
+        addChangedNode( aEnd );
 
         // Remove nodes associated with the edge. It is done in a safe way, there is a check
         // if nodes are not used by other edges.
@@ -548,7 +878,10 @@ void RN_NET::RemoveItem( const ZONE_CONTAINER* aZone )
         // Remove all connections added by the zone
         std::deque<RN_EDGE_PTR>& edges = m_zoneConnections.at( aZone );
         BOOST_FOREACH( RN_EDGE_PTR& edge, edges )
+        {
             m_links.RemoveConnection( edge );
+            addChangedNode( edge->getTargetNode() );
+        }
         edges.clear();
 
         m_dirty = true;
@@ -561,84 +894,29 @@ void RN_NET::RemoveItem( const ZONE_CONTAINER* aZone )
 
 const RN_NODE_PTR RN_NET::GetClosestNode( const RN_NODE_PTR& aNode ) const
 {
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
-    RN_LINKS::RN_NODE_SET::const_iterator it, itEnd;
-
-    unsigned int minDistance = std::numeric_limits<unsigned int>::max();
-    RN_NODE_PTR closest;
-
-    for( it = nodes.begin(), itEnd = nodes.end(); it != itEnd; ++it )
-    {
-        RN_NODE_PTR node = *it;
-
-        // Obviously the distance between node and itself is the shortest,
-        // that's why we have to skip it
-        if( node != aNode )
-        {
-            unsigned int distance = getDistance( node, aNode );
-            if( distance < minDistance )
-            {
-                minDistance = distance;
-                closest = node;
-            }
-        }
-    }
-
-    return closest;
+    return GetClosestNode( aNode, RN_NODE_FILTER() );
 }
 
 
 const RN_NODE_PTR RN_NET::GetClosestNode( const RN_NODE_PTR& aNode,
                                           const RN_NODE_FILTER& aFilter ) const
 {
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
-    RN_LINKS::RN_NODE_SET::const_iterator it, itEnd;
-
-    unsigned int minDistance = std::numeric_limits<unsigned int>::max();
-    RN_NODE_PTR closest;
+    std::list<RN_NODE_PTR> closest;
 
-    for( it = nodes.begin(), itEnd = nodes.end(); it != itEnd; ++it )
-    {
-        RN_NODE_PTR node = *it;
+    // Obviously the distance between node and itself is the shortest,
+    // that's why it is skipped by the search
+    m_links.GetNodeGrid().FindClosest( aNode, aFilter, 1, closest );
 
-        // Obviously the distance between node and itself is the shortest,
-        // that's why we have to skip it
-        if( node != aNode && aFilter( node ) )
-        {
-            unsigned int distance = getDistance( node, aNode );
+    if( closest.empty() )
+        return RN_NODE_PTR();
 
-            if( distance < minDistance )
-            {
-                minDistance = distance;
-                closest = node;
-            }
-        }
-    }
-
-    return closest;
+    return closest.front();
 }
 
 
 std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode, int aNumber ) const
 {
-    std::list<RN_NODE_PTR> closest;
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
-
-    // Copy nodes
-    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
-        closest.push_back( node );
-
-    // Sort by the distance from aNode
-    closest.sort( boost::bind( sortDistance, aNode, _1, _2 ) );
-
-    // Remove the first node (==aNode), as it is surely located within the smallest distance
-    closest.pop_front();
-
-    // Trim the result to the asked size
-    if( aNumber > 0 )
-        closest.resize( std::min( (size_t)aNumber, nodes.size() ) );
-
-    return closest;
+    return GetClosestNodes( aNode, RN_NODE_FILTER(), aNumber );
 }
 
 
@@ -646,24 +924,9 @@ std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode,
                                                 const RN_NODE_FILTER& aFilter, int aNumber ) const
 {
     std::list<RN_NODE_PTR> closest;
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
-
-    // Copy nodes
-    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
-        closest.push_back( node );
-
-    // Sort by the distance from aNode
-    closest.sort( boost::bind( sortDistance, aNode, _1, _2 ) );
-
-    // Remove the first node (==aNode), as it is surely located within the smallest distance
-    closest.pop_front();
-
-    // Filter out by condition
-    std::remove_if( closest.begin(), closest.end(), aFilter );
 
-    // Trim the result to the asked size
-    if( aNumber > 0 )
-        closest.resize( std::min( static_cast<size_t>( aNumber ), nodes.size() ) );
+    // Nodes are sorted by the distance from aNode, and aNode itself is skipped
+    m_links.GetNodeGrid().FindClosest( aNode, aFilter, aNumber, closest );
 
     return closest;
 }
@@ -1027,5 +1290,6 @@ void RN_DATA::updateNet( int aNetCode )
         return;
 
     m_nets[aNetCode].ClearSimple();
+    m_nets[aNetCode].SetIncremental( m_incremental );
     m_nets[aNetCode].Update();
 }
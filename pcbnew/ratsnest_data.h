@@ -39,6 +39,10 @@
 #include <boost/unordered_map.hpp>
 #include <boost/foreach.hpp>
 
+#include <vector>
+#include <list>
+#include <stdint.h>
+
 class BOARD;
 class BOARD_ITEM;
 class BOARD_CONNECTED_ITEM;
@@ -108,6 +112,96 @@ struct RN_NODE_HASH : std::unary_function<RN_NODE_PTR, std::size_t>
 };
 
 
+/**
+ * Class RN_NODE_GRID
+ * Spatial index of the nodes of a net, used to find the nodes closest to a given point
+ * without checking all the nodes of the net.
+ * Nodes are stored in square cells, whose size is adapted to the density of nodes when the
+ * number of nodes or the area covered by them change significantly, so a search visits
+ * only a few cells around the searched point.
+ */
+class RN_NODE_GRID
+{
+public:
+    RN_NODE_GRID();
+
+    /**
+     * Function Add()
+     * Adds a node to the index.
+     * @param aNode is the node to be added.
+     */
+    void Add( const RN_NODE_PTR& aNode );
+
+    /**
+     * Function Remove()
+     * Removes a node from the index.
+     * @param aNode is the node to be removed (nodes are compared by their coordinates).
+     */
+    void Remove( const RN_NODE_PTR& aNode );
+
+    /**
+     * Function Clear()
+     * Removes all nodes from the index.
+     */
+    void Clear();
+
+    /**
+     * Function GetCount()
+     * Returns the number of nodes in the index.
+     */
+    int GetCount() const
+    {
+        return m_count;
+    }
+
+    /**
+     * Function FindClosest()
+     * Returns nodes sorted by the distance from a specific node. The node itself (and any other
+     * node at the same position) is never returned.
+     * @param aNode is the node for which the closest nodes are searched.
+     * @param aFilter is a functor that filters nodes, only nodes passing it are returned.
+     * @param aNumber is the maximal number of returned nodes. If it is not positive, all the
+     * nodes passing the filter are returned.
+     * @param aResult is the list that receives the found nodes.
+     */
+    void FindClosest( const RN_NODE_PTR& aNode, const RN_NODE_FILTER& aFilter, int aNumber,
+                      std::list<RN_NODE_PTR>& aResult ) const;
+
+private:
+    typedef boost::unordered_map<uint64_t, std::vector<RN_NODE_PTR> > RN_CELL_MAP;
+
+    ///> Returns the cell coordinate for a given board coordinate (rounded towards -infinity).
+    int cellCoord( int aValue ) const;
+
+    ///> Returns the key of a given cell.
+    static uint64_t cellKey( int aCellX, int aCellY )
+    {
+        return ( (uint64_t) (uint32_t) aCellX << 32 ) | (uint32_t) aCellY;
+    }
+
+    ///> Returns the number of cells covering the bounding box of nodes.
+    double cellsInBounds() const;
+
+    ///> Recomputes the cell size from the current nodes and fills the cells again.
+    void rebuild();
+
+    ///> Nodes stored in cells.
+    RN_CELL_MAP m_cells;
+
+    ///> Size of cells.
+    int m_cellSize;
+
+    ///> Number of nodes.
+    int m_count;
+
+    ///> Number of nodes when the cell size was computed.
+    int m_countAtRebuild;
+
+    ///> Bounding box of nodes (it only grows until the next rebuild).
+    int m_xmin, m_ymin, m_xmax, m_ymax;
+};
+
+
 /**
  * Class RN_LINKS
  * Manages data describing nodes and connections for a given net.
@@ -147,6 +241,16 @@ public:
         return m_nodes;
     }
 
+    /**
+     * Function GetNodeGrid()
+     * Returns the spatial index of the currently used nodes.
+     * @return The spatial index of the currently used nodes.
+     */
+    const RN_NODE_GRID& GetNodeGrid() const
+    {
+        return m_grid;
+    }
+
     /**
      * Function AddConnection()
      * Adds a connection between two nodes and of given distance. Edges with distance equal 0 are
@@ -184,6 +288,9 @@ protected:
     ///> Set of nodes that are used are expected to be connected together.
     RN_NODE_SET m_nodes;
 
+    ///> Spatial index of m_nodes.
+    RN_NODE_GRID m_grid;
+
     ///> List of edges that currently connect nodes.
     RN_EDGE_LIST m_edges;
 };
@@ -258,7 +365,7 @@ class RN_NET
 {
 public:
     ///> Default constructor.
-    RN_NET() : m_dirty( true ), m_visible( true )
+    RN_NET() : m_dirty( true ), m_incremental( true ), m_visible( true )
     {}
 
     /**
@@ -318,6 +425,18 @@ public:
      */
     void Update();
 
+    /**
+     * Function SetIncremental()
+     * Enables or disables incremental updates. When enabled (the default), Update() repairs the
+     * previous spanning tree if only a few nodes have changed since the last update, instead of
+     * recomputing it from scratch.
+     * @param aEnabled is new state.
+     */
+    void SetIncremental( bool aEnabled )
+    {
+        m_incremental = aEnabled;
+    }
+
     /**
      * Function AddItem()
      * Adds an appropriate node associated with selected pad, so it is
@@ -503,12 +622,28 @@ protected:
     ///> Recomputes ratsnset from scratch.
     void compute();
 
+    ///> Recomputes ratsnest by repairing the previous spanning tree around the changed nodes.
+    ///> Returns false (and leaves ratsnest unchanged) if it could not be done.
+    bool computeIncremental();
+
+    ///> Marks a node as changed since the last update.
+    void addChangedNode( const RN_NODE_PTR& aNode )
+    {
+        m_changedNodes.push_back( aNode );
+    }
+
     ////> Stores information about connections for a given net.
     RN_LINKS m_links;
 
     ///> Vector of edges that makes ratsnest for a given net.
     boost::shared_ptr< std::vector<RN_EDGE_PTR> > m_rnEdges;
 
+    ///> Edges of the last computed spanning tree, before their validation.
+    std::vector<RN_EDGE_PTR> m_mstEdges;
+
+    ///> Nodes that were added, or lost a connection, since the last update.
+    std::vector<RN_NODE_PTR> m_changedNodes;
+
     ///> List of nodes for which ratsnest is drawn in simple mode.
     std::deque<RN_NODE_PTR> m_simpleNodes;
 
@@ -518,6 +653,9 @@ protected:
     ///> Flag indicating necessity of recalculation of ratsnest for a net.
     bool m_dirty;
 
+    ///> Flag allowing incremental updates.
+    bool m_incremental;
+
     ///> Map that associates nodes in the ratsnest model to respective nodes.
     boost::unordered_map<const D_PAD*, RN_NODE_PTR> m_pads;
 
@@ -550,7 +688,7 @@ public:
      * Default constructor
      * @param aBoard is the board to be processed in order to look for unconnected items.
      */
-    RN_DATA( const BOARD* aBoard ) : m_board( aBoard ) {}
+    RN_DATA( const BOARD* aBoard ) : m_board( aBoard ), m_incremental( true ) {}
 
     /**
      * Function Add()
@@ -623,6 +761,16 @@ public:
      */
     void Recalculate( int aNet = -1 );
 
+    /**
+     * Function SetIncremental()
+     * Enables or disables incremental updates of nets (see RN_NET::SetIncremental()).
+     * @param aEnabled is new state.
+     */
+    void SetIncremental( bool aEnabled )
+    {
+        m_incremental = aEnabled;
+    }
+
     /**
      * Function GetNetCount()
      * Returns the number of nets handled by the ratsnest.
@@ -659,6 +807,9 @@ protected:
 
     ///> Stores information about ratsnest grouped by net numbers.
     std::vector<RN_NET> m_nets;
+
+    ///> Flag allowing incremental updates of nets.
+    bool m_incremental;
 };
 
 #endif /* RATSNEST_DATA_H */
@@ -43,5 +43,8 @@ BOARD*  LoadBoard( wxString& aFileName );
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard, IO_MGR::PCB_FILE_T aFormat );
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard );
 
+// Defined in connect.cpp: propagates the pad net codes to the track segments of aBoard
+void    RecalculateAllTracksNetcode( BOARD* aBoard );
+
 
 #endif
@@ -232,7 +232,7 @@ void SPECCTRA_DB::readTIME( time_t* time_stamp ) throw( IO_ERROR )
 
 void SPECCTRA_DB::LoadPCB( const wxString& filename ) throw( IO_ERROR )
 {
-    FILE_LINE_READER    reader( filename );
+    MAPPED_FILE_LINE_READER reader( filename );
 
     PushReader( &reader );
 
@@ -251,7 +251,7 @@ void SPECCTRA_DB::LoadPCB( const wxString& filename ) throw( IO_ERROR )
 
 void SPECCTRA_DB::LoadSESSION( const wxString& filename ) throw( IO_ERROR )
 {
-    FILE_LINE_READER    reader( filename );
+    MAPPED_FILE_LINE_READER reader( filename );
 
     PushReader( &reader );
 
@@ -0,0 +1,40 @@
+/**
+ * @file standalone_pgm.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef STANDALONE_PGM_H
+#define STANDALONE_PGM_H
+
+/**
+ * Function InitStandalonePgm
+ * gives a PGM_BASE to the programs which use the pcbnew code without the KiCad
+ * launcher (the command line tools and benchmarks), so Pgm() can be called.
+ * The PGM_BASE holds only default settings.  Call it once, after wxWidgets is
+ * initialized.
+ */
+void InitStandalonePgm();
+
+#endif  // STANDALONE_PGM_H
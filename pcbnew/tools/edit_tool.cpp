@@ -120,6 +120,9 @@ int EDIT_TOOL::Main( TOOL_EVENT& aEvent )
             }
             else if( evt->IsAction( &COMMON_ACTIONS::remove ) )
             {
+                if( m_dragging )
+                    setMoving( selection, false );
+
                 Remove( aEvent );
 
                 break;       // exit the loop, as there is no further processing for removed items
@@ -146,6 +149,7 @@ int EDIT_TOOL::Main( TOOL_EVENT& aEvent )
                 // Prepare to drag - save items, so changes can be undone
                 editFrame->OnModify();
                 editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+                setMoving( selection, true );
 
                 m_dragging = true;
             }
@@ -158,6 +162,9 @@ int EDIT_TOOL::Main( TOOL_EVENT& aEvent )
             break; // Finish
     }
 
+    if( m_dragging )
+        setMoving( selection, false );
+
     m_dragging = false;
 
     if( restore )
@@ -443,6 +450,20 @@ void EDIT_TOOL::updateRatsnest( bool aRedraw )
 }
 
 
+void EDIT_TOOL::setMoving( const SELECTION_TOOL::SELECTION& aSelection, bool aMoving )
+{
+    for( unsigned int i = 0; i < aSelection.items.GetCount(); ++i )
+    {
+        BOARD_ITEM* item = static_cast<BOARD_ITEM*>( aSelection.items.GetPickedItem( i ) );
+
+        if( aMoving )
+            item->SetFlags( IS_MOVED );
+        else
+            item->ClearFlags( IS_MOVED );
+    }
+}
+
+
 wxPoint EDIT_TOOL::getModificationPoint( const SELECTION_TOOL::SELECTION& aSelection )
 {
     if( aSelection.Size() == 1 )
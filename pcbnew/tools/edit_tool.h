@@ -116,6 +116,10 @@ private:
 
     void updateRatsnest( bool aRedraw );
 
+    ///> Sets or clears the IS_MOVED flag of the selected items, so the board spatial index
+    ///> does not put them back in its trees at an intermediate position while they are dragged.
+    void setMoving( const SELECTION_TOOL::SELECTION& aSelection, bool aMoving );
+
     ///> Returns the right modification point (e.g. for rotation), depending on the number of
     ///> selected items.
     wxPoint getModificationPoint( const SELECTION_TOOL::SELECTION& aSelection );
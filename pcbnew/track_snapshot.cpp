@@ -0,0 +1,202 @@
+/**
+ * @file track_snapshot.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <fctsys.h>
+#include <trigo.h>
+
+#include <class_track.h>
+
+#include <track_snapshot.h>
+
+
+void TRACK_SNAPSHOT::Clear()
+{
+    m_StartX.clear();
+    m_StartY.clear();
+    m_EndX.clear();
+    m_EndY.clear();
+    m_Width.clear();
+    m_LayerMask.clear();
+    m_NetCode.clear();
+    m_IsVia.clear();
+    m_Tracks.clear();
+}
+
+
+void TRACK_SNAPSHOT::Build( const DLIST<TRACK>& aTracks )
+{
+    Clear();
+
+    unsigned count = aTracks.GetCount();
+
+    m_StartX.reserve( count );
+    m_StartY.reserve( count );
+    m_EndX.reserve( count );
+    m_EndY.reserve( count );
+    m_Width.reserve( count );
+    m_LayerMask.reserve( count );
+    m_NetCode.reserve( count );
+    m_IsVia.reserve( count );
+    m_Tracks.reserve( count );
+
+    for( TRACK* track = aTracks.GetFirst(); track; track = track->Next() )
+    {
+        m_StartX.push_back( track->GetStart().x );
+        m_StartY.push_back( track->GetStart().y );
+        m_EndX.push_back( track->GetEnd().x );
+        m_EndY.push_back( track->GetEnd().y );
+        m_Width.push_back( track->GetWidth() );
+        m_LayerMask.push_back( track->GetLayerMask() );
+        m_NetCode.push_back( track->GetNetCode() );
+        m_IsVia.push_back( track->Type() == PCB_VIA_T );
+        m_Tracks.push_back( track );
+    }
+}
+
+
+EDA_RECT TRACK_SNAPSHOT::GetBoundingBox() const
+{
+    int count = GetCount();
+
+    if( count == 0 )
+        return EDA_RECT();
+
+    int xmin = INT_MAX;
+    int ymin = INT_MAX;
+    int xmax = INT_MIN;
+    int ymax = INT_MIN;
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int radius = m_Width[ii] / 2;
+
+        xmin = std::min( xmin, std::min( m_StartX[ii], m_EndX[ii] ) - radius );
+        ymin = std::min( ymin, std::min( m_StartY[ii], m_EndY[ii] ) - radius );
+        xmax = std::max( xmax, std::max( m_StartX[ii], m_EndX[ii] ) + radius );
+        ymax = std::max( ymax, std::max( m_StartY[ii], m_EndY[ii] ) + radius );
+    }
+
+    return EDA_RECT( wxPoint( xmin, ymin ), wxSize( xmax - xmin, ymax - ymin ) );
+}
+
+
+void TRACK_SNAPSHOT::CollectInRect( const EDA_RECT& aRect, LAYER_MSK aLayerMask,
+                                    std::vector<int>& aResult ) const
+{
+    EDA_RECT rect = aRect;
+    rect.Normalize();
+
+    const int left   = rect.GetX();
+    const int top    = rect.GetY();
+    const int right  = rect.GetRight();
+    const int bottom = rect.GetBottom();
+
+    int count = GetCount();
+    int found = 0;
+
+    // Sized once for the worst case: each rank is stored, and kept only if the track
+    // is inside (the next rank overwrites it otherwise), so the loop has no branch
+    aResult.resize( count );
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int radius = m_Width[ii] / 2;
+
+        // Non short-circuit operators: no branch until the test result
+        bool inside = ( std::min( m_StartX[ii], m_EndX[ii] ) - radius <= right )
+                    & ( std::max( m_StartX[ii], m_EndX[ii] ) + radius >= left )
+                    & ( std::min( m_StartY[ii], m_EndY[ii] ) - radius <= bottom )
+                    & ( std::max( m_StartY[ii], m_EndY[ii] ) + radius >= top )
+                    & ( ( m_LayerMask[ii] & aLayerMask ) != 0 );
+
+        aResult[found] = ii;
+        found += inside;
+    }
+
+    aResult.resize( found );
+}
+
+
+int TRACK_SNAPSHOT::HitTest( const wxPoint& aPosition, LAYER_MSK aLayerMask ) const
+{
+    int count = GetCount();
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        int radius = m_Width[ii] >> 1;
+
+        // Reject first on the bounding box, as most tracks are far away
+        if( std::min( m_StartX[ii], m_EndX[ii] ) - radius > aPosition.x
+          || std::max( m_StartX[ii], m_EndX[ii] ) + radius < aPosition.x
+          || std::min( m_StartY[ii], m_EndY[ii] ) - radius > aPosition.y
+          || std::max( m_StartY[ii], m_EndY[ii] ) + radius < aPosition.y )
+            continue;
+
+        if( ( m_LayerMask[ii] & aLayerMask ) == 0 )
+            continue;
+
+        wxPoint start( m_StartX[ii], m_StartY[ii] );
+
+        if( m_IsVia[ii] )
+        {
+            wxPoint rel_pos = aPosition - start;
+            double  dist = (double) rel_pos.x * rel_pos.x + (double) rel_pos.y * rel_pos.y;
+
+            if( dist <= (double) radius * radius )
+                return ii;
+        }
+        else if( TestSegmentHit( aPosition, start, wxPoint( m_EndX[ii], m_EndY[ii] ), radius ) )
+        {
+            return ii;
+        }
+    }
+
+    return -1;
+}
+
+
+double TRACK_SNAPSHOT::GetTotalLength( int aNetCode ) const
+{
+    double length = 0.0;
+    int    count = GetCount();
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        double dx = (double) m_EndX[ii] - m_StartX[ii];
+        double dy = (double) m_EndY[ii] - m_StartY[ii];
+
+        // Vias have a null length
+        if( aNetCode < 0 || m_NetCode[ii] == aNetCode )
+            length += sqrt( dx * dx + dy * dy );
+    }
+
+    return length;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file track_snapshot.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef TRACK_SNAPSHOT_H
+#define TRACK_SNAPSHOT_H
+
+#include <vector>
+
+#include <base_struct.h>                     // EDA_RECT
+#include <dlist.h>
+#include <layers_id_colors_and_visibility.h>
+
+class TRACK;
+
+
+/**
+ * Class TRACK_SNAPSHOT
+ * is a copy of the geometry of a track list (segments and vias), stored in
+ * parallel arrays: the data of the track of rank i (in list order) is
+ * m_StartX[i], m_StartY[i] ... and m_Tracks[i] is the track itself.
+ *
+ * Passes which only read the tracks can walk these arrays instead of following
+ * the Next() pointers of TRACK objects scattered on the heap.  The loops over the
+ * coordinates are written without branches on the items, so the compiler can
+ * vectorize them.
+ *
+ * The snapshot is not updated when the tracks change: it must be built again.
+ */
+class TRACK_SNAPSHOT
+{
+public:
+    std::vector<int>        m_StartX;
+    std::vector<int>        m_StartY;
+    std::vector<int>        m_EndX;
+    std::vector<int>        m_EndY;
+    std::vector<int>        m_Width;
+    std::vector<LAYER_MSK>  m_LayerMask;    ///< one layer for segments, a layer pair for vias
+    std::vector<int>        m_NetCode;
+    std::vector<char>       m_IsVia;        ///< not vector<bool>, read with no bit unpacking
+    std::vector<TRACK*>     m_Tracks;       ///< the source items
+
+    /**
+     * Function Build
+     * fills the snapshot with the tracks of \a aTracks, in list order.
+     */
+    void Build( const DLIST<TRACK>& aTracks );
+
+    /**
+     * Function Clear
+     * empties the snapshot.
+     */
+    void Clear();
+
+    unsigned GetCount() const { return m_Tracks.size(); }
+
+    /**
+     * Function GetBoundingBox
+     * @return the box containing all the tracks, including their width.
+     */
+    EDA_RECT GetBoundingBox() const;
+
+    /**
+     * Function CollectInRect
+     * finds the tracks whose bounding box (including the width) intersects \a aRect,
+     * and which are on one of the layers of \a aLayerMask.
+     * @param aResult receives the ranks of the tracks found, in increasing order.
+     */
+    void CollectInRect( const EDA_RECT& aRect, LAYER_MSK aLayerMask,
+                        std::vector<int>& aResult ) const;
+
+    /**
+     * Function HitTest
+     * finds the first track whose shape contains \a aPosition, on one of the layers
+     * of \a aLayerMask.  This is the test of TRACK::HitTest() for each track.
+     * @return the rank of the track, or -1 if none.
+     */
+    int HitTest( const wxPoint& aPosition, LAYER_MSK aLayerMask ) const;
+
+    /**
+     * Function GetTotalLength
+     * @return the sum of the lengths of the segments of the net \a aNetCode, or of
+     * all the segments if \a aNetCode is negative.
+     */
+    double GetTotalLength( int aNetCode = -1 ) const;
+};
+
+#endif  // TRACK_SNAPSHOT_H
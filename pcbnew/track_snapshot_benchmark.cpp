@@ -0,0 +1,346 @@
+/**
+ * @file track_snapshot_benchmark.cpp
+ * @brief Compares walking m_Track with walking a TRACK_SNAPSHOT.
+ *
+ * Usage: track_snapshot_benchmark [segment_count]
+ *
+ * A board holding segment_count random segments (100000 by default) and a via every
+ * 10 segments is built in memory.  The tracks are allocated between blocks of other
+ * data and linked in random order, as on a board edited for a long time.  The same
+ * read-only passes (bounding box, window queries, hit tests, total length) then run
+ * once on the linked list and once on the snapshot, and the times are printed.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <fctsys.h>
+#include <wx/init.h>
+#include <common.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <track_snapshot.h>
+#include <standalone_pgm.h>
+
+
+static const int BOARD_SIZE  = 300000000;   // 300 mm, in nm
+static const int WINDOW_SIZE = 5000000;     // 5 mm
+static const int WINDOW_COUNT = 200;
+static const int HIT_COUNT    = 200;
+static const int REPEAT_COUNT = 5;
+
+
+static int randomCoord( int aRange )
+{
+    return (int) ( ( (double) rand() / RAND_MAX ) * aRange );
+}
+
+
+/* Fills aBoard with aCount segments, and a via every 10 segments
+ */
+static void populateBoard( BOARD* aBoard, int aCount, std::vector<char*>& aFillers )
+{
+    std::vector<TRACK*> tracks;
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        TRACK* track;
+
+        if( ii % 10 == 9 )
+        {
+            SEGVIA* via = new SEGVIA( aBoard );
+            via->SetShape( VIA_THROUGH );
+            via->SetLayerPair( LAYER_N_FRONT, LAYER_N_BACK );
+            via->SetWidth( Millimeter2iu( 0.6 ) );
+
+            wxPoint pos( randomCoord( BOARD_SIZE ), randomCoord( BOARD_SIZE ) );
+            via->SetStart( pos );
+            via->SetEnd( pos );
+            track = via;
+        }
+        else
+        {
+            track = new TRACK( aBoard );
+            track->SetLayer( ( ii & 1 ) ? LAYER_N_FRONT : LAYER_N_BACK );
+            track->SetWidth( Millimeter2iu( 0.25 ) );
+
+            wxPoint start( randomCoord( BOARD_SIZE ), randomCoord( BOARD_SIZE ) );
+            track->SetStart( start );
+            track->SetEnd( start + wxPoint( randomCoord( WINDOW_SIZE ),
+                                            randomCoord( WINDOW_SIZE ) ) );
+        }
+
+        tracks.push_back( track );
+
+        // Other data allocated while the board is edited
+        aFillers.push_back( new char[16 + rand() % 512] );
+    }
+
+    std::random_shuffle( tracks.begin(), tracks.end() );
+
+    for( unsigned ii = 0; ii < tracks.size(); ++ii )
+        aBoard->m_Track.PushBack( tracks[ii] );
+}
+
+
+/* The passes on the linked list
+ */
+static EDA_RECT listBoundingBox( BOARD* aBoard )
+{
+    int xmin = INT_MAX;
+    int ymin = INT_MAX;
+    int xmax = INT_MIN;
+    int ymax = INT_MIN;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        int radius = track->GetWidth() / 2;
+
+        xmin = std::min( xmin, std::min( track->GetStart().x, track->GetEnd().x ) - radius );
+        ymin = std::min( ymin, std::min( track->GetStart().y, track->GetEnd().y ) - radius );
+        xmax = std::max( xmax, std::max( track->GetStart().x, track->GetEnd().x ) + radius );
+        ymax = std::max( ymax, std::max( track->GetStart().y, track->GetEnd().y ) + radius );
+    }
+
+    return EDA_RECT( wxPoint( xmin, ymin ), wxSize( xmax - xmin, ymax - ymin ) );
+}
+
+
+static unsigned listCollectInRect( BOARD* aBoard, const EDA_RECT& aRect, LAYER_MSK aLayerMask )
+{
+    unsigned found = 0;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        int radius = track->GetWidth() / 2;
+
+        if( std::min( track->GetStart().x, track->GetEnd().x ) - radius > aRect.GetRight()
+          || std::max( track->GetStart().x, track->GetEnd().x ) + radius < aRect.GetX()
+          || std::min( track->GetStart().y, track->GetEnd().y ) - radius > aRect.GetBottom()
+          || std::max( track->GetStart().y, track->GetEnd().y ) + radius < aRect.GetY() )
+            continue;
+
+        if( track->GetLayerMask() & aLayerMask )
+            found++;
+    }
+
+    return found;
+}
+
+
+static TRACK* listHitTest( BOARD* aBoard, const wxPoint& aPosition, LAYER_MSK aLayerMask )
+{
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( ( track->GetLayerMask() & aLayerMask ) && track->HitTest( aPosition ) )
+            return track;
+    }
+
+    return NULL;
+}
+
+
+static double listTotalLength( BOARD* aBoard )
+{
+    double length = 0.0;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        double dx = (double) track->GetEnd().x - track->GetStart().x;
+        double dy = (double) track->GetEnd().y - track->GetStart().y;
+
+        length += sqrt( dx * dx + dy * dy );
+    }
+
+    return length;
+}
+
+
+static void printTime( const char* aPass, unsigned aListTime, unsigned aSnapshotTime )
+{
+    printf( "%-16s\tlist %10.3f ms\tsnapshot %10.3f ms\tratio %.2f\n", aPass,
+            aListTime / 1000.0, aSnapshotTime / 1000.0,
+            aSnapshotTime ? (double) aListTime / aSnapshotTime : 0.0 );
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer;
+    InitStandalonePgm();
+
+    int segmentCount = 100000;
+
+    if( argc > 1 )
+        segmentCount = atoi( argv[1] );
+
+    if( segmentCount <= 0 )
+    {
+        fprintf( stderr, "usage: %s [segment_count]\n", argv[0] );
+        return 1;
+    }
+
+    srand( 1 );
+
+    BOARD*              board = new BOARD();
+    std::vector<char*>  fillers;
+
+    populateBoard( board, segmentCount, fillers );
+
+    std::vector<EDA_RECT> windows;
+
+    for( int ii = 0; ii < WINDOW_COUNT; ++ii )
+        windows.push_back( EDA_RECT( wxPoint( randomCoord( BOARD_SIZE ), randomCoord( BOARD_SIZE ) ),
+                                     wxSize( WINDOW_SIZE, WINDOW_SIZE ) ) );
+
+    TRACK_SNAPSHOT snapshot;
+
+    unsigned startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < REPEAT_COUNT; ++ii )
+        board->BuildTrackSnapshot( snapshot );
+
+    unsigned buildTime = ( GetRunningMicroSecs() - startTime ) / REPEAT_COUNT;
+
+    printf( "tracks %u\tsnapshot build %.3f ms\n", snapshot.GetCount(), buildTime / 1000.0 );
+
+    // Bounding box
+    EDA_RECT listBox, snapshotBox;
+
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < REPEAT_COUNT; ++ii )
+        listBox = listBoundingBox( board );
+
+    unsigned listTime = GetRunningMicroSecs() - startTime;
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < REPEAT_COUNT; ++ii )
+        snapshotBox = snapshot.GetBoundingBox();
+
+    printTime( "bounding box", listTime, GetRunningMicroSecs() - startTime );
+
+    // Window queries
+    unsigned listFound = 0;
+    unsigned snapshotFound = 0;
+    std::vector<int> found;
+
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < WINDOW_COUNT; ++ii )
+        listFound += listCollectInRect( board, windows[ii], LAYER_FRONT );
+
+    listTime = GetRunningMicroSecs() - startTime;
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < WINDOW_COUNT; ++ii )
+    {
+        snapshot.CollectInRect( windows[ii], LAYER_FRONT, found );
+        snapshotFound += found.size();
+    }
+
+    printTime( "window queries", listTime, GetRunningMicroSecs() - startTime );
+
+    // Hit tests, half of them on a track
+    std::vector<wxPoint> positions;
+
+    for( int ii = 0; ii < HIT_COUNT; ++ii )
+    {
+        if( ii & 1 )
+        {
+            positions.push_back( wxPoint( randomCoord( BOARD_SIZE ), randomCoord( BOARD_SIZE ) ) );
+        }
+        else
+        {
+            TRACK* track = snapshot.m_Tracks[rand() % snapshot.GetCount()];
+            positions.push_back( wxPoint( ( track->GetStart().x + track->GetEnd().x ) / 2,
+                                          ( track->GetStart().y + track->GetEnd().y ) / 2 ) );
+        }
+    }
+
+    std::vector<TRACK*> listHits;
+    std::vector<TRACK*> snapshotHits;
+
+    listHits.reserve( HIT_COUNT );
+    snapshotHits.reserve( HIT_COUNT );
+
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < HIT_COUNT; ++ii )
+        listHits.push_back( listHitTest( board, positions[ii], ALL_CU_LAYERS ) );
+
+    listTime = GetRunningMicroSecs() - startTime;
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < HIT_COUNT; ++ii )
+    {
+        int rank = snapshot.HitTest( positions[ii], ALL_CU_LAYERS );
+        snapshotHits.push_back( rank >= 0 ? snapshot.m_Tracks[rank] : NULL );
+    }
+
+    printTime( "hit tests", listTime, GetRunningMicroSecs() - startTime );
+
+    // Total length
+    double listLength = 0.0;
+    double snapshotLength = 0.0;
+
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < REPEAT_COUNT; ++ii )
+        listLength = listTotalLength( board );
+
+    listTime = GetRunningMicroSecs() - startTime;
+    startTime = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < REPEAT_COUNT; ++ii )
+        snapshotLength = snapshot.GetTotalLength();
+
+    printTime( "total length", listTime, GetRunningMicroSecs() - startTime );
+
+    int result = 0;
+
+    if( listBox.GetOrigin() != snapshotBox.GetOrigin() || listBox.GetEnd() != snapshotBox.GetEnd()
+      || listFound != snapshotFound
+      || listHits != snapshotHits
+      || std::fabs( listLength - snapshotLength ) > 1.0 )
+    {
+        fprintf( stderr, "error: the list and the snapshot give different results\n" );
+        result = 1;
+    }
+
+    delete board;
+
+    for( unsigned ii = 0; ii < fillers.size(); ++ii )
+        delete[] fillers[ii];
+
+    return result;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file zone_fill_benchmark.cpp
+ * @brief Compares the zone filling engines on a set of reference boards.
+ *
+ * Usage: zone_fill_benchmark board1.kicad_pcb [board2.kicad_pcb ...]
+ *
+ * All the zones of each board are filled with each ZONE_FILL_ENGINE, one engine
+ * after the other.  For each board and engine, this prints the fill time, the peak
+ * memory used by the fill, the total filled area, and the area of the difference
+ * (XOR) between the areas filled by this engine and by the boost::polygon engine.
+ * The peak memory is measured only on Linux.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <fctsys.h>
+#include <wx/init.h>
+#include <common.h>
+#include <io_mgr.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+
+#include <pcbnew.h>
+#include <zone_fill_engine.h>
+#include <standalone_pgm.h>
+
+
+static const char* engineNames[ZONE_FILL_ENGINE_COUNT] = { "boost", "clipper" };
+
+
+/* Returns the value (in kB) of aKey in /proc/self/status, or -1 if not available
+ */
+static long readProcStatus( const char* aKey )
+{
+    long value = -1;
+
+#if defined( __linux__ )
+    FILE* file = fopen( "/proc/self/status", "r" );
+
+    if( !file )
+        return -1;
+
+    char    line[256];
+    size_t  keyLength = strlen( aKey );
+
+    while( fgets( line, sizeof( line ), file ) )
+    {
+        if( strncmp( line, aKey, keyLength ) == 0 && line[keyLength] == ':' )
+        {
+            value = atol( line + keyLength + 1 );
+            break;
+        }
+    }
+
+    fclose( file );
+#endif
+
+    return value;
+}
+
+
+/* Resets the peak resident memory (VmHWM) of the process to its current value
+ * (Linux 4.0 and newer)
+ */
+static void resetPeakMemory()
+{
+#if defined( __linux__ )
+    FILE* file = fopen( "/proc/self/clear_refs", "w" );
+
+    if( file )
+    {
+        fputs( "5", file );
+        fclose( file );
+    }
+#endif
+}
+
+
+static double filledArea( const CPOLYGONS_LIST& aPolygons )
+{
+    ClipperLib::Paths paths;
+    aPolygons.ExportTo( paths );
+
+    // Holes are linked to their outline, so each contour area is already
+    // the outline area minus the hole areas
+    double area = 0.0;
+
+    for( unsigned ii = 0; ii < paths.size(); ii++ )
+        area += std::fabs( ClipperLib::Area( paths[ii] ) );
+
+    return area;
+}
+
+
+static double differenceArea( const CPOLYGONS_LIST& aFirst, const CPOLYGONS_LIST& aSecond )
+{
+    ClipperLib::Paths first, second, difference;
+    aFirst.ExportTo( first );
+    aSecond.ExportTo( second );
+
+    ClipperLib::Clipper clipper;
+    clipper.AddPaths( first, ClipperLib::ptSubject, true );
+    clipper.AddPaths( second, ClipperLib::ptClip, true );
+    clipper.Execute( ClipperLib::ctXor, difference,
+                     ClipperLib::pftNonZero, ClipperLib::pftNonZero );
+
+    // Holes have a negative area
+    double area = 0.0;
+
+    for( unsigned ii = 0; ii < difference.size(); ii++ )
+        area += ClipperLib::Area( difference[ii] );
+
+    return std::fabs( area );
+}
+
+
+static bool benchmarkBoard( const wxString& aFileName )
+{
+    BOARD* board;
+
+    try
+    {
+        IO_MGR::PCB_FILE_T fileType = aFileName.EndsWith( wxT( ".kicad_pcb" ) ) ?
+                                      IO_MGR::KICAD : IO_MGR::LEGACY;
+
+        board = IO_MGR::Load( fileType, aFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return false;
+    }
+
+    std::vector<ZONE_CONTAINER*> zones;
+
+    for( int ii = 0; ii < board->GetAreaCount(); ii++ )
+    {
+        if( !board->GetArea( ii )->GetIsKeepout() )
+            zones.push_back( board->GetArea( ii ) );
+    }
+
+    // Filled areas of each zone, for each engine
+    std::vector<CPOLYGONS_LIST> filledAreas[ZONE_FILL_ENGINE_COUNT];
+
+    for( int engine = 0; engine < ZONE_FILL_ENGINE_COUNT; engine++ )
+    {
+        g_ZoneFillEngine = engine;
+
+        resetPeakMemory();
+        long memoryBefore = readProcStatus( "VmRSS" );
+
+        unsigned startTime = GetRunningMicroSecs();
+
+        for( unsigned ii = 0; ii < zones.size(); ii++ )
+        {
+            zones[ii]->ClearFilledPolysList();
+            zones[ii]->UnFill();
+            zones[ii]->BuildFilledSolidAreasPolygons( board );
+        }
+
+        unsigned fillTime = GetRunningMicroSecs() - startTime;
+        long memoryPeak = readProcStatus( "VmHWM" );
+
+        double totalArea = 0.0;
+        double totalDifference = 0.0;
+
+        for( unsigned ii = 0; ii < zones.size(); ii++ )
+        {
+            filledAreas[engine].push_back( zones[ii]->GetFilledPolysList() );
+            totalArea += filledArea( filledAreas[engine][ii] );
+
+            if( engine != ZONE_FILL_ENGINE_BOOST )
+                totalDifference += differenceArea( filledAreas[ZONE_FILL_ENGINE_BOOST][ii],
+                                                   filledAreas[engine][ii] );
+        }
+
+        // Areas are in mm2: internal units are nm
+        printf( "%s\t%s\tzones %u\ttime %.3f ms\t",
+                TO_UTF8( aFileName ), engineNames[engine], (unsigned) zones.size(),
+                fillTime / 1000.0 );
+
+        if( memoryBefore >= 0 && memoryPeak >= 0 )
+            printf( "peak memory +%ld kB\t", memoryPeak - memoryBefore );
+        else
+            printf( "peak memory n/a\t" );
+
+        printf( "area %.4f mm2\tdifference %.4f mm2 (%.4f%%)\n",
+                totalArea * 1e-12, totalDifference * 1e-12,
+                totalArea > 0.0 ? 100.0 * totalDifference / totalArea : 0.0 );
+    }
+
+    delete board;
+
+    return true;
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s board.kicad_pcb [board.kicad_pcb ...]\n", argv[0] );
+        return 1;
+    }
+
+    SetLocaleTo_C_standard();
+    InitStandalonePgm();
+
+    int result = 0;
+
+    for( int ii = 1; ii < argc; ii++ )
+    {
+        if( !benchmarkBoard( FROM_UTF8( argv[ii] ) ) )
+            result = 1;
+    }
+
+    return result;
+}
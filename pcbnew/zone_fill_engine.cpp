@@ -0,0 +1,112 @@
+/**
+ * @file zone_fill_engine.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+
+#include <zone_fill_engine.h>
+
+
+ZONE_SOLID_AREAS::ZONE_SOLID_AREAS( ZONE_FILL_ENGINE aEngine ) :
+    m_engine( aEngine )
+{
+}
+
+
+void ZONE_SOLID_AREAS::Import( const CPOLYGONS_LIST& aPolygons, int aMargin )
+{
+    if( m_engine == ZONE_FILL_ENGINE_CLIPPER )
+    {
+        ClipperLib::Paths paths;
+        aPolygons.ExportTo( paths );
+
+        // Holes are linked to their outline by overlapping segments.  Remove these
+        // segments before shrinking, otherwise they would be shrunk like slots.
+        ClipperLib::SimplifyPolygons( paths, ClipperLib::pftNonZero );
+
+        // Mitered corners, like the boost::polygon resizing
+        ClipperLib::ClipperOffset offset;
+        offset.AddPaths( paths, ClipperLib::jtMiter, ClipperLib::etClosedPolygon );
+        offset.Execute( m_clipperAreas, -aMargin );
+    }
+    else
+    {
+        m_boostAreas.clear();
+        aPolygons.ExportTo( m_boostAreas );
+        m_boostAreas -= aMargin;
+    }
+}
+
+
+bool ZONE_SOLID_AREAS::IsEmpty() const
+{
+    if( m_engine == ZONE_FILL_ENGINE_CLIPPER )
+        return m_clipperAreas.ChildCount() == 0;
+
+    return m_boostAreas.size() == 0;
+}
+
+
+void ZONE_SOLID_AREAS::Substract( const CPOLYGONS_LIST& aHoles )
+{
+    if( m_engine == ZONE_FILL_ENGINE_CLIPPER )
+    {
+        ClipperLib::Paths solidAreas;
+        ClipperLib::PolyTreeToPaths( m_clipperAreas, solidAreas );
+
+        ClipperLib::Paths holes;
+        aHoles.ExportTo( holes );
+
+        // Give the same orientation to all holes, so overlapping holes are merged
+        // (and not cancelled) by the non zero fill rule
+        for( unsigned ii = 0; ii < holes.size(); ii++ )
+        {
+            if( !ClipperLib::Orientation( holes[ii] ) )
+                ClipperLib::ReversePath( holes[ii] );
+        }
+
+        ClipperLib::Clipper clipper;
+        clipper.AddPaths( solidAreas, ClipperLib::ptSubject, true );
+        clipper.AddPaths( holes, ClipperLib::ptClip, true );
+        clipper.Execute( ClipperLib::ctDifference, m_clipperAreas,
+                         ClipperLib::pftNonZero, ClipperLib::pftNonZero );
+    }
+    else
+    {
+        KI_POLYGON_SET holes;
+        aHoles.ExportTo( holes );
+        m_boostAreas -= holes;
+    }
+}
+
+
+void ZONE_SOLID_AREAS::Export( CPOLYGONS_LIST& aPolygons )
+{
+    if( m_engine == ZONE_FILL_ENGINE_CLIPPER )
+        aPolygons.ImportFrom( m_clipperAreas );
+    else
+        aPolygons.ImportFrom( m_boostAreas );
+}
@@ -0,0 +1,91 @@
+/**
+ * @file zone_fill_engine.h
+ * @brief Polygon libraries used to calculate the filled areas of zones.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef ZONE_FILL_ENGINE_H
+#define ZONE_FILL_ENGINE_H
+
+#include <PolyLine.h>       // CPOLYGONS_LIST, KI_POLYGON_SET and ClipperLib
+
+
+/// The polygon libraries which can calculate the filled areas of zones
+enum ZONE_FILL_ENGINE
+{
+    ZONE_FILL_ENGINE_BOOST,         ///< boost::polygon (the historical engine)
+    ZONE_FILL_ENGINE_CLIPPER,       ///< Clipper integer offsetting and boolean operations
+    ZONE_FILL_ENGINE_COUNT
+};
+
+
+/**
+ * Class ZONE_SOLID_AREAS
+ * holds the solid areas of a zone while they are calculated, using the polygon
+ * library selected when it is created.
+ * Both libraries give the same areas, except for rounding differences in the
+ * shrunk outlines, and give the result in the same form: holes are linked to
+ * their outline by overlapping segments, as expected in
+ * ZONE_CONTAINER::m_FilledPolysList.
+ */
+class ZONE_SOLID_AREAS
+{
+public:
+    ZONE_SOLID_AREAS( ZONE_FILL_ENGINE aEngine );
+
+    /**
+     * Function Import
+     * replaces the solid areas by \a aPolygons, shrunk by \a aMargin.
+     */
+    void Import( const CPOLYGONS_LIST& aPolygons, int aMargin );
+
+    /**
+     * Function IsEmpty
+     * @return true if there is no solid area.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Function Substract
+     * removes the areas covered by \a aHoles from the solid areas.
+     * The contours of \a aHoles can overlap, and can have any orientation.
+     */
+    void Substract( const CPOLYGONS_LIST& aHoles );
+
+    /**
+     * Function Export
+     * appends the solid areas to \a aPolygons.
+     */
+    void Export( CPOLYGONS_LIST& aPolygons );
+
+private:
+    ZONE_FILL_ENGINE        m_engine;
+
+    KI_POLYGON_SET          m_boostAreas;       // used by ZONE_FILL_ENGINE_BOOST
+
+    ClipperLib::PolyTree    m_clipperAreas;     // used by ZONE_FILL_ENGINE_CLIPPER
+};
+
+#endif  // ZONE_FILL_ENGINE_H
@@ -0,0 +1,273 @@
+/**
+ * @file zone_fill_fingerprint.cpp
+ * @brief Fingerprint of the data used to calculate the filled areas of a zone.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2014 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+#include <common.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_edge_mod.h>
+#include <class_drawsegment.h>
+#include <class_pcb_text.h>
+#include <class_zone.h>
+
+#include <pcbnew.h>
+#include <zones.h>
+
+
+/* Helper class to build a 64 bits FNV-1a hash from a sequence of values
+ */
+class FILL_FINGERPRINT
+{
+public:
+    FILL_FINGERPRINT() : m_hash( 14695981039346656037ULL ) {}
+
+    void Add( int aValue )
+    {
+        unsigned value = aValue;
+
+        for( int ii = 0; ii < 4; ii++ )
+        {
+            m_hash ^= value & 0xFF;
+            m_hash *= 1099511628211ULL;
+            value >>= 8;
+        }
+    }
+
+    void Add( double aValue )           { Add( KiROUND( aValue * 1000.0 ) ); }
+    void Add( const wxPoint& aPoint )   { Add( aPoint.x ); Add( aPoint.y ); }
+    void Add( const wxSize& aSize )     { Add( aSize.x ); Add( aSize.y ); }
+
+    // The net codes are renumbered when the board is saved, so the nets are
+    // identified by their names
+    void Add( const wxString& aText )
+    {
+        std::string text = TO_UTF8( aText );
+
+        Add( (int) text.size() );
+
+        for( unsigned ii = 0; ii < text.size(); ii++ )
+        {
+            m_hash ^= (unsigned char) text[ii];
+            m_hash *= 1099511628211ULL;
+        }
+    }
+
+    void Add( const EDA_RECT& aRect )
+    {
+        Add( aRect.GetPosition() );
+        Add( aRect.GetSize() );
+    }
+
+    void Add( const CPOLYGONS_LIST& aPolygons )
+    {
+        Add( (int) aPolygons.GetCornersCount() );
+
+        for( unsigned ii = 0; ii < aPolygons.GetCornersCount(); ii++ )
+        {
+            Add( aPolygons.GetX( ii ) );
+            Add( aPolygons.GetY( ii ) );
+            Add( (int) aPolygons.IsEndContour( ii ) );
+        }
+    }
+
+    void Add( const DRAWSEGMENT* aSegment )
+    {
+        Add( (int) aSegment->Type() );
+        Add( (int) aSegment->GetShape() );
+        Add( (int) aSegment->GetLayer() );
+        Add( aSegment->GetStart() );
+        Add( aSegment->GetEnd() );
+        Add( aSegment->GetWidth() );
+        Add( aSegment->GetAngle() );
+        Add( aSegment->GetBoundingBox() );
+    }
+
+    unsigned long long GetValue() const
+    {
+        // 0 is reserved to "no fingerprint"
+        return m_hash ? m_hash : 1;
+    }
+
+private:
+    unsigned long long m_hash;
+};
+
+
+/* The items used here, and the way they are selected, follow the items used in
+ * AddClearanceAreasPolygonsToPolysList(), TestForCopperIslandAndRemoveInsulatedIslands()
+ * and BuildUnconnectedThermalStubsPolygonList(), but with a bigger area, so a change
+ * which can modify the filled areas always modifies the fingerprint.
+ */
+unsigned long long ZONE_CONTAINER::BuildFillFingerprint( BOARD* aPcb ) const
+{
+    FILL_FINGERPRINT fingerprint;
+
+    // The zone itself
+    fingerprint.Add( (int) GetLayer() );
+    fingerprint.Add( GetNetname() );
+    fingerprint.Add( (int) m_priority );
+    fingerprint.Add( m_Poly->m_CornersList );
+    fingerprint.Add( m_cornerSmoothingType );
+    fingerprint.Add( (int) m_cornerRadius );
+    fingerprint.Add( (int) m_PadConnection );
+    fingerprint.Add( m_ZoneClearance );
+    fingerprint.Add( GetClearance() );
+    fingerprint.Add( m_ZoneMinThickness );
+    fingerprint.Add( m_ArcToSegmentsCount );
+    fingerprint.Add( m_ThermalReliefGap );
+    fingerprint.Add( m_ThermalReliefCopperBridge );
+    fingerprint.Add( m_FillMode );
+    fingerprint.Add( g_ZoneFillEngine );
+
+    int biggest_clearance = aPcb->GetBiggestClearanceValue();
+    fingerprint.Add( biggest_clearance );
+
+    int margin = m_ZoneMinThickness / 2;
+    int zone_clearance = std::max( m_ZoneClearance, GetClearance() ) + margin;
+
+    EDA_RECT zone_boundingbox = GetBoundingBox();
+    zone_boundingbox.Inflate( std::max( biggest_clearance, zone_clearance ) + margin );
+
+    EDA_RECT item_boundingbox;
+
+    // Pads (including pads on other layers, which can have a hole)
+    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad != NULL; pad = pad->Next() )
+        {
+            int padClearance = std::max( pad->GetClearance(), GetThermalReliefGap( pad ) );
+
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( padClearance + margin );
+
+            if( !item_boundingbox.Intersects( zone_boundingbox ) )
+                continue;
+
+            fingerprint.Add( (int) pad->Type() );
+            fingerprint.Add( pad->GetPosition() );
+            fingerprint.Add( pad->GetSize() );
+            fingerprint.Add( pad->GetDelta() );
+            fingerprint.Add( pad->GetOffset() );
+            fingerprint.Add( (int) pad->GetShape() );
+            fingerprint.Add( pad->GetOrientation() );
+            fingerprint.Add( pad->GetDrillSize() );
+            fingerprint.Add( (int) pad->GetDrillShape() );
+            fingerprint.Add( (int) pad->GetLayerMask() );
+            fingerprint.Add( (int) pad->GetAttribute() );
+            fingerprint.Add( pad->GetNetname() );
+            fingerprint.Add( pad->GetClearance() );
+            fingerprint.Add( (int) GetPadConnection( pad ) );
+            fingerprint.Add( GetThermalReliefGap( pad ) );
+            fingerprint.Add( GetThermalReliefCopperBridge( pad ) );
+        }
+
+        // Module edges on copper layers
+        for( BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+        {
+            if( item->Type() != PCB_MODULE_EDGE_T || !item->IsOnLayer( GetLayer() ) )
+                continue;
+
+            if( item->GetBoundingBox().Intersects( zone_boundingbox ) )
+                fingerprint.Add( (DRAWSEGMENT*) item );
+        }
+    }
+
+    // Tracks and vias
+    for( TRACK* track = aPcb->m_Track; track; track = track->Next() )
+    {
+        if( !track->IsOnLayer( GetLayer() ) )
+            continue;
+
+        item_boundingbox = track->GetBoundingBox();
+        item_boundingbox.Inflate( track->GetClearance() + margin );
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        fingerprint.Add( (int) track->Type() );
+        fingerprint.Add( track->GetStart() );
+        fingerprint.Add( track->GetEnd() );
+        fingerprint.Add( track->GetWidth() );
+        fingerprint.Add( (int) track->GetLayerMask() );
+        fingerprint.Add( track->GetNetname() );
+        fingerprint.Add( track->GetClearance() );
+    }
+
+    // Graphic items on this layer and board edges (used without area test)
+    for( BOARD_ITEM* item = aPcb->m_Drawings; item; item = item->Next() )
+    {
+        if( item->GetLayer() != GetLayer() && item->GetLayer() != EDGE_N )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            fingerprint.Add( (DRAWSEGMENT*) item );
+            break;
+
+        case PCB_TEXT_T:
+            {
+                TEXTE_PCB* text = (TEXTE_PCB*) item;
+
+                fingerprint.Add( (int) text->GetLayer() );
+                fingerprint.Add( text->GetTextPosition() );
+                fingerprint.Add( text->GetOrientation() );
+                fingerprint.Add( text->GetTextBox( -1 ) );
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Other zones on this layer: keepouts and zones with an higher priority
+    for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* zone = aPcb->GetArea( ii );
+
+        if( zone == this || zone->GetLayer() != GetLayer() )
+            continue;
+
+        if( !zone->GetBoundingBox().Intersects( zone_boundingbox ) )
+            continue;
+
+        fingerprint.Add( (int) zone->GetIsKeepout() );
+        fingerprint.Add( (int) zone->GetDoNotAllowCopperPour() );
+        fingerprint.Add( (int) zone->GetPriority() );
+        fingerprint.Add( zone->GetNetname() );
+        fingerprint.Add( zone->GetClearance() );
+        fingerprint.Add( zone->GetCornerSmoothingType() );
+        fingerprint.Add( (int) zone->GetCornerRadius() );
+        fingerprint.Add( zone->Outline()->m_CornersList );
+    }
+
+    return fingerprint.GetValue();
+}
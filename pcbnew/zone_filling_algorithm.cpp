@@ -33,10 +33,13 @@
 #include <trigo.h>
 #include <wxPcbStruct.h>
 
+#include <class_board.h>
+#include <class_module.h>
 #include <class_zone.h>
 
 #include <pcbnew.h>
 #include <zones.h>
+#include <zone_fill_engine.h>
 
 /* Build the filled solid areas data from real outlines (stored in m_Poly)
  * The solid areas can be more than one on copper layers, and do not have holes
@@ -69,32 +72,38 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb,
         return 0;
 
     // Make a smoothed polygon out of the user-drawn polygon if required
-    if( m_smoothedPoly )
-    {
-        delete m_smoothedPoly;
-        m_smoothedPoly = NULL;
-    }
+    CPolyLine* smoothedPoly;
 
     switch( m_cornerSmoothingType )
     {
     case ZONE_SETTINGS::SMOOTHING_CHAMFER:
-        m_smoothedPoly = m_Poly->Chamfer( m_cornerRadius );
+        smoothedPoly = m_Poly->Chamfer( m_cornerRadius );
         break;
     case ZONE_SETTINGS::SMOOTHING_FILLET:
-        m_smoothedPoly = m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
+        smoothedPoly = m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
         break;
     default:
-        m_smoothedPoly = new CPolyLine;
-        m_smoothedPoly->Copy( m_Poly );
+        smoothedPoly = new CPolyLine;
+        smoothedPoly->Copy( m_Poly );
         break;
     }
 
     if( aCornerBuffer )
-        ConvertPolysListWithHolesToOnePolygon( m_smoothedPoly->m_CornersList,
+    {
+        // Only the outlines are wanted: this zone is left unchanged, because
+        // other zones can call this function while this zone is being filled
+        ConvertPolysListWithHolesToOnePolygon( smoothedPoly->m_CornersList,
                                                *aCornerBuffer );
+        delete smoothedPoly;
+    }
     else
+    {
+        delete m_smoothedPoly;
+        m_smoothedPoly = smoothedPoly;
+
         ConvertPolysListWithHolesToOnePolygon( m_smoothedPoly->m_CornersList,
                                                m_FilledPolysList );
+    }
 
     /* For copper layers, we now must add holes in the Polygon list.
      * holes are pads and tracks with their clearance area
@@ -107,8 +116,8 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb,
             AddClearanceAreasPolygonsToPolysList( aPcb );
         else
         {
-            // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
-            KI_POLYGON_SET polyset_zone_solid_areas;
+            // This is the area(s) to fill, with m_ZoneMinThickness/2
+            ZONE_SOLID_AREAS zone_solid_areas( (ZONE_FILL_ENGINE) g_ZoneFillEngine );
             int         margin = m_ZoneMinThickness / 2;
 
             /* First, creates the main polygon (i.e. the filled area using only one outline)
@@ -116,13 +125,12 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb,
              * this margin is the room to redraw outlines with segments having a width set to
              * m_ZoneMinThickness
              * so m_ZoneMinThickness is the min thickness of the filled zones areas
-             * the polygon is stored in polyset_zone_solid_areas
+             * the polygon is stored in zone_solid_areas
              */
-            CopyPolygonsFromFilledPolysListToKiPolygonList( polyset_zone_solid_areas );
-            polyset_zone_solid_areas -= margin;
+            zone_solid_areas.Import( m_FilledPolysList, margin );
             // put solid area in m_FilledPolysList:
             m_FilledPolysList.RemoveAllContours();
-            CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
+            zone_solid_areas.Export( m_FilledPolysList );
         }
         if ( m_FillMode )   // if fill mode uses segments, create them:
             FillZoneAreasWithSegments( );
@@ -132,6 +140,63 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb,
 }
 
 
+int BOARD::FillZones( ZONE_CONTAINER* const* aZones, int aCount )
+{
+    int refilledCount = 0;
+
+    // D_PAD::GetBoundingRadius() computes the radius on its first call and stores it.
+    // The fills read it from all the threads, so it is computed here first.
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            pad->GetBoundingRadius();
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:refilledCount)
+#endif
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        ZONE_CONTAINER* zone = aZones[ii];
+        unsigned long long fingerprint = zone->BuildFillFingerprint( this );
+
+        if( fingerprint != zone->GetFillFingerprint() )
+        {
+            zone->ClearFilledPolysList();
+            zone->UnFill();
+            zone->BuildFilledSolidAreasPolygons( this );
+            zone->SetFillFingerprint( fingerprint );
+            refilledCount++;
+        }
+    }
+
+    return refilledCount;
+}
+
+
+int BOARD::FillAllZones()
+{
+    // Remove segment zones
+    m_Zone.DeleteAll();
+
+    std::vector<ZONE_CONTAINER*> zones;
+
+    for( int ii = 0; ii < GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* zone = GetArea( ii );
+
+        // Cannot fill keepout zones:
+        if( !zone->GetIsKeepout() )
+            zones.push_back( zone );
+    }
+
+    if( zones.empty() )
+        return 0;
+
+    return FillZones( &zones[0], zones.size() );
+}
+
+
 // Sort function to build filled zones
 static bool SortByXValues( const int& a, const int &b)
 {
@@ -26,6 +26,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
 #include <wx/progdlg.h>
 
 #include <fctsys.h>
@@ -41,6 +42,10 @@
 #include <pcbnew.h>
 #include <zones.h>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 #define FORMAT_STRING _( "Filling zone %d out of %d (net %s)..." )
 
 
@@ -87,12 +92,23 @@ void PCB_EDIT_FRAME::Delete_OldZone_Fill( SEGZONE* aZone, time_t aTimestamp )
 
 int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
 {
-    aZone->ClearFilledPolysList();
-    aZone->UnFill();
-
     // Cannot fill keepout zones:
     if( aZone->GetIsKeepout() )
+    {
+        aZone->ClearFilledPolysList();
+        aZone->UnFill();
         return 1;
+    }
+
+    // Nothing which can modify the filled areas was changed since the last fill:
+    // keep the current filled areas
+    unsigned long long fingerprint = aZone->BuildFillFingerprint( GetBoard() );
+
+    if( fingerprint == aZone->GetFillFingerprint() )
+        return 0;
+
+    aZone->ClearFilledPolysList();
+    aZone->UnFill();
 
     wxString msg;
 
@@ -113,6 +129,7 @@ int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
     wxBusyCursor dummy;     // Shows an hourglass cursor (removed by its destructor)
 
     aZone->BuildFilledSolidAreasPolygons( GetBoard() );
+    aZone->SetFillFingerprint( fingerprint );
 
     OnModify();
 
@@ -120,9 +137,8 @@ int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
 }
 
 
-int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
+void PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow )
 {
-    int errorLevel = 0;
     int areaCount = GetBoard()->GetAreaCount();
     wxBusyCursor dummyCursor;
     wxString msg;
@@ -142,35 +158,55 @@ int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
     // Remove segment zones
     GetBoard()->m_Zone.DeleteAll();
 
-    int ii;
+    std::vector<ZONE_CONTAINER*> zones;
 
-    for( ii = 0; ii < areaCount; ii++ )
+    for( int ii = 0; ii < areaCount; ii++ )
     {
         ZONE_CONTAINER* zoneContainer = GetBoard()->GetArea( ii );
-        if( zoneContainer->GetIsKeepout() )
-            continue;
 
-        msg.Printf( FORMAT_STRING, ii + 1, areaCount, GetChars( zoneContainer->GetNetname() ) );
+        // Cannot fill keepout zones:
+        if( !zoneContainer->GetIsKeepout() )
+            zones.push_back( zoneContainer );
+    }
+
+    int zoneCount = zones.size();
+    int refilledCount = 0;
+
+    // The progress dialog can be updated only by this thread, and not while the
+    // zones are filled (it processes the paint events, which read the board).
+    // So the zones are filled in batches of one zone per thread, and the progress
+    // is shown between the batches.
+    int batchSize = 1;
+
+#ifdef USE_OPENMP
+    batchSize = omp_get_max_threads();
+#endif
+
+    for( int first = 0; first < zoneCount; first += batchSize )
+    {
+        int count = std::min( batchSize, zoneCount - first );
 
         if( progressDialog )
         {
-            if( !progressDialog->Update( ii+1, msg ) )
+            msg.Printf( FORMAT_STRING, first + 1, zoneCount,
+                        GetChars( zones[first]->GetNetname() ) );
+
+            if( !progressDialog->Update( first + 1, msg ) )
                 break;  // Aborted by user
         }
 
-        errorLevel = Fill_Zone( zoneContainer );
-
-        if( errorLevel && !aVerbose )
-            break;
+        refilledCount += GetBoard()->FillZones( &zones[first], count );
     }
 
+    if( refilledCount )
+        OnModify();
+
     if( progressDialog )
-        progressDialog->Update( ii+2, _( "Updating ratsnest..." ) );
+        progressDialog->Update( areaCount+2, _( "Updating ratsnest..." ) );
     TestConnections();
 
     // Recalculate the active ratsnest, i.e. the unconnected links
     TestForActiveLinksInRatsnest( 0 );
     if( progressDialog )
         progressDialog->Destroy();
-    return errorLevel;
 }
@@ -62,6 +62,7 @@
 #include <pcbnew.h>
 #include <zones.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <zone_fill_engine.h>
 
 
 extern void BuildUnconnectedThermalStubsPolygonList( CPOLYGONS_LIST& aCornerBuffer,
@@ -82,17 +83,7 @@ extern void CreateThermalReliefPadPolygon( CPOLYGONS_LIST& aCornerBuffer,
                                            double                aThermalRot );
 
 // Local Variables:
-static double s_thermalRot = 450;  // angle of stubs in thermal reliefs for round pads
-
-// how many segments are used to create a polygon from a circle:
-static int s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;   /* default value. the real value will be changed to
-                                                                           * ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF
-                                                                           * if m_ArcToSegmentsCount == ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF
-                                                                           */
-double s_Correction;     /* mult coeff used to enlarge rounded and oval pads (and vias)
-                          * because the segment approximation for arcs and circles
-                          * create a smaller gap than a true circle
-                          */
+static const double s_thermalRot = 450;  // angle of stubs in thermal reliefs for round pads
 
 /**
  * Function AddClearanceAreasPolygonsToPolysList
@@ -125,21 +116,29 @@ double s_Correction;     /* mult coeff used to enlarge rounded and oval pads (an
  */
 void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
 {
+    // Note: this function is called for several zones at the same time by
+    // PCB_EDIT_FRAME::Fill_All_Zones(), so it must not use static or global
+    // variables, nor modify other items than this zone.
+
     // Set the number of segments in arc approximations
+    int segsPerCircle;
+
     if( m_ArcToSegmentsCount == ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF  )
-        s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF;
+        segsPerCircle = ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF;
     else
-        s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;
+        segsPerCircle = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;
 
     /* calculates the coeff to compensate radius reduction of holes clearance
      * due to the segment approx.
-     * For a circle the min radius is radius * cos( 2PI / s_CircleToSegmentsCount / 2)
-     * s_Correction is 1 /cos( PI/s_CircleToSegmentsCount  )
+     * For a circle the min radius is radius * cos( 2PI / segsPerCircle / 2)
+     * correctionFactor is 1 /cos( PI/segsPerCircle  )
+     * it is used to enlarge rounded and oval pads (and vias) because the segment
+     * approximation for arcs and circles create a smaller gap than a true circle
      */
-    s_Correction = 1.0 / cos( M_PI / s_CircleToSegmentsCount );
+    double correctionFactor = 1.0 / cos( M_PI / segsPerCircle );
 
-    // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
-    KI_POLYGON_SET polyset_zone_solid_areas;
+    // This is the area(s) to fill, with m_ZoneMinThickness/2
+    ZONE_SOLID_AREAS zone_solid_areas( (ZONE_FILL_ENGINE) g_ZoneFillEngine );
     int         margin = m_ZoneMinThickness / 2;
 
     /* First, creates the main polygon (i.e. the filled area using only one outline)
@@ -147,13 +146,12 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
      * this margin is the room to redraw outlines with segments having a width set to
      * m_ZoneMinThickness
      * so m_ZoneMinThickness is the min thickness of the filled zones areas
-     * the main polygon is stored in polyset_zone_solid_areas
+     * the main polygon is stored in zone_solid_areas
      */
 
-    CopyPolygonsFromFilledPolysListToKiPolygonList( polyset_zone_solid_areas );
-    polyset_zone_solid_areas -= margin;
+    zone_solid_areas.Import( m_FilledPolysList, margin );
 
-    if( polyset_zone_solid_areas.size() == 0 )
+    if( zone_solid_areas.IsEmpty() )
         return;
 
     /* Calculates the clearance value that meet DRC requirements
@@ -186,9 +184,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
      */
     int item_clearance;
 
-    // static to avoid unnecessary memory allocation when filling many zones.
-    static CPOLYGONS_LIST cornerBufferPolysToSubstract;
-    cornerBufferPolysToSubstract.RemoveAllContours();
+    CPOLYGONS_LIST cornerBufferPolysToSubstract;
 
     /* Use a dummy pad to calculate hole clerance when a pad is not on all copper layers
      * and this pad has a hole
@@ -239,8 +235,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                     int clearance = std::max( zone_clearance, item_clearance );
                     pad->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                                clearance,
-                                                               s_CircleToSegmentsCount,
-                                                               s_Correction );
+                                                               segsPerCircle,
+                                                               correctionFactor );
                 }
 
                 continue;
@@ -260,8 +256,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                 {
                     pad->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                                gap,
-                                                               s_CircleToSegmentsCount,
-                                                               s_Correction );
+                                                               segsPerCircle,
+                                                               correctionFactor );
                 }
             }
         }
@@ -286,8 +282,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
             int clearance = std::max( zone_clearance, item_clearance );
             track->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                          clearance,
-                                                         s_CircleToSegmentsCount,
-                                                         s_Correction );
+                                                         segsPerCircle,
+                                                         correctionFactor );
         }
     }
 
@@ -311,7 +307,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
             {
                 ( (EDGE_MODULE*) item )->TransformShapeWithClearanceToPolygon(
                     cornerBufferPolysToSubstract, zone_clearance,
-                    s_CircleToSegmentsCount, s_Correction );
+                    segsPerCircle, correctionFactor );
             }
         }
     }
@@ -327,7 +323,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
         case PCB_LINE_T:
             ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
                 cornerBufferPolysToSubstract,
-                zone_clearance, s_CircleToSegmentsCount, s_Correction );
+                zone_clearance, segsPerCircle, correctionFactor );
             break;
 
         case PCB_TEXT_T:
@@ -406,26 +402,24 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                                                *pad, thermalGap,
                                                GetThermalReliefCopperBridge( pad ),
                                                m_ZoneMinThickness,
-                                               s_CircleToSegmentsCount,
-                                               s_Correction, s_thermalRot );
+                                               segsPerCircle,
+                                               correctionFactor, s_thermalRot );
             }
         }
     }
 
     // cornerBufferPolysToSubstract contains polygons to substract.
-    // polyset_zone_solid_areas contains the main filled area
+    // zone_solid_areas contains the main filled area
     // Calculate now actual solid areas
     if( cornerBufferPolysToSubstract.GetCornersCount() > 0 )
     {
-        KI_POLYGON_SET polyset_holes;
-        cornerBufferPolysToSubstract.ExportTo( polyset_holes );
         // Remove holes from initial area.:
-        polyset_zone_solid_areas -= polyset_holes;
+        zone_solid_areas.Substract( cornerBufferPolysToSubstract );
     }
 
     // put solid areas in m_FilledPolysList:
     m_FilledPolysList.RemoveAllContours();
-    CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
+    zone_solid_areas.Export( m_FilledPolysList );
 
     // Remove insulated islands:
     if( GetNetCode() > 0 )
@@ -438,20 +432,17 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
     // (this is a refinement for thermal relief shapes)
     if( GetNetCode() > 0 )
         BuildUnconnectedThermalStubsPolygonList( cornerBufferPolysToSubstract, aPcb, this,
-                                                 s_Correction, s_thermalRot );
+                                                 correctionFactor, s_thermalRot );
 
     // remove copper areas corresponding to not connected stubs
     if( cornerBufferPolysToSubstract.GetCornersCount() )
     {
-        KI_POLYGON_SET polyset_holes;
-        cornerBufferPolysToSubstract.ExportTo( polyset_holes );
-
         // Remove unconnected stubs
-        polyset_zone_solid_areas -= polyset_holes;
+        zone_solid_areas.Substract( cornerBufferPolysToSubstract );
 
         // put these areas in m_FilledPolysList
         m_FilledPolysList.RemoveAllContours();
-        CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
+        zone_solid_areas.Export( m_FilledPolysList );
 
         if( GetNetCode() > 0 )
             TestForCopperIslandAndRemoveInsulatedIslands( aPcb );
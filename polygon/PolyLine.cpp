@@ -1273,7 +1273,7 @@ void CPOLYGONS_LIST::ExportTo( KI_POLYGON_WITH_HOLES& aPolygoneWithHole )
  * Each contour is copied into a KI_POLYGON, and each KI_POLYGON
  * is append to aPolygons
  */
-void CPOLYGONS_LIST::ExportTo( KI_POLYGON_SET& aPolygons )
+void CPOLYGONS_LIST::ExportTo( KI_POLYGON_SET& aPolygons ) const
 {
     std::vector<KI_POLY_POINT> cornerslist;
     unsigned    corners_count = GetCornersCount();
@@ -1336,6 +1336,168 @@ void CPOLYGONS_LIST::ImportFrom( KI_POLYGON_SET& aPolygons )
 
 
 
+/**
+ * Copy all contours to a ClipperLib::Paths aPolygons
+ * Each contour is copied into a ClipperLib::Path
+ */
+void CPOLYGONS_LIST::ExportTo( ClipperLib::Paths& aPolygons ) const
+{
+    ClipperLib::Path path;
+
+    for( unsigned ii = 0; ii < GetCornersCount(); ii++ )
+    {
+        path.push_back( ClipperLib::IntPoint( GetX( ii ), GetY( ii ) ) );
+
+        if( IsEndContour( ii ) )
+        {
+            aPolygons.push_back( path );
+            path.clear();
+        }
+    }
+}
+
+
+/* Helper function for CPOLYGONS_LIST::ImportFrom( ClipperLib::PolyTree& ):
+ * links aHole to aOutline by an horizontal overlapping segment, starting at the
+ * leftmost corner of the hole, and going to the left up to the first segment of
+ * aOutline.
+ * Holes must be linked by increasing x of their leftmost corner: the overlapping
+ * segment of a hole can only reach the outline or a hole already linked.
+ */
+static void linkHoleToOutline( ClipperLib::Path& aOutline, const ClipperLib::Path& aHole )
+{
+    unsigned start = 0;
+
+    for( unsigned ii = 1; ii < aHole.size(); ii++ )
+    {
+        if( aHole[ii].X < aHole[start].X
+          || ( aHole[ii].X == aHole[start].X && aHole[ii].Y < aHole[start].Y ) )
+            start = ii;
+    }
+
+    const ClipperLib::IntPoint& holeCorner = aHole[start];
+    unsigned            count   = aOutline.size();
+    int                 segment = -1;
+    ClipperLib::cInt    bridgeX = 0;
+
+    for( unsigned ii = 0; ii < count; ii++ )
+    {
+        const ClipperLib::IntPoint& segStart = aOutline[ii];
+        const ClipperLib::IntPoint& segEnd   = aOutline[ (ii + 1) % count ];
+
+        // Horizontal segments are reached by their ends
+        if( segStart.Y == segEnd.Y )
+            continue;
+
+        if( holeCorner.Y < std::min( segStart.Y, segEnd.Y )
+          || holeCorner.Y > std::max( segStart.Y, segEnd.Y ) )
+            continue;
+
+        ClipperLib::cInt x = segStart.X + KiROUND( double( holeCorner.Y - segStart.Y ) *
+                                                   ( segEnd.X - segStart.X ) /
+                                                   ( segEnd.Y - segStart.Y ) );
+
+        if( x > holeCorner.X )
+            continue;
+
+        if( segment < 0 || x > bridgeX )
+        {
+            segment = ii;
+            bridgeX = x;
+        }
+    }
+
+    // A hole is always inside its outline, so this should not happen
+    wxASSERT( segment >= 0 );
+
+    if( segment < 0 )
+        return;
+
+    ClipperLib::IntPoint bridge( bridgeX, holeCorner.Y );
+    unsigned corner   = segment;
+    bool     onCorner = true;
+
+    if( bridge == aOutline[ (segment + 1) % count ] )
+        corner = (segment + 1) % count;
+    else if( !( bridge == aOutline[segment] ) )
+        onCorner = false;
+
+    ClipperLib::Path linked;
+    linked.reserve( count + aHole.size() + 4 );
+    linked.insert( linked.end(), aOutline.begin(), aOutline.begin() + corner + 1 );
+
+    if( !onCorner )
+        linked.push_back( bridge );
+
+    for( unsigned ii = 0; ii <= aHole.size(); ii++ )
+        linked.push_back( aHole[ (start + ii) % aHole.size() ] );
+
+    linked.push_back( onCorner ? aOutline[corner] : bridge );
+    linked.insert( linked.end(), aOutline.begin() + corner + 1, aOutline.end() );
+
+    aOutline.swap( linked );
+}
+
+
+static bool sortByLeftmostCorner( const std::pair<ClipperLib::cInt, unsigned>& a,
+                                  const std::pair<ClipperLib::cInt, unsigned>& b )
+{
+    return a.first < b.first;
+}
+
+
+/* Imports all polygons found in a ClipperLib::PolyTree in list
+ * Holes are linked to their outline, and outlines found inside holes
+ * are imported as separate contours.
+ */
+void CPOLYGONS_LIST::ImportFrom( const ClipperLib::PolyTree& aPolygons )
+{
+    std::vector<const ClipperLib::PolyNode*> outlines( aPolygons.Childs.begin(),
+                                                       aPolygons.Childs.end() );
+    std::vector< std::pair<ClipperLib::cInt, unsigned> > holes;
+
+    for( unsigned ii = 0; ii < outlines.size(); ii++ )
+    {
+        const ClipperLib::PolyNode* outline = outlines[ii];
+        ClipperLib::Path            contour = outline->Contour;
+
+        // Sort holes by the x coordinate of their leftmost corner
+        holes.clear();
+
+        for( unsigned jj = 0; jj < outline->Childs.size(); jj++ )
+        {
+            const ClipperLib::Path& hole = outline->Childs[jj]->Contour;
+            ClipperLib::cInt        xmin = hole[0].X;
+
+            for( unsigned kk = 1; kk < hole.size(); kk++ )
+                xmin = std::min( xmin, hole[kk].X );
+
+            holes.push_back( std::make_pair( xmin, jj ) );
+        }
+
+        std::stable_sort( holes.begin(), holes.end(), sortByLeftmostCorner );
+
+        for( unsigned jj = 0; jj < holes.size(); jj++ )
+        {
+            const ClipperLib::PolyNode* hole = outline->Childs[ holes[jj].second ];
+
+            linkHoleToOutline( contour, hole->Contour );
+
+            // Islands inside this hole
+            outlines.insert( outlines.end(), hole->Childs.begin(), hole->Childs.end() );
+        }
+
+        if( contour.size() < 3 )
+            continue;
+
+        for( unsigned jj = 0; jj < contour.size(); jj++ )
+            AddCorner( CPolyPt( (int) contour[jj].X, (int) contour[jj].Y ) );
+
+        CloseLastContour();
+    }
+}
+
+
 /**
  * Function ConvertPolysListWithHolesToOnePolygon
  * converts the outline contours aPolysListWithHoles with holes to one polygon
@@ -21,6 +21,7 @@
 #include <wx/gdicmn.h>      // for wxPoint definition
 #include <layers_id_colors_and_visibility.h>
 #include <polygons_defs.h>
+#include <clipper.hpp>
 
 class CRect
 {
@@ -164,7 +165,7 @@ public:
      * Copy all contours to a KI_POLYGON_SET
      * @param aPolygons = the KI_POLYGON_WITH_HOLES to populate
      */
-    void    ExportTo( KI_POLYGON_SET& aPolygons );
+    void    ExportTo( KI_POLYGON_SET& aPolygons ) const;
 
     /**
      * Function ExportTo
@@ -181,6 +182,23 @@ public:
      */
     void    ImportFrom( KI_POLYGON_SET& aPolygons );
 
+    /**
+     * Function ExportTo
+     * Copy all contours to a ClipperLib::Paths, one path by contour
+     * @param aPolygons = the ClipperLib::Paths to populate
+     */
+    void    ExportTo( ClipperLib::Paths& aPolygons ) const;
+
+    /**
+     * Function ImportFrom
+     * Copy all polygons from a ClipperLib::PolyTree in list.
+     * Each outline is imported with its holes as only one contour: like in the
+     * polygons created by boost::polygon, holes are linked to the outline
+     * by overlapping segments.
+     * @param aPolygons = the ClipperLib::PolyTree to import
+     */
+    void    ImportFrom( const ClipperLib::PolyTree& aPolygons );
+
     /**
      * function AddCorner
      * add a corner to the list
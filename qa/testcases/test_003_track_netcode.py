@@ -0,0 +1,50 @@
+import code
+import unittest
+import pcbnew
+import pdb
+
+from pcbnew import *
+
+class TestTrackNetcode(unittest.TestCase):
+
+    def setUp(self):
+        self.pcb = LoadBoard("data/complex_hierarchy.kicad_pcb")
+        self.pad = self.pcb.FindModule('P1').FindPadByName('1')
+
+    def add_track(self, start, end):
+        track = TRACK(self.pcb)
+        track.SetStart(start)
+        track.SetEnd(end)
+        track.SetWidth(FromMM(0.25))
+        self.pcb.Add(track)
+        return track
+
+    def test_cluster_connected_to_pad(self):
+        # Far from the board items, except the pad the first segment starts on
+        start = self.pad.GetPosition()
+        corner = start + wxPointMM(0, -100)
+
+        track0 = self.add_track(start, corner)
+        track1 = self.add_track(corner, corner + wxPointMM(-50, 0))
+
+        RecalculateAllTracksNetcode(self.pcb)
+
+        self.assertNotEqual(self.pad.GetNetCode(), 0)
+        self.assertEqual(track0.GetNetCode(), self.pad.GetNetCode())
+        self.assertEqual(track1.GetNetCode(), self.pad.GetNetCode())
+
+    def test_cluster_without_pad(self):
+        # Connected to each other, but to no pad
+        track0 = self.add_track(wxPointMM(-200, -200), wxPointMM(-150, -200))
+        track1 = self.add_track(wxPointMM(-150, -200), wxPointMM(-150, -150))
+
+        RecalculateAllTracksNetcode(self.pcb)
+
+        self.assertEqual(track0.GetNetCode(), 0)
+        self.assertEqual(track1.GetNetCode(), 0)
+
+    #def test_interactive(self):
+    #	code.interact(local=locals())
+
+if __name__ == '__main__':
+    unittest.main()
@@ -6,6 +6,11 @@
     that an int can hold, and converts to ASCII and back and verifies integrity
     of the round tripped value.
 
+    The values are read back with strtod(), as in the original PCB_PARSER, and with
+    the fixed point parser of decimal_parser.h which PCB_PARSER now uses.  The
+    double parser of decimal_parser.h is also checked against strtod(), and the
+    integer formatter of decimal_parser.h against biuFmt().
+
     Author: Dick Hollenbeck
 */
 
@@ -18,6 +23,8 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <decimal_parser.h>
+
 
 static inline int KiROUND( double v )
 {
@@ -67,9 +74,37 @@ int parseBIU( const char* s )
 }
 
 
+int parseBIUFixed( const std::string& s )
+{
+    int r;
+
+    if( !ParseMillimetresToNanometres( s.data(), s.data() + s.size(), &r ) )
+    {
+        printf( "ParseMillimetresToNanometres failed on %s\n", s.c_str() );
+        return INT_MIN;
+    }
+
+    return r;
+}
+
+
+bool sameAsStrtod( const std::string& s )
+{
+    double d;
+
+    if( !ParseDecimalDouble( s.data(), s.data() + s.size(), &d ) )
+        return false;
+
+    return d == strtod( s.c_str(), NULL );
+}
+
+
 int main( int argc, char** argv )
 {
     unsigned mismatches = 0;
+    unsigned fixedMismatches = 0;
+    unsigned doubleMismatches = 0;
+    unsigned formatMismatches = 0;
 
     if( argc > 1 )
     {
@@ -83,6 +118,8 @@ int main( int argc, char** argv )
 
         printf( "%s: s:%s\n", __func__, s.c_str() );
 
+        printf( "%s: fixed point parser:%d\n", __func__, parseBIUFixed( s ) );
+
         exit(0);
     }
 
@@ -106,6 +143,30 @@ int main( int argc, char** argv )
             ++mismatches;
         }
 
+        int f = parseBIUFixed( s );
+
+        if( f != i )
+        {
+            printf( "i:%d  biuFmt:%s  fixed point:%d\n", i, s.c_str(), f );
+            ++fixedMismatches;
+        }
+
+        if( !sameAsStrtod( s ) )
+        {
+            printf( "i:%d  biuFmt:%s  ParseDecimalDouble differs from strtod\n", i, s.c_str() );
+            ++doubleMismatches;
+        }
+
+        char formatted[FORMAT_MILLIMETRES_MAX_LEN];
+
+        FormatNanometresAsMillimetres( i, formatted );
+
+        if( s != formatted )
+        {
+            printf( "i:%d  biuFmt:%s  integer formatter:%s\n", i, s.c_str(), formatted );
+            ++formatMismatches;
+        }
+
         if( !( i & 0xFFFFFF ) )
         {
             printf( " %08x", i );
@@ -114,6 +175,9 @@ int main( int argc, char** argv )
     }
 
     printf( "mismatches:%u\n", mismatches );
+    printf( "fixed point parser mismatches:%u\n", fixedMismatches );
+    printf( "double parser mismatches:%u\n", doubleMismatches );
+    printf( "integer formatter mismatches:%u\n", formatMismatches );
 
     return 0;
 }